@@ -0,0 +1,26 @@
+def zen_cc_benchmark(name, copts=[], linkopts=[], deps=[], **kwargs):
+    '''
+    A wrapper around cc_binary for benchmarks
+    Builds with optimizations and without sanitizers, and links the benchmark harness, which provides main.
+    '''
+    _BENCHMARK_COPTS = [
+        "-O3",
+        "-DNDEBUG",
+        "-fno-omit-frame-pointer",
+    ]
+
+    _BENCHMARK_LINKOPTS = [
+        "-pthread",
+    ]
+
+    _BENCHMARK_DEPS = [
+        "//benchmark:harness",
+    ]
+
+    native.cc_binary(
+        name=name,
+        copts=_BENCHMARK_COPTS + copts,
+        deps=_BENCHMARK_DEPS + deps,
+        linkopts=_BENCHMARK_LINKOPTS + linkopts,
+        **kwargs
+    )
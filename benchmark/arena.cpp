@@ -0,0 +1,119 @@
+// C++ Standard Library
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <numeric>
+#include <vector>
+
+// Zen
+#include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+/// Number of calls to global operator new
+std::atomic<std::int64_t> heap_allocations{0};
+
+}  // namespace
+
+void* operator new(std::size_t size)
+{
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* const ptr = std::malloc(size == 0 ? 1 : size); ptr != nullptr)
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto a = static_cast<std::size_t>(alignment);
+  if (void* const ptr = std::aligned_alloc(a, (size + a - 1) / a * a); ptr != nullptr)
+  {
+    return ptr;
+  }
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::align_val_t) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept { std::free(ptr); }
+
+namespace
+{
+
+template <typename ExecutorT> std::unique_ptr<ExecutorT> make_executor();
+
+template <> std::unique_ptr<exec::thread_pool<>> make_executor() { return std::make_unique<exec::thread_pool<>>(); }
+
+template <> std::unique_ptr<exec::inline_executor> make_executor() { return std::make_unique<exec::inline_executor>(); }
+
+/**
+ * @brief Stage which fills a scratch vector of <code>n</code> elements, allocated from the dispatch's resource
+ */
+template <typename HandleT> result<std::int64_t> scratch(HandleT& handle, std::int64_t n)
+{
+  std::pmr::vector<std::int64_t> v(static_cast<std::size_t>(n), 1, handle.resource());
+  benchmark::do_not_optimize(v.data());
+  return std::accumulate(v.begin(), v.end(), std::int64_t{0});
+}
+
+/**
+ * @brief Runs a four-way all() fan-out of scratch stages with <code>arg(0)</code> elements
+ *
+ * @tparam kArena  if <code>true</code>, each invocation runs with an arena which is reset afterwards
+ */
+template <typename ExecutorT, bool kArena> void parallel_all(benchmark::state& state)
+{
+  using handle_type = exec::handle_type_t<ExecutorT>;
+
+  const auto e = make_executor<ExecutorT>();
+  const auto stage = [](handle_type& handle, std::int64_t n) { return scratch(handle, n); };
+  std::int64_t n = state.arg();
+
+  arena a{64 * 1024};
+  const std::int64_t heap_allocations_before = heap_allocations.load(std::memory_order_relaxed);
+  std::int64_t arena_allocations = 0;
+  while (state.keep_running())
+  {
+    {
+      const arena_scope scope{kArena ? &a : nullptr};
+
+      // clang-format off
+      auto r = pass(n)
+             | all(*e, stage, stage, stage, stage);
+      // clang-format on
+      benchmark::do_not_optimize(r);
+    }
+    arena_allocations += a.allocations();
+    a.reset();
+  }
+  const std::int64_t heap_allocations_after = heap_allocations.load(std::memory_order_relaxed);
+
+  const auto iterations = static_cast<double>(state.iterations());
+  state.set_items_processed(state.iterations());
+  state.counter("heap_allocations", static_cast<double>(heap_allocations_after - heap_allocations_before) / iterations);
+  state.counter("arena_allocations", static_cast<double>(arena_allocations) / iterations);
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(parallel_all<exec::thread_pool<>, false>).range(1, 4096);
+ZEN_BENCHMARK(parallel_all<exec::thread_pool<>, true>).range(1, 4096);
+ZEN_BENCHMARK(parallel_all<exec::inline_executor, false>).range(1, 4096);
+ZEN_BENCHMARK(parallel_all<exec::inline_executor, true>).range(1, 4096);
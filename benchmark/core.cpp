@@ -0,0 +1,229 @@
+// C++ Standard Library
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/result.hpp>
+#include <zen/stage/timed.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+/**
+ * @brief Cheapest possible stage
+ */
+constexpr auto add_one = [](std::int64_t x) -> result<std::int64_t> { return x + 1; };
+
+/**
+ * @brief Stage which always fails
+ */
+constexpr auto fail = [](std::int64_t) -> result<std::int64_t> { return "failed"_msg; };
+
+/**
+ * @brief Small CPU-bound stage, with cost proportional to <code>n</code>
+ */
+constexpr auto work = [](std::int64_t n) -> result<std::int64_t> {
+  std::int64_t sum = 0;
+  for (std::int64_t i = 0; i < n; ++i)
+  {
+    benchmark::do_not_optimize(sum += i);
+  }
+  return sum;
+};
+
+/**
+ * @brief Stage which returns a vector of <code>n</code> elements
+ */
+constexpr auto make_payload = [](std::int64_t n) -> result<std::vector<std::int64_t>> {
+  return std::vector<std::int64_t>(static_cast<std::size_t>(n), n);
+};
+
+template <std::size_t... Is> result<std::int64_t> chain(std::int64_t x, std::index_sequence<Is...>)
+{
+  return (pass(x) | ... | (static_cast<void>(Is), add_one));
+}
+
+template <typename StageT, std::size_t... Is>
+result<std::int64_t> timed_chain_impl(std::int64_t x, const StageT& stage, std::index_sequence<Is...>)
+{
+  return (pass(x) | ... | (static_cast<void>(Is), stage));
+}
+
+template <std::size_t... Is> std::int64_t direct(std::int64_t x, std::index_sequence<Is...>)
+{
+  const auto step = [&x] {
+    const auto r = add_one(x);
+    x = *r;
+  };
+  ((static_cast<void>(Is), step()), ...);
+  return x;
+}
+
+/**
+ * @brief Runs an <code>operator|</code> chain of <code>N</code> trivial stages
+ */
+template <std::size_t N> void pipe_chain(benchmark::state& state)
+{
+  std::int64_t x = 0;
+  while (state.keep_running())
+  {
+    benchmark::do_not_optimize(x);
+    auto r = chain(x, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+/**
+ * @brief Calls the stages of pipe_chain directly, without <code>operator|</code>; the baseline of pipe_chain
+ */
+template <std::size_t N> void direct_chain(benchmark::state& state)
+{
+  std::int64_t x = 0;
+  while (state.keep_running())
+  {
+    benchmark::do_not_optimize(x);
+    auto r = direct(x, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+/**
+ * @brief Runs pipe_chain with every stage wrapped by timed(); shows the cost of recording stage latency
+ */
+template <std::size_t N> void timed_chain(benchmark::state& state)
+{
+  const auto stage = timed("add_one"_msg, add_one);
+  std::int64_t x = 0;
+  while (state.keep_running())
+  {
+    benchmark::do_not_optimize(x);
+    auto r = timed_chain_impl(x, stage, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+  state.counter("p50_ns", static_cast<double>(stage.latency().valid.percentile(0.50).count()));
+  state.counter("p999_ns", static_cast<double>(stage.latency().valid.percentile(0.999).count()));
+}
+
+/**
+ * @brief Runs a chain of <code>N</code> trivial stages which fails at its first stage
+ */
+template <std::size_t N> void pipe_chain_failure(benchmark::state& state)
+{
+  std::int64_t x = 0;
+  while (state.keep_running())
+  {
+    benchmark::do_not_optimize(x);
+    auto r = chain(x, std::make_index_sequence<N>{}) | fail;
+    benchmark::do_not_optimize(r);
+  }
+}
+
+template <std::size_t... Is> auto sequential_all_impl(std::int64_t n, std::index_sequence<Is...>)
+{
+  return pass(n) | all((static_cast<void>(Is), work)...);
+}
+
+template <std::size_t... Is> auto sequential_any_impl(std::int64_t n, std::index_sequence<Is...>)
+{
+  return pass(n) | any((static_cast<void>(Is), fail)..., work);
+}
+
+/**
+ * @brief Runs a sequential <code>N</code>-way all(), where each invocable does <code>arg(0)</code> units of work
+ */
+template <std::size_t N> void sequential_all(benchmark::state& state)
+{
+  std::int64_t n = state.arg();
+  while (state.keep_running())
+  {
+    auto r = sequential_all_impl(n, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+/**
+ * @brief Runs a sequential <code>N</code>-way any(), where all but the last invocable fail, and the last one does
+ *        <code>arg(0)</code> units of work
+ */
+template <std::size_t N> void sequential_any(benchmark::state& state)
+{
+  std::int64_t n = state.arg();
+  while (state.keep_running())
+  {
+    auto r = sequential_any_impl(n, std::make_index_sequence<N - 1>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+template <typename FnT, std::size_t... Is> auto create_impl(FnT& fn, std::int64_t& n, std::index_sequence<Is...>)
+{
+  return create(make_deferred_result((static_cast<void>(Is), fn), std::forward_as_tuple(n))...);
+}
+
+/**
+ * @brief Aggregates <code>N</code> deferred results with create(), each of which holds an integer
+ */
+template <std::size_t N> void create_scalar(benchmark::state& state)
+{
+  std::int64_t n = state.arg();
+  while (state.keep_running())
+  {
+    auto r = create_impl(add_one, n, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+/**
+ * @brief Aggregates <code>N</code> deferred results with create(), each of which holds a vector of
+ *        <code>arg(0)</code> integers; shows the cost of copying payloads while aggregating
+ */
+template <std::size_t N> void create_payload(benchmark::state& state)
+{
+  std::int64_t n = state.arg();
+  while (state.keep_running())
+  {
+    auto r = create_impl(make_payload, n, std::make_index_sequence<N>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(pipe_chain<1>);
+ZEN_BENCHMARK(pipe_chain<4>);
+ZEN_BENCHMARK(pipe_chain<16>);
+ZEN_BENCHMARK(pipe_chain<64>);
+ZEN_BENCHMARK(direct_chain<1>);
+ZEN_BENCHMARK(direct_chain<4>);
+ZEN_BENCHMARK(direct_chain<16>);
+ZEN_BENCHMARK(direct_chain<64>);
+ZEN_BENCHMARK(timed_chain<1>);
+ZEN_BENCHMARK(timed_chain<16>);
+ZEN_BENCHMARK(pipe_chain_failure<4>);
+ZEN_BENCHMARK(pipe_chain_failure<16>);
+ZEN_BENCHMARK(sequential_all<2>).range(1, 1024);
+ZEN_BENCHMARK(sequential_all<4>).range(1, 1024);
+ZEN_BENCHMARK(sequential_all<8>).range(1, 1024);
+ZEN_BENCHMARK(sequential_any<2>).range(1, 1024);
+ZEN_BENCHMARK(sequential_any<4>).range(1, 1024);
+ZEN_BENCHMARK(sequential_any<8>).range(1, 1024);
+ZEN_BENCHMARK(create_scalar<2>).arg(1);
+ZEN_BENCHMARK(create_scalar<4>).arg(1);
+ZEN_BENCHMARK(create_scalar<8>).arg(1);
+ZEN_BENCHMARK(create_payload<2>).range(1, 4096);
+ZEN_BENCHMARK(create_payload<4>).range(1, 4096);
+ZEN_BENCHMARK(create_payload<8>).range(1, 4096);
@@ -0,0 +1,262 @@
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Zen
+#include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+template <typename ExecutorT> std::unique_ptr<ExecutorT> make_executor();
+
+template <> std::unique_ptr<exec::thread_pool<>> make_executor() { return std::make_unique<exec::thread_pool<>>(); }
+
+template <> std::unique_ptr<exec::inline_executor> make_executor() { return std::make_unique<exec::inline_executor>(); }
+
+template <> std::unique_ptr<exec::adaptive_executor<exec::thread_pool<>>> make_executor()
+{
+  static exec::thread_pool<> inner{};
+  return std::make_unique<exec::adaptive_executor<exec::thread_pool<>>>(inner);
+}
+
+template <typename ExecutorT> void report_decisions(benchmark::state& state, const ExecutorT& e) {}
+
+template <typename ExecutorT>
+void report_decisions(benchmark::state& state, const exec::adaptive_executor<ExecutorT>& e)
+{
+  const auto report = e.report();
+  state.counter("inline", static_cast<double>(report.inline_count));
+  state.counter("partial", static_cast<double>(report.partial_count));
+  state.counter("parallel", static_cast<double>(report.parallel_count));
+}
+
+void wait_for(const std::atomic<std::int64_t>& count, std::int64_t expected)
+{
+  while (count.load(std::memory_order_acquire) < expected)
+  {
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * @brief Small CPU-bound stage, with cost proportional to <code>n</code>
+ */
+result<std::int64_t> work(std::int64_t n)
+{
+  std::int64_t sum = 0;
+  for (std::int64_t i = 0; i < n; ++i)
+  {
+    benchmark::do_not_optimize(sum += i);
+  }
+  return sum;
+}
+
+/**
+ * @brief Submits <code>arg(0)</code> tasks, one at a time, and waits for them to complete
+ */
+template <typename ExecutorT> void execute_throughput(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+  const std::int64_t n = state.arg();
+
+  std::atomic<std::int64_t> count{0};
+  std::int64_t expected = 0;
+  while (state.keep_running())
+  {
+    for (std::int64_t i = 0; i < n; ++i)
+    {
+      e->execute([&count] { count.fetch_add(1, std::memory_order_release); });
+    }
+    wait_for(count, expected += n);
+  }
+  state.set_items_processed(state.iterations() * n);
+}
+
+/**
+ * @brief Submits <code>arg(0)</code> tasks at once, with bulk_execute, and waits for them to complete
+ */
+template <typename ExecutorT> void bulk_execute_throughput(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+  const std::int64_t n = state.arg();
+
+  std::atomic<std::int64_t> count{0};
+  std::int64_t expected = 0;
+  auto task = [&count](std::size_t) { count.fetch_add(1, std::memory_order_release); };
+  while (state.keep_running())
+  {
+    e->bulk_execute(static_cast<std::size_t>(n), task);
+    wait_for(count, expected += n);
+  }
+  state.set_items_processed(state.iterations() * n);
+}
+
+/**
+ * @brief Submits <code>N</code> tasks at once, from a batch of task nodes, and waits for them to complete
+ */
+template <typename ExecutorT, std::size_t N> void batch_execute_throughput(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+
+  std::atomic<std::int64_t> count{0};
+  std::int64_t expected = 0;
+  auto task = [&count](std::size_t) { count.fetch_add(1, std::memory_order_release); };
+  while (state.keep_running())
+  {
+    exec::task_batch<N, decltype(task)> batch{task};
+    e->bulk_execute(batch);
+    wait_for(count, expected += N);
+  }
+  state.set_items_processed(state.iterations() * N);
+}
+
+/**
+ * @brief Runs a four-way all() fan-out, where each invocable does <code>arg(0)</code> units of work
+ */
+template <typename ExecutorT> void parallel_all(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+  std::int64_t n = state.arg();
+
+  while (state.keep_running())
+  {
+    // clang-format off
+    auto r = pass(n)
+           | all(*e, work, work, work, work);
+    // clang-format on
+    benchmark::do_not_optimize(r);
+  }
+  report_decisions(state, *e);
+}
+
+/**
+ * @brief Runs a four-way any() fan-out, where each invocable does <code>arg(0)</code> units of work
+ */
+template <typename ExecutorT> void parallel_any(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+  std::int64_t n = state.arg();
+
+  while (state.keep_running())
+  {
+    // clang-format off
+    auto r = pass(n)
+           | any(*e, work, work, work, work);
+    // clang-format on
+    benchmark::do_not_optimize(r);
+  }
+  report_decisions(state, *e);
+}
+
+/**
+ * @brief Submits a single task, and waits for it to complete; also reports percentiles of the round-trip time
+ */
+template <typename ExecutorT> void execute_latency(benchmark::state& state)
+{
+  const auto e = make_executor<ExecutorT>();
+
+  histogram round_trip;
+  std::atomic<std::int64_t> count{0};
+  std::int64_t expected = 0;
+  while (state.keep_running())
+  {
+    const auto start = std::chrono::steady_clock::now();
+    e->execute([&count] { count.fetch_add(1, std::memory_order_release); });
+    wait_for(count, ++expected);
+    round_trip.record(std::chrono::steady_clock::now() - start);
+  }
+  state.counter("p50_ns", static_cast<double>(round_trip.percentile(0.50).count()));
+  state.counter("p99_ns", static_cast<double>(round_trip.percentile(0.99).count()));
+  state.counter("max_ns", static_cast<double>(round_trip.max().count()));
+}
+
+template <bool kAll, std::size_t... Is>
+auto fan_out(exec::thread_pool<>& tp, std::int64_t& n, std::index_sequence<Is...>)
+{
+  if constexpr (kAll)
+  {
+    return pass(n) | all(tp, (static_cast<void>(Is), work)...);
+  }
+  else
+  {
+    return pass(n) | any(tp, (static_cast<void>(Is), work)...);
+  }
+}
+
+/// Number of invocables dispatched by fan_out_scaling
+static constexpr std::size_t kFanOut = 16;
+
+/// Number of cores, which fan_out_scaling sweeps worker count up to
+static const std::int64_t kCores = std::max<std::int64_t>(1, std::thread::hardware_concurrency());
+
+/**
+ * @brief Runs a 16-way all() or any() fan-out on a pool of <code>arg(0)</code> workers, where each invocable does
+ *        <code>arg(1)</code> units of work
+ *
+ * Also reports speedup over running the same invocables one after another on the calling thread, and efficiency,
+ * which is speedup per worker.
+ */
+template <bool kAll> void fan_out_scaling(benchmark::state& state)
+{
+  exec::thread_pool<> tp{static_cast<std::size_t>(state.arg(0))};
+  std::int64_t n = state.arg(1);
+
+  // Time sequential baseline before timed iterations
+  static constexpr int kBaselineRuns = 16;
+  const auto baseline_start = std::chrono::steady_clock::now();
+  for (int i = 0; i < kBaselineRuns; ++i)
+  {
+    for (std::size_t j = 0; j < kFanOut; ++j)
+    {
+      benchmark::do_not_optimize(work(n));
+    }
+  }
+  const std::chrono::duration<double, std::nano> baseline = (std::chrono::steady_clock::now() - baseline_start);
+
+  while (state.keep_running())
+  {
+    auto r = fan_out<kAll>(tp, n, std::make_index_sequence<kFanOut>{});
+    benchmark::do_not_optimize(r);
+  }
+  state.set_items_processed(state.iterations() * kFanOut);
+
+  const double sequential_ns = baseline.count() / kBaselineRuns;
+  const double parallel_ns = static_cast<double>(state.elapsed().count()) / static_cast<double>(state.iterations());
+  state.counter("speedup", sequential_ns / parallel_ns);
+  state.counter("efficiency", sequential_ns / parallel_ns / static_cast<double>(state.arg(0)));
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(execute_throughput<exec::thread_pool<>>).range(1, 1024);
+ZEN_BENCHMARK(execute_throughput<exec::inline_executor>).range(1, 1024);
+ZEN_BENCHMARK(bulk_execute_throughput<exec::thread_pool<>>).range(1, 1024);
+ZEN_BENCHMARK(bulk_execute_throughput<exec::inline_executor>).range(1, 1024);
+ZEN_BENCHMARK(batch_execute_throughput<exec::thread_pool<>, 4>);
+ZEN_BENCHMARK(batch_execute_throughput<exec::thread_pool<>, 16>);
+ZEN_BENCHMARK(batch_execute_throughput<exec::thread_pool<>, 64>);
+ZEN_BENCHMARK(batch_execute_throughput<exec::inline_executor, 4>);
+ZEN_BENCHMARK(batch_execute_throughput<exec::inline_executor, 16>);
+ZEN_BENCHMARK(batch_execute_throughput<exec::inline_executor, 64>);
+ZEN_BENCHMARK(parallel_all<exec::thread_pool<>>).range(1, 1 << 16);
+ZEN_BENCHMARK(parallel_all<exec::inline_executor>).range(1, 1 << 16);
+ZEN_BENCHMARK(parallel_all<exec::adaptive_executor<exec::thread_pool<>>>).range(1, 1 << 16);
+ZEN_BENCHMARK(parallel_any<exec::thread_pool<>>).range(1, 1 << 16);
+ZEN_BENCHMARK(parallel_any<exec::inline_executor>).range(1, 1 << 16);
+ZEN_BENCHMARK(parallel_any<exec::adaptive_executor<exec::thread_pool<>>>).range(1, 1 << 16);
+ZEN_BENCHMARK(execute_latency<exec::thread_pool<>>);
+ZEN_BENCHMARK(execute_latency<exec::inline_executor>);
+ZEN_BENCHMARK(fan_out_scaling<true>).ranges({{1, kCores}, {64, 16384}});
+ZEN_BENCHMARK(fan_out_scaling<false>).ranges({{1, kCores}, {64, 16384}});
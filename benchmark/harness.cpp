@@ -0,0 +1,278 @@
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Zen
+#include "benchmark/harness.hpp"
+
+namespace zen::benchmark
+{
+
+std::vector<definition>& registry()
+{
+  static std::vector<definition> definitions;
+  return definitions;
+}
+
+namespace
+{
+
+/**
+ * @brief Command line options
+ */
+struct options
+{
+  /// Only benchmarks whose name contains this string are run
+  std::string filter;
+
+  /// Minimum time, in seconds, spent in the timed iterations of each run
+  double min_time = 0.5;
+
+  /// File which receives the report; standard output if empty
+  std::string out;
+
+  /// Report format, either "json" or "csv"
+  std::string format = "json";
+};
+
+/**
+ * @brief Measurements of a single run
+ */
+struct report
+{
+  std::string name;
+  std::int64_t iterations;
+  double ns_per_iteration;
+  double items_per_second;
+  std::vector<std::pair<std::string, double>> counters;
+};
+
+options parse(int argc, char** argv)
+{
+  options opts;
+  for (int i = 1; i < argc; ++i)
+  {
+    const std::string arg{argv[i]};
+    const auto value = [&arg](const std::string& flag) { return arg.substr(flag.size()); };
+    if (arg.rfind("--filter=", 0) == 0)
+    {
+      opts.filter = value("--filter=");
+    }
+    else if (arg.rfind("--min_time=", 0) == 0)
+    {
+      opts.min_time = std::atof(value("--min_time=").c_str());
+    }
+    else if (arg.rfind("--out=", 0) == 0)
+    {
+      opts.out = value("--out=");
+    }
+    else if (arg == "--format=json" || arg == "--format=csv")
+    {
+      opts.format = value("--format=");
+    }
+    else
+    {
+      std::cerr << "usage: " << argv[0]
+                << " [--filter=<substring>] [--min_time=<seconds>] [--out=<file>] [--format=json|csv]\n";
+      std::exit(EXIT_FAILURE);
+    }
+  }
+  return opts;
+}
+
+/**
+ * @brief Runs benchmark with increasing iteration counts until a run takes at least <code>min_time</code>
+ */
+report run(const definition& def, const std::vector<std::int64_t>& args, double min_time)
+{
+  report r;
+  r.name = def.name;
+  for (const auto a : args)
+  {
+    r.name += '/' + std::to_string(a);
+  }
+
+  static constexpr std::int64_t kMaxIterations = 1'000'000'000;
+
+  std::int64_t iterations = 1;
+  while (true)
+  {
+    state s{iterations, args};
+    def.fn(s);
+
+    const double seconds = std::chrono::duration<double>(s.elapsed()).count();
+    if (seconds >= min_time || iterations >= kMaxIterations)
+    {
+      r.iterations = iterations;
+      r.ns_per_iteration = seconds * 1e9 / static_cast<double>(iterations);
+      r.items_per_second = (seconds > 0.0) ? static_cast<double>(s.items_processed()) / seconds : 0.0;
+      r.counters = s.counters();
+      return r;
+    }
+
+    // Grow towards the iteration count which should reach the minimum time, with some margin
+    const double scale = (seconds > 0.0) ? (1.4 * min_time / seconds) : 10.0;
+    iterations = std::min(kMaxIterations, iterations * static_cast<std::int64_t>(std::clamp(scale, 2.0, 10.0)));
+  }
+}
+
+std::string escape(const std::string& s)
+{
+  std::string escaped;
+  for (const char c : s)
+  {
+    if (c == '"' || c == '\\')
+    {
+      escaped += '\\';
+    }
+    escaped += c;
+  }
+  return escaped;
+}
+
+void write_json(std::ostream& os, const std::vector<report>& reports)
+{
+  char date[64];
+  const std::time_t now = std::time(nullptr);
+  std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+  os << "{\n";
+  os << "  \"context\": {\n";
+  os << "    \"date\": \"" << date << "\",\n";
+  os << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+  os << "    \"library_build_type\": \"release\"\n";
+#else
+  os << "    \"library_build_type\": \"debug\"\n";
+#endif  // NDEBUG
+  os << "  },\n";
+  os << "  \"benchmarks\": [";
+  for (std::size_t i = 0; i < reports.size(); ++i)
+  {
+    const auto& r = reports[i];
+    os << (i == 0 ? "\n" : ",\n");
+    os << "    {\n";
+    os << "      \"name\": \"" << escape(r.name) << "\",\n";
+    os << "      \"iterations\": " << r.iterations << ",\n";
+    os << "      \"real_time\": " << r.ns_per_iteration << ",\n";
+    os << "      \"time_unit\": \"ns\"";
+    if (r.items_per_second > 0.0)
+    {
+      os << ",\n      \"items_per_second\": " << r.items_per_second;
+    }
+    for (const auto& [name, value] : r.counters)
+    {
+      os << ",\n      \"" << escape(name) << "\": " << value;
+    }
+    os << "\n    }";
+  }
+  os << "\n  ]\n";
+  os << "}\n";
+}
+
+/**
+ * @brief Writes one row per run; counters get a column each, in order of first appearance, and are left empty in
+ *        rows of runs which do not report them
+ */
+void write_csv(std::ostream& os, const std::vector<report>& reports)
+{
+  std::vector<std::string> columns;
+  for (const auto& r : reports)
+  {
+    for (const auto& [name, value] : r.counters)
+    {
+      if (std::find(columns.begin(), columns.end(), name) == columns.end())
+      {
+        columns.push_back(name);
+      }
+    }
+  }
+
+  os << "name,iterations,real_time_ns,items_per_second";
+  for (const auto& column : columns)
+  {
+    os << ',' << column;
+  }
+  os << '\n';
+
+  for (const auto& r : reports)
+  {
+    os << '"' << r.name << "\"," << r.iterations << ',' << r.ns_per_iteration << ',' << r.items_per_second;
+    for (const auto& column : columns)
+    {
+      os << ',';
+      const auto itr = std::find_if(r.counters.begin(), r.counters.end(), [&column](const auto& counter) {
+        return counter.first == column;
+      });
+      if (itr != r.counters.end())
+      {
+        os << itr->second;
+      }
+    }
+    os << '\n';
+  }
+}
+
+void write(std::ostream& os, const options& opts, const std::vector<report>& reports)
+{
+  if (opts.format == "csv")
+  {
+    write_csv(os, reports);
+  }
+  else
+  {
+    write_json(os, reports);
+  }
+}
+
+}  // namespace
+}  // namespace zen::benchmark
+
+int main(int argc, char** argv)
+{
+  using namespace zen::benchmark;
+
+  const auto opts = parse(argc, argv);
+
+  std::vector<report> reports;
+  for (const auto& def : registry())
+  {
+    if (def.name.find(opts.filter) == std::string::npos)
+    {
+      continue;
+    }
+
+    const auto arg_sets = def.arg_sets.empty() ? std::vector<std::vector<std::int64_t>>{{}} : def.arg_sets;
+    for (const auto& args : arg_sets)
+    {
+      reports.push_back(run(def, args, opts.min_time));
+
+      const auto& r = reports.back();
+      std::fprintf(
+        stderr,
+        "%-64s %14.1f ns %12lld iterations\n",
+        r.name.c_str(),
+        r.ns_per_iteration,
+        static_cast<long long>(r.iterations));
+    }
+  }
+
+  if (opts.out.empty())
+  {
+    write(std::cout, opts, reports);
+  }
+  else
+  {
+    std::ofstream ofs{opts.out};
+    write(ofs, opts, reports);
+  }
+  return EXIT_SUCCESS;
+}
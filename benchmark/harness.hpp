@@ -0,0 +1,244 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace zen::benchmark
+{
+
+/**
+ * @brief Prevents the compiler from optimizing away the computation of <code>value</code>
+ */
+template <typename T> inline void do_not_optimize(T&& value) { asm volatile("" : : "r"(&value) : "memory"); }
+
+/**
+ * @brief Timing state of a single benchmark run
+ *
+@verbatim
+  void pass_chain(benchmark::state& state)
+  {
+    while (state.keep_running())
+    {
+      benchmark::do_not_optimize(pass(1) | add_one);
+    }
+  }
+  ZEN_BENCHMARK(pass_chain);
+@endverbatim
+ */
+class state
+{
+public:
+  using clock_type = std::chrono::steady_clock;
+
+  state(std::int64_t iterations, std::vector<std::int64_t> args) :
+      iterations_{iterations}, remaining_{iterations}, args_{std::move(args)}
+  {}
+
+  /**
+   * @brief Returns <code>true</code> while iterations remain; times all iterations
+   */
+  bool keep_running()
+  {
+    if (remaining_ == iterations_)
+    {
+      start_ = clock_type::now();
+    }
+    if (remaining_-- > 0)
+    {
+      return true;
+    }
+    stop_ = clock_type::now();
+    return false;
+  }
+
+  /**
+   * @brief Stops the timer, for setup or teardown which should not be measured
+   */
+  void pause_timing() { paused_at_ = clock_type::now(); }
+
+  /**
+   * @brief Restarts the timer after pause_timing()
+   */
+  void resume_timing() { paused_ += clock_type::now() - paused_at_; }
+
+  /**
+   * @brief Returns <code>i</code>-th argument of this run
+   */
+  [[nodiscard]] std::int64_t arg(std::size_t i = 0) const { return args_.at(i); }
+
+  /**
+   * @brief Returns all arguments of this run
+   */
+  [[nodiscard]] const std::vector<std::int64_t>& args() const { return args_; }
+
+  /**
+   * @brief Returns the number of iterations in this run
+   */
+  [[nodiscard]] std::int64_t iterations() const { return iterations_; }
+
+  /**
+   * @brief Sets the number of items processed by all iterations, reported as a rate
+   */
+  void set_items_processed(std::int64_t items) { items_ = items; }
+
+  /**
+   * @brief Adds a named value to the report of this run
+   */
+  void counter(std::string name, double value) { counters_.emplace_back(std::move(name), value); }
+
+  /**
+   * @brief Returns time spent in timed iterations
+   */
+  [[nodiscard]] std::chrono::nanoseconds elapsed() const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(stop_ - start_ - paused_);
+  }
+
+  [[nodiscard]] std::int64_t items_processed() const { return items_; }
+
+  [[nodiscard]] const std::vector<std::pair<std::string, double>>& counters() const { return counters_; }
+
+private:
+  std::int64_t iterations_;
+  std::int64_t remaining_;
+  std::vector<std::int64_t> args_;
+  std::int64_t items_ = 0;
+  std::vector<std::pair<std::string, double>> counters_;
+  clock_type::time_point start_, stop_, paused_at_;
+  clock_type::duration paused_ = clock_type::duration::zero();
+};
+
+/// Benchmark function signature
+using benchmark_fn = void (*)(state&);
+
+/**
+ * @brief Registered benchmark
+ */
+struct definition
+{
+  /// Benchmark name
+  std::string name;
+
+  /// Function which runs the benchmark
+  benchmark_fn fn;
+
+  /// Argument sets, each of which is run separately
+  std::vector<std::vector<std::int64_t>> arg_sets;
+};
+
+/**
+ * @brief Returns all registered benchmarks
+ */
+std::vector<definition>& registry();
+
+/**
+ * @brief Registers a benchmark on construction; used through ZEN_BENCHMARK
+ */
+class registrar
+{
+public:
+  registrar(const char* name, benchmark_fn fn) : index_{registry().size()}
+  {
+    registry().push_back(definition{name, fn, {}});
+  }
+
+  /**
+   * @brief Adds a run with a single argument
+   */
+  registrar& arg(std::int64_t value) { return args({value}); }
+
+  /**
+   * @brief Adds a run with several arguments
+   */
+  registrar& args(std::initializer_list<std::int64_t> values)
+  {
+    registry()[index_].arg_sets.emplace_back(values);
+    return *this;
+  }
+
+  /**
+   * @brief Adds runs with a single argument, for each power of two in <code>[lo, hi]</code>, and <code>hi</code>
+   */
+  registrar& range(std::int64_t lo, std::int64_t hi)
+  {
+    for (std::int64_t value = lo; value < hi; value *= 2)
+    {
+      arg(value);
+    }
+    return arg(hi);
+  }
+
+  /**
+   * @brief Adds runs with several arguments, for each combination of the values which range() would produce from
+   *        each <code>[lo, hi]</code> pair
+   */
+  registrar& ranges(std::initializer_list<std::pair<std::int64_t, std::int64_t>> bounds)
+  {
+    std::vector<std::vector<std::int64_t>> values;
+    for (const auto& [lo, hi] : bounds)
+    {
+      values.emplace_back();
+      for (std::int64_t value = lo;; value = std::min(value * 2, hi))
+      {
+        values.back().push_back(value);
+        if (value >= hi)
+        {
+          break;
+        }
+      }
+    }
+    return product(values);
+  }
+
+  /**
+   * @brief Adds runs with several arguments, for each combination of one value from each list of
+   *        <code>values</code>
+   */
+  registrar& product(const std::vector<std::vector<std::int64_t>>& values)
+  {
+    std::vector<std::vector<std::int64_t>> combinations{{}};
+    for (const auto& choices : values)
+    {
+      std::vector<std::vector<std::int64_t>> extended;
+      for (const auto& combination : combinations)
+      {
+        for (const auto value : choices)
+        {
+          extended.push_back(combination);
+          extended.back().push_back(value);
+        }
+      }
+      combinations = std::move(extended);
+    }
+    for (auto& combination : combinations)
+    {
+      registry()[index_].arg_sets.push_back(std::move(combination));
+    }
+    return *this;
+  }
+
+private:
+  std::size_t index_;
+};
+
+}  // namespace zen::benchmark
+
+#define ZEN_BENCHMARK_CONCAT_IMPL(a, b) a##b
+#define ZEN_BENCHMARK_CONCAT(a, b) ZEN_BENCHMARK_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Registers benchmark function; argument runs may be added by chaining registrar calls
+ *
+@verbatim
+  ZEN_BENCHMARK(parallel_all<exec::thread_pool<>>).range(1, 64);
+@endverbatim
+ */
+#define ZEN_BENCHMARK(...)                                                                                             \
+  [[maybe_unused]] static ::zen::benchmark::registrar ZEN_BENCHMARK_CONCAT(zen_benchmark_, __LINE__) =                 \
+    ::zen::benchmark::registrar { #__VA_ARGS__, __VA_ARGS__ }
@@ -0,0 +1,177 @@
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Zen
+#include <zen/executor.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+/// Total number of tasks submitted in each iteration, split evenly between producers
+static constexpr std::int64_t kTasks = 4096;
+
+template <exec::queue_order kOrder, bool... kMaxWait>
+using locked_thread_pool = exec::thread_pool<
+  std::function<void()>,
+  std::allocator<std::function<void()>>,
+  exec::locked_queue_policy<kOrder, kMaxWait...>>;
+
+// Ring holds a whole iteration, so that no task spills into its locked overflow list
+using mpmc_thread_pool =
+  exec::thread_pool<std::function<void()>, std::allocator<std::function<void()>>, exec::mpmc_queue_policy<kTasks>>;
+
+using fair_thread_pool =
+  exec::thread_pool<std::function<void()>, std::allocator<std::function<void()>>, exec::fair_queue_policy>;
+
+/**
+ * @brief Submits tasks to a pool from <code>arg(0)</code> producer threads at once, and waits for them to complete
+ *
+ * Also reports percentiles of the time tasks waited in queue, how often the queue was contended per task, the mean
+ * utilization of workers, and the fraction of tasks which went through the queue, rather than running inline on their
+ * producer because a bounded queue which was asked to do so was full.
+ */
+template <typename ThreadPoolT> void contention(benchmark::state& state)
+{
+  ThreadPoolT tp{};
+  const std::int64_t producers = state.arg();
+  const std::int64_t tasks_per_producer = kTasks / producers;
+
+  std::atomic<std::int64_t> count{0};
+  std::int64_t expected = 0;
+  while (state.keep_running())
+  {
+    // Start producers outside of timing, and release them all at once
+    state.pause_timing();
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(producers);
+    for (std::int64_t p = 0; p < producers; ++p)
+    {
+      threads.emplace_back([&] {
+        while (!go.load(std::memory_order_acquire))
+        {
+          std::this_thread::yield();
+        }
+        for (std::int64_t i = 0; i < tasks_per_producer; ++i)
+        {
+          tp.execute([&count] { count.fetch_add(1, std::memory_order_release); });
+        }
+      });
+    }
+    state.resume_timing();
+
+    go.store(true, std::memory_order_release);
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+
+    expected += producers * tasks_per_producer;
+    while (count.load(std::memory_order_acquire) < expected)
+    {
+      std::this_thread::yield();
+    }
+  }
+  state.set_items_processed(state.iterations() * producers * tasks_per_producer);
+
+  const auto& age = tp.queue_age();
+  state.counter("queue_age_p50_ns", static_cast<double>(age.percentile(0.50).count()));
+  state.counter("queue_age_p99_ns", static_cast<double>(age.percentile(0.99).count()));
+  state.counter("queue_age_max_ns", static_cast<double>(age.max().count()));
+
+  const exec::pool_metrics m = tp.metrics();
+  double utilization = 0.0;
+  for (const auto& w : m.workers)
+  {
+    utilization += w.utilization() / static_cast<double>(m.workers.size());
+  }
+  const auto submitted = static_cast<double>(std::max<std::uint64_t>(m.submitted, 1));
+  state.counter("contended_per_task", static_cast<double>(m.contended) / submitted);
+  state.counter("utilization", utilization);
+  state.counter("queued_fraction", static_cast<double>(m.submitted) / static_cast<double>(expected));
+}
+
+/**
+ * @brief Measures how long a single task of one tenant waits behind a fan-out of <code>arg(0)</code> tasks of another
+ *
+ * Both are queued while the only worker is held, so that results do not depend on the number of cores. Without
+ * tenants, the single task waits behind the whole fan-out with a FIFO queue; with a fair queue, it is served on the
+ * second tenant's first turn. Also reports how many tasks of the fan-out ran before it.
+ */
+template <typename ThreadPoolT> void isolation(benchmark::state& state)
+{
+  ThreadPoolT tp{1};
+  const std::int64_t fan_out = state.arg();
+
+  std::atomic<std::int64_t> flooded{0};
+  std::int64_t expected = 0;
+  std::int64_t ahead = 0;
+  while (state.keep_running())
+  {
+    state.pause_timing();
+    std::atomic<bool> release{false};
+    tp.execute([&release] {
+      while (!release.load(std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+      }
+    });
+    {
+      const exec::tenant_scope scope{1};
+      for (std::int64_t i = 0; i < fan_out; ++i)
+      {
+        tp.execute([&flooded] {
+          const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds{5};
+          while (std::chrono::steady_clock::now() < until)
+          {}
+          flooded.fetch_add(1, std::memory_order_release);
+        });
+      }
+    }
+    std::atomic<std::int64_t> done{-1};
+    {
+      const exec::tenant_scope scope{2};
+      tp.execute([&] { done.store(flooded.load(std::memory_order_acquire), std::memory_order_release); });
+    }
+    state.resume_timing();
+
+    release.store(true, std::memory_order_release);
+    while (done.load(std::memory_order_acquire) < 0)
+    {
+      std::this_thread::yield();
+    }
+
+    state.pause_timing();
+    ahead += done.load() - expected;
+    expected += fan_out;
+    while (flooded.load(std::memory_order_acquire) < expected)
+    {
+      std::this_thread::yield();
+    }
+    state.resume_timing();
+  }
+  state.counter("tasks_ahead", static_cast<double>(ahead) / static_cast<double>(state.iterations()));
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(contention<locked_thread_pool<exec::queue_order::lifo>>).range(1, 64);
+ZEN_BENCHMARK(contention<locked_thread_pool<exec::queue_order::lifo, false>>).range(1, 64);
+ZEN_BENCHMARK(contention<locked_thread_pool<exec::queue_order::fifo>>).range(1, 64);
+ZEN_BENCHMARK(contention<locked_thread_pool<exec::queue_order::lifo_local_fifo_global>>).range(1, 64);
+ZEN_BENCHMARK(contention<mpmc_thread_pool>).range(1, 64);
+ZEN_BENCHMARK(contention<fair_thread_pool>).range(1, 64);
+ZEN_BENCHMARK(isolation<locked_thread_pool<exec::queue_order::fifo>>).range(16, 1024);
+ZEN_BENCHMARK(isolation<fair_thread_pool>).range(16, 1024);
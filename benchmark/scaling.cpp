@@ -0,0 +1,203 @@
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+/**
+ * @brief CPU-bound stage, with cost proportional to <code>n</code>
+ */
+result<std::int64_t> work(std::int64_t n)
+{
+  std::int64_t sum = 0;
+  for (std::int64_t i = 0; i < n; ++i)
+  {
+    benchmark::do_not_optimize(sum += i);
+  }
+  return sum;
+}
+
+/**
+ * @brief Returns units of work() which take about <code>ns</code> nanoseconds on this machine
+ */
+std::int64_t units_for(std::int64_t ns)
+{
+  static const double units_per_ns = [] {
+    static constexpr std::int64_t kUnits = 1 << 22;
+    const auto start = std::chrono::steady_clock::now();
+    benchmark::do_not_optimize(work(kUnits));
+    const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(kUnits) / std::max(elapsed.count(), 1.0);
+  }();
+  return std::max<std::int64_t>(1, static_cast<std::int64_t>(static_cast<double>(ns) * units_per_ns));
+}
+
+template <bool kAll, std::size_t... Is>
+auto fan_out(exec::thread_pool<>& tp, std::int64_t& n, std::index_sequence<Is...>)
+{
+  if constexpr (kAll)
+  {
+    return pass(n) | all(tp, (static_cast<void>(Is), work)...);
+  }
+  else
+  {
+    return pass(n) | any(tp, (static_cast<void>(Is), work)...);
+  }
+}
+
+/// Fan-out widths swept by scaling; branches of all() and any() are fixed at compile time
+static constexpr std::int64_t kFanOuts[] = {2, 8, 32};
+
+/**
+ * @brief Runs one all() or any() dispatch of <code>fan_out_width</code> branches
+ */
+template <bool kAll> void dispatch(exec::thread_pool<>& tp, std::int64_t& n, std::int64_t fan_out_width)
+{
+  switch (fan_out_width)
+  {
+  case kFanOuts[0]:
+    benchmark::do_not_optimize(fan_out<kAll>(tp, n, std::make_index_sequence<kFanOuts[0]>{}));
+    break;
+  case kFanOuts[1]:
+    benchmark::do_not_optimize(fan_out<kAll>(tp, n, std::make_index_sequence<kFanOuts[1]>{}));
+    break;
+  default:
+    benchmark::do_not_optimize(fan_out<kAll>(tp, n, std::make_index_sequence<kFanOuts[2]>{}));
+    break;
+  }
+}
+
+/// Number of cores
+static const std::int64_t kCores = std::max<std::int64_t>(1, std::thread::hardware_concurrency());
+
+/**
+ * @brief Returns powers of two up to twice the number of cores, to include oversubscribed pools
+ */
+std::vector<std::int64_t> worker_counts()
+{
+  std::vector<std::int64_t> counts;
+  for (std::int64_t workers = 1; workers <= 2 * kCores; workers *= 2)
+  {
+    counts.push_back(workers);
+  }
+  return counts;
+}
+
+/**
+ * @brief Runs all() or any() dispatches on a pool of <code>arg(0)</code> workers, each with <code>arg(1)</code>
+ *        branches which take about <code>arg(2)</code> nanoseconds, from <code>arg(3)</code> submitting threads
+ *
+ * The calling thread is one submitter, and times its own dispatches; other submitters dispatch in a loop until it is
+ * done. Reports, besides its arguments:
+ *
+ * - <code>items_per_second</code>: branches completed per second, by all submitters
+ * - <code>speedup</code>: time the same branches take one after another on a single thread, over time taken
+ * - <code>ideal_speedup</code>: speedup if all workers, which are not more than cores, were always busy
+ * - <code>efficiency</code>: speedup over ideal speedup
+ * - <code>overhead_ns_per_task</code>: worker time spent on each branch, less time the branch takes on its own
+ * - <code>slower_than_sequential</code>: 1 if running the branches on the calling thread would have been faster
+ */
+template <bool kAll> void scaling(benchmark::state& state)
+{
+  const std::int64_t workers = state.arg(0);
+  const std::int64_t fan_out_width = state.arg(1);
+  const std::int64_t task_ns = state.arg(2);
+  const std::int64_t submitters = state.arg(3);
+
+  exec::thread_pool<> tp{static_cast<std::size_t>(workers)};
+  std::int64_t n = units_for(task_ns);
+
+  // Time sequential baseline before timed iterations, for at least a millisecond
+  std::int64_t baseline_tasks = 0;
+  const auto baseline_start = std::chrono::steady_clock::now();
+  std::chrono::duration<double, std::nano> baseline{0};
+  while (baseline < std::chrono::milliseconds{1})
+  {
+    for (std::int64_t i = 0; i < fan_out_width; ++i)
+    {
+      benchmark::do_not_optimize(work(n));
+    }
+    baseline_tasks += fan_out_width;
+    baseline = std::chrono::steady_clock::now() - baseline_start;
+  }
+  const double sequential_ns_per_task = baseline.count() / static_cast<double>(baseline_tasks);
+
+  std::atomic<bool> stop{false};
+  std::atomic<std::int64_t> background_dispatches{0};
+  std::vector<std::thread> background;
+  for (std::int64_t i = 1; i < submitters; ++i)
+  {
+    background.emplace_back([&] {
+      std::int64_t m = n;
+      while (!stop.load(std::memory_order_relaxed))
+      {
+        dispatch<kAll>(tp, m, fan_out_width);
+        if (!stop.load(std::memory_order_relaxed))
+        {
+          background_dispatches.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    });
+  }
+
+  while (state.keep_running())
+  {
+    dispatch<kAll>(tp, n, fan_out_width);
+  }
+  stop.store(true, std::memory_order_relaxed);
+  for (auto& t : background)
+  {
+    t.join();
+  }
+
+  const auto dispatches = static_cast<double>(state.iterations() + background_dispatches.load());
+  const double tasks = dispatches * static_cast<double>(fan_out_width);
+  const double elapsed_ns = std::max(static_cast<double>(state.elapsed().count()), 1.0);
+  const double speedup = tasks * sequential_ns_per_task / elapsed_ns;
+  const double ideal_speedup = static_cast<double>(std::min({workers, kCores, fan_out_width * submitters}));
+
+  state.set_items_processed(static_cast<std::int64_t>(tasks));
+  state.counter("workers", static_cast<double>(workers));
+  state.counter("fan_out", static_cast<double>(fan_out_width));
+  state.counter("task_ns", static_cast<double>(task_ns));
+  state.counter("submitters", static_cast<double>(submitters));
+  state.counter("sequential_ns_per_task", sequential_ns_per_task);
+  state.counter("speedup", speedup);
+  state.counter("ideal_speedup", ideal_speedup);
+  state.counter("efficiency", speedup / ideal_speedup);
+  state.counter("overhead_ns_per_task", elapsed_ns * ideal_speedup / tasks - sequential_ns_per_task);
+  state.counter("slower_than_sequential", (speedup < 1.0) ? 1.0 : 0.0);
+}
+
+/**
+ * @brief Returns arguments swept by scaling: worker counts, fan-out widths, task durations in nanoseconds, from a few
+ *        instructions up to a millisecond, and submitting thread counts
+ */
+std::vector<std::vector<std::int64_t>> sweep()
+{
+  return {
+    worker_counts(),
+    {std::begin(kFanOuts), std::end(kFanOuts)},
+    {10, 100, 1'000, 10'000, 100'000, 1'000'000},
+    {1, 2, 4}};
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(scaling<true>).product(sweep());
+ZEN_BENCHMARK(scaling<false>).product(sweep());
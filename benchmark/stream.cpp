@@ -0,0 +1,138 @@
+// C++ Standard Library
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <thread>
+
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor.hpp>
+#include <zen/stream.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+/// Items pumped per iteration
+static constexpr std::int64_t kItems = 64;
+
+/**
+ * @brief Spins for about <code>us</code> microseconds, as a CPU-bound stage
+ */
+result<std::int64_t> spin(std::int64_t us)
+{
+  const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds{us};
+  std::int64_t n = 0;
+  while (std::chrono::steady_clock::now() < until)
+  {
+    benchmark::do_not_optimize(++n);
+  }
+  return n;
+}
+
+/**
+ * @brief Source of <code>kItems</code> items, each of which blocks for <code>us</code> microseconds, like a read
+ */
+auto blocking_source(std::int64_t us)
+{
+  return from_generator([i = std::int64_t{0}, us]() mutable -> std::optional<std::int64_t> {
+    if (i == kItems)
+    {
+      return std::nullopt;
+    }
+    std::this_thread::sleep_for(std::chrono::microseconds{us});
+    return ++i;
+  });
+}
+
+/**
+ * @brief Pumps items, which take <code>arg(0)</code> microseconds to read, through a stage which takes
+ *        <code>arg(1)</code> microseconds, with or without reading ahead on a thread pool
+ *
+ * With reading ahead, each item should take about as long as the slower of reading and running it, rather than both.
+ */
+template <bool kReadAhead> void pump_items(benchmark::state& state)
+{
+  const std::int64_t read_us = state.arg(0);
+  const std::int64_t stage_us = state.arg(1);
+
+  exec::thread_pool<> tp{1};
+
+  const auto pipeline = [stage_us](std::int64_t) { return pass(std::int64_t{stage_us}) | spin; };
+  const auto sink = [](std::int64_t n) { benchmark::do_not_optimize(n); };
+
+  while (state.keep_running())
+  {
+    if constexpr (kReadAhead)
+    {
+      benchmark::do_not_optimize(pump(read_ahead(tp, blocking_source(read_us), 16), pipeline, sink));
+    }
+    else
+    {
+      benchmark::do_not_optimize(pump(blocking_source(read_us), pipeline, sink));
+    }
+  }
+
+  const double items = static_cast<double>(state.iterations() * kItems);
+  state.set_items_processed(static_cast<std::int64_t>(items));
+  state.counter("read_us", static_cast<double>(read_us));
+  state.counter("stage_us", static_cast<double>(stage_us));
+  state.counter("us_per_item", static_cast<double>(state.elapsed().count()) / 1e3 / items);
+}
+
+/**
+ * @brief Writes lines of 32 bytes to <code>/dev/null</code>, through a buffer of <code>arg(0)</code> bytes, or with
+ *        one system call per line
+ */
+template <bool kBuffered> void write_lines(benchmark::state& state)
+{
+  static constexpr std::int64_t kLines = 4096;
+
+  const int fd = ::open("/dev/null", O_WRONLY);
+  const std::string line(31, 'x');
+  std::int64_t system_calls = 0;
+
+  while (state.keep_running())
+  {
+    if constexpr (kBuffered)
+    {
+      buffered_writer writer{fd, static_cast<std::size_t>(state.arg(0))};
+      for (std::int64_t i = 0; i < kLines; ++i)
+      {
+        writer.write_line(line);
+      }
+      writer.flush();
+      system_calls += static_cast<std::int64_t>(writer.system_calls());
+    }
+    else
+    {
+      const std::string terminated = line + '\n';
+      for (std::int64_t i = 0; i < kLines; ++i)
+      {
+        benchmark::do_not_optimize(::write(fd, terminated.data(), terminated.size()));
+      }
+      system_calls += kLines;
+    }
+  }
+  ::close(fd);
+
+  const auto lines = state.iterations() * kLines;
+  state.set_items_processed(lines);
+  state.counter("system_calls_per_line", static_cast<double>(system_calls) / static_cast<double>(lines));
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(pump_items<false>).product({{10, 100}, {10, 100}});
+ZEN_BENCHMARK(pump_items<true>).product({{10, 100}, {10, 100}});
+ZEN_BENCHMARK(write_lines<false>);
+ZEN_BENCHMARK(write_lines<true>).range(256, 65536);
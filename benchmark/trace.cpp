@@ -0,0 +1,55 @@
+// C++ Standard Library
+#include <cstdint>
+#include <sstream>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/utility/trace.hpp>
+
+// Benchmark
+#include "benchmark/harness.hpp"
+
+using namespace zen;
+
+namespace
+{
+
+constexpr auto add_one = [](std::int64_t x) -> result<std::int64_t> { return x + 1; };
+
+/**
+ * @brief Runs a four-stage <code>operator|</code> chain, with tracing compiled in, and enabled at runtime if
+ *        <code>arg(0)</code> is non-zero
+ *
+ * Rings are drained outside of timing, before they fill up. Compare with <code>core</code>'s pipe_chain<4>, which is
+ * built without tracing.
+ */
+void traced_chain(benchmark::state& state)
+{
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+  trace::enable(state.arg() != 0);
+
+  std::int64_t x = 0;
+  std::int64_t runs = 0;
+  while (state.keep_running())
+  {
+    benchmark::do_not_optimize(x);
+    auto r = pass(x) | add_one | add_one | add_one | add_one;
+    benchmark::do_not_optimize(r);
+
+    if (++runs % 1024 == 0)
+    {
+      state.pause_timing();
+      discard.str({});
+      trace::write_chrome_trace(discard);
+      state.resume_timing();
+    }
+  }
+  state.set_items_processed(state.iterations() * 4);
+  state.counter("dropped", static_cast<double>(trace::dropped()));
+  trace::enable();
+}
+
+}  // namespace
+
+ZEN_BENCHMARK(traced_chain).arg(0).arg(1);
@@ -0,0 +1,5 @@
+#pragma once
+
+// Zen
+#include <zen/async/future.hpp>
+#include <zen/async/when.hpp>
@@ -0,0 +1,303 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor/executor.hpp>
+
+namespace zen
+{
+
+template <typename ResultT> class future;
+
+template <typename ResultT> class promise;
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Type-erased <code>void(ResultT&&)</code> invocable, which is invoked at most once
+ *
+ * Invocables of up to kInlineSize bytes, such as the continuations attached by future::then(), are stored in place;
+ * larger ones are allocated.
+ */
+template <typename ResultT> class continuation_slot
+{
+public:
+  /// Size of invocables which are stored without allocating
+  static constexpr std::size_t kInlineSize = 6 * sizeof(void*);
+
+  continuation_slot() = default;
+
+  continuation_slot(const continuation_slot&) = delete;
+  continuation_slot& operator=(const continuation_slot&) = delete;
+
+  ~continuation_slot()
+  {
+    if (call_ != nullptr)
+    {
+      call_(storage_, nullptr);
+    }
+  }
+
+  /**
+   * @brief Stores <code>fn</code>; must be empty
+   */
+  template <typename FnT> void emplace(FnT&& fn)
+  {
+    using fn_type = std::decay_t<FnT>;
+    if constexpr (sizeof(fn_type) <= kInlineSize && alignof(fn_type) <= alignof(std::max_align_t))
+    {
+      new (storage_) fn_type{std::forward<FnT>(fn)};
+      call_ = [](unsigned char* storage, ResultT* r) {
+        fn_type& f = *std::launder(reinterpret_cast<fn_type*>(storage));
+        if (r != nullptr)
+        {
+          f(std::move(*r));
+        }
+        f.~fn_type();
+      };
+    }
+    else
+    {
+      new (storage_) fn_type*{new fn_type{std::forward<FnT>(fn)}};
+      call_ = [](unsigned char* storage, ResultT* r) {
+        const std::unique_ptr<fn_type> f{*std::launder(reinterpret_cast<fn_type**>(storage))};
+        if (r != nullptr)
+        {
+          (*f)(std::move(*r));
+        }
+      };
+    }
+  }
+
+  /**
+   * @brief Invokes, then destroys, stored invocable; must not be empty
+   */
+  void operator()(ResultT&& r) { std::exchange(call_, nullptr)(storage_, &r); }
+
+private:
+  /// Invokes stored invocable with <code>*r</code>, unless <code>r</code> is <code>nullptr</code>, then destroys it
+  void (*call_)(unsigned char*, ResultT*) = nullptr;
+
+  /// Stored invocable, or pointer to it
+  alignas(std::max_align_t) unsigned char storage_[kInlineSize];
+};
+
+/**
+ * @brief State shared between a promise and its future
+ *
+ * Holds the result, once set, and the continuation which consumes it, once attached. Each side publishes its half and
+ * then sets its bit of a single atomic state word; whichever sets its bit second runs the continuation on its own
+ * thread. Neither side locks, and get() only builds a mutex and condition variable if it has to block.
+ */
+template <typename ResultT> class future_state
+{
+public:
+  void set(ResultT&& r)
+  {
+    value_.emplace(std::move(r));
+    if (state_.fetch_or(kValue, std::memory_order_acq_rel) & kContinuation)
+    {
+      continuation_(std::move(*value_));
+    }
+  }
+
+  template <typename FnT> void on_ready(FnT&& fn)
+  {
+    continuation_.emplace(std::forward<FnT>(fn));
+    if (state_.fetch_or(kContinuation, std::memory_order_acq_rel) & kValue)
+    {
+      continuation_(std::move(*value_));
+    }
+  }
+
+  [[nodiscard]] bool ready() const { return (state_.load(std::memory_order_acquire) & kValue) != 0; }
+
+  ResultT get()
+  {
+    if (ready())
+    {
+      return std::move(*value_);
+    }
+
+    // Blocks on a continuation which hands the result over; notified under lock, so that this frame outlives it
+    struct waiter
+    {
+      std::mutex mtx;
+      std::condition_variable cv;
+      std::optional<ResultT> value;
+    } w;
+    on_ready([&w](ResultT&& r) {
+      std::lock_guard lock{w.mtx};
+      w.value.emplace(std::move(r));
+      w.cv.notify_one();
+    });
+    std::unique_lock lock{w.mtx};
+    w.cv.wait(lock, [&w] { return w.value.has_value(); });
+    return std::move(*w.value);
+  }
+
+private:
+  /// Bit of state_ which is set once value_ holds the result
+  static constexpr unsigned kValue = 1U << 0U;
+
+  /// Bit of state_ which is set once continuation_ holds the consumer of the result
+  static constexpr unsigned kContinuation = 1U << 1U;
+
+  /// Which of value_ and continuation_ have been published
+  std::atomic<unsigned> state_{0};
+
+  /// Result, once set
+  std::optional<ResultT> value_;
+
+  /// Consumer of the result, once attached
+  continuation_slot<ResultT> continuation_;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Handle to a result<T> which is produced asynchronously
+ *
+ * Unlike <code>std::future</code>, a future is consumed by attaching a continuation with then(), which runs on the
+ * thread which produces the result, so callers never need to block on it.
+ *
+ * @tparam ResultT  result<T> type produced
+ */
+template <typename ResultT> class future
+{
+public:
+  using result_type = ResultT;
+
+  /**
+   * @brief Creates a future with no shared state
+   */
+  future() = default;
+
+  /**
+   * @brief Returns <code>true</code> if this future has shared state, i.e. it has not been consumed
+   */
+  [[nodiscard]] bool valid() const { return static_cast<bool>(state_); }
+
+  /**
+   * @brief Returns <code>true</code> if the result has been produced
+   */
+  [[nodiscard]] bool ready() const { return state_->ready(); }
+
+  /**
+   * @brief Attaches <code>stage</code> to run on the result, as if by <code>operator|</code>
+   *
+   * <code>stage</code> runs on the thread which produces the result or, if the result is already available, on the
+   * calling thread. As with <code>operator|</code>, it is skipped if the result is invalid. Consumes this future.
+   *
+   * @return future to the result of <code>stage</code>
+   */
+  template <typename StageT> decltype(auto) then(StageT&& stage) &&
+  {
+    using next_result_type = decltype(std::declval<ResultT&&>() | std::declval<std::decay_t<StageT>&>());
+
+    promise<next_result_type> next;
+    auto f = next.get_future();
+    std::move(*this).on_ready([next = std::move(next), stage = std::forward<StageT>(stage)](ResultT&& r) mutable {
+      next.set(std::move(r) | stage);
+    });
+    return f;
+  }
+
+  /**
+   * @brief Attaches <code>fn</code>, which receives the result whether or not it is valid
+   *
+   * <code>fn</code> runs on the thread which produces the result or, if the result is already available, on the
+   * calling thread. Consumes this future.
+   *
+   * @param fn  invocable with signature <code>void(ResultT&&)</code>
+   */
+  template <typename FnT> void on_ready(FnT&& fn) &&
+  {
+    std::exchange(state_, nullptr)->on_ready(std::forward<FnT>(fn));
+  }
+
+  /**
+   * @brief Blocks until the result has been produced, and returns it; consumes this future
+   *
+   * @warning blocks the calling thread; prefer then() on threads which must not block
+   */
+  ResultT get() && { return std::exchange(state_, nullptr)->get(); }
+
+private:
+  friend class promise<ResultT>;
+
+  explicit future(std::shared_ptr<detail::future_state<ResultT>> state) : state_{std::move(state)} {}
+
+  std::shared_ptr<detail::future_state<ResultT>> state_;
+};
+
+/**
+ * @brief Producer side of a future
+ *
+ * Used to complete a future from callback-based code, such as an event loop.
+ *
+ * @tparam ResultT  result<T> type produced
+ */
+template <typename ResultT> class promise
+{
+public:
+  promise() : state_{std::make_shared<detail::future_state<ResultT>>()} {}
+
+  /**
+   * @brief Returns future which receives the result set on this promise
+   */
+  [[nodiscard]] future<ResultT> get_future() const { return future<ResultT>{state_}; }
+
+  /**
+   * @brief Sets result; runs attached continuation, if any, on the calling thread
+   *
+   * @note must be called exactly once
+   */
+  void set(ResultT r) const { state_->set(std::move(r)); }
+
+private:
+  std::shared_ptr<detail::future_state<ResultT>> state_;
+};
+
+/**
+ * @brief Submits <code>pipeline</code> to run on executor <code>e</code> and returns a future to its result, without
+ *        blocking
+ *
+@verbatim
+  async(tp, [] { return pass(1) | add_one | add_one; })
+    .then([](int value) -> result<int> { return value * 2; })   // runs on the worker which ran the pipeline
+    .then([&reply](int value) -> result<int> { reply(value); return value; });
+@endverbatim
+ *
+ * @param e  executor which runs <code>pipeline</code>
+ * @param pipeline  invocable, with no arguments, which returns a result<T>
+ */
+template <typename ExecutorT, typename PipelineT>
+decltype(auto) async(exec::executor<ExecutorT>& e, PipelineT&& pipeline)
+{
+  using result_type = to_result_t<std::decay_t<std::invoke_result_t<std::decay_t<PipelineT>&>>>;
+
+  promise<result_type> p;
+  auto f = p.get_future();
+  e.execute([p = std::move(p), pipeline = std::forward<PipelineT>(pipeline)]() mutable {
+    p.set(result_type{pipeline()});
+  });
+  return f;
+}
+
+}  // namespace zen
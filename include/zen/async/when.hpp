@@ -0,0 +1,142 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/async/future.hpp>
+#include <zen/result.hpp>
+
+namespace zen
+{
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Deferred result which moves out a stored result
+ */
+template <typename ResultT> struct take_result
+{
+  ResultT operator()() const { return std::move(**r); }
+
+  std::optional<ResultT>* r;
+};
+
+/**
+ * @brief Result type produced by combining <code>ResultTs...</code>, as by all()
+ */
+template <typename... ResultTs>
+using when_all_result_t = decltype(create(make_deferred_result(std::declval<take_result<ResultTs>>())...));
+
+/**
+ * @brief Collects results of futures passed to when_all
+ */
+template <typename... ResultTs> class when_all_state
+{
+public:
+  template <std::size_t I, typename ResultT> void set(ResultT&& r)
+  {
+    std::get<I>(results_).emplace(std::move(r));
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      p_.set(combine(std::index_sequence_for<ResultTs...>{}));
+    }
+  }
+
+  [[nodiscard]] auto get_future() const { return p_.get_future(); }
+
+private:
+  using result_type = when_all_result_t<ResultTs...>;
+
+  template <std::size_t... Is> result_type combine(std::index_sequence<Is...>)
+  {
+    return create(make_deferred_result(take_result<ResultTs>{&std::get<Is>(results_)})...);
+  }
+
+  std::tuple<std::optional<ResultTs>...> results_;
+  std::atomic<std::size_t> remaining_{sizeof...(ResultTs)};
+  promise<result_type> p_;
+};
+
+/**
+ * @brief Selects result of futures passed to when_any
+ */
+template <typename ResultT> class when_any_state
+{
+public:
+  explicit when_any_state(std::size_t n) : remaining_{n} {}
+
+  void set(ResultT&& r)
+  {
+    const bool last = remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1;
+    if ((r.valid() || last) && !done_.exchange(true, std::memory_order_acq_rel))
+    {
+      p_.set(std::move(r));
+    }
+  }
+
+  [[nodiscard]] auto get_future() const { return p_.get_future(); }
+
+private:
+  std::atomic<std::size_t> remaining_;
+  std::atomic<bool> done_{false};
+  promise<ResultT> p_;
+};
+
+template <typename StateT, std::size_t... Is, typename... ResultTs>
+void when_all_attach(const std::shared_ptr<StateT>& state, std::index_sequence<Is...> _, future<ResultTs>&&... fs)
+{
+  (std::move(fs).on_ready([state](ResultTs&& r) { state->template set<Is>(std::move(r)); }), ...);
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Returns a future which completes once all of <code>fs...</code> have completed, without blocking
+ *
+ * Results are combined as by all(): the combined result is valid if all results are valid, and otherwise holds the
+ * status of the first invalid result, in argument order.
+ *
+@verbatim
+  when_all(async(tp, load_a), async(tp, load_b))
+    .then([](const A& a, const B& b) -> result<C> { return merge(a, b); });
+@endverbatim
+ */
+template <typename... ResultTs> decltype(auto) when_all(future<ResultTs>&&... fs)
+{
+  static_assert(sizeof...(ResultTs) > 0, "At least one future must be specified");
+
+  const auto state = std::make_shared<detail::when_all_state<ResultTs...>>();
+  auto all = state->get_future();
+  detail::when_all_attach(state, std::index_sequence_for<ResultTs...>{}, std::move(fs)...);
+  return all;
+}
+
+/**
+ * @brief Returns a future which completes with the first valid result of <code>fs...</code>, without blocking
+ *
+ * If no result is valid, the future completes with the last result to be produced.
+ */
+template <typename ResultT, typename... OtherResultTs>
+decltype(auto) when_any(future<ResultT>&& f, future<OtherResultTs>&&... fs)
+{
+  static_assert(
+    (std::is_same_v<ResultT, OtherResultTs> && ...), "Futures passed to [when_any] must all have the same result type");
+
+  const auto state = std::make_shared<detail::when_any_state<ResultT>>(1 + sizeof...(OtherResultTs));
+  auto any = state->get_future();
+  std::move(f).on_ready([state](ResultT&& r) { state->set(std::move(r)); });
+  (std::move(fs).on_ready([state](ResultT&& r) { state->set(std::move(r)); }), ...);
+  return any;
+}
+
+}  // namespace zen
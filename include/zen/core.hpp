@@ -1,14 +1,73 @@
 #pragma once
 
 // C++ Standard Library
+#include <type_traits>
 #include <utility>
 
 // Zen
 #include <zen/core/all_dispatch.hpp>
 #include <zen/core/any_dispatch.hpp>
+#include <zen/meta/type_to_string.hpp>
+#include <zen/result/registry.hpp>
+#include <zen/utility/trace.hpp>
 
 namespace zen
 {
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Checks if \c T is a move_into tag
+ */
+template <typename T> struct is_move_into : std::false_type
+{};
+
+template <std::size_t I> struct is_move_into<move_into_t<I>> : std::true_type
+{};
+
+/**
+ * @brief Dispatch template argument for a forwarded argument of type \c T
+ *
+ * Executors are held by their exec::executor base type, so that parallel dispatch specializations are selected for
+ * any executor. Tags are held by value. Invocables keep their value category, so that lvalue invocables are held by
+ * reference.
+ */
+template <typename T>
+using dispatch_param_t = std::conditional_t<
+  std::is_base_of_v<exec::executor<std::decay_t<T>>, std::decay_t<T>>,
+  exec::executor<std::decay_t<T>>,
+  std::conditional_t<is_move_into<std::decay_t<T>>::value, std::decay_t<T>, T>>;
+
+/**
+ * @brief Checks if stage \c StageT takes ownership of the values of its input result
+ */
+template <typename StageT> struct takes_ownership : std::false_type
+{};
+
+template <typename ExecutorT, std::size_t I, typename... InvocableTs>
+struct takes_ownership<all_dispatch<exec::executor<ExecutorT>, move_into_t<I>, InvocableTs...>> : std::true_type
+{};
+
+/**
+ * @brief Returns values of <code>r</code> as passed to stage \c StageT; forwarded if the stage takes ownership of
+ *        them, otherwise as immutable references
+ */
+template <typename StageT, typename T> decltype(auto) stage_values(result<T>& r)
+{
+  if constexpr (takes_ownership<std::decay_t<StageT>>::value)
+  {
+    return forward_values(r);
+  }
+  else
+  {
+    return as_tuple(r);
+  }
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
 
 /**
  * @brief Passes values as a <code>result</code>
@@ -36,7 +95,7 @@ template <typename... ValueTs> constexpr decltype(auto) pass(ValueTs&&... values
  */
 template <typename... InvocableTs> constexpr decltype(auto) any(InvocableTs&&... t)
 {
-  return any_dispatch<std::remove_reference_t<InvocableTs>...>{std::forward<InvocableTs>(t)...};
+  return any_dispatch<detail::dispatch_param_t<InvocableTs>...>{std::forward<InvocableTs>(t)...};
 }
 
 /**
@@ -56,7 +115,7 @@ template <typename... InvocableTs> constexpr decltype(auto) any(InvocableTs&&...
  */
 template <typename... InvocableTs> constexpr decltype(auto) all(InvocableTs&&... t)
 {
-  return all_dispatch<std::remove_reference_t<InvocableTs>...>{std::forward<InvocableTs>(t)...};
+  return all_dispatch<detail::dispatch_param_t<InvocableTs>...>{std::forward<InvocableTs>(t)...};
 }
 
 /**
@@ -76,9 +135,15 @@ template <typename... InvocableTs> constexpr decltype(auto) all(InvocableTs&&...
  */
 template <typename T, typename Fn> decltype(auto) operator|(result<T>&& r, Fn&& f)
 {
-  using original_return_type = decltype(std::apply(std::forward<Fn>(f), as_tuple(r)));
+  using original_return_type = decltype(std::apply(std::forward<Fn>(f), detail::stage_values<Fn>(r)));
   using return_type = to_result_t<original_return_type>;
-  return r.valid() ? return_type{std::apply(std::forward<Fn>(f), as_tuple(r))} : return_type{r.status()};
+  if (!r.valid())
+  {
+    message_registry::instance().propagated(r.status().message());
+    return return_type{r.status()};
+  }
+  ZEN_TRACE_SPAN([] { return meta::type_to_string<std::remove_cv_t<std::remove_reference_t<Fn>>>(); }, "stage");
+  return return_type{std::apply(std::forward<Fn>(f), detail::stage_values<Fn>(r))};
 }
 
 }  // namespace zen
@@ -57,6 +57,10 @@ private:
         ((return_value = std::get<Is>(this->invocables_)(std::forward<ValueTs>(values)...), return_value.valid()) ||
          ...);
     }
+    if (!return_value.valid())
+    {
+      message_registry::instance().propagated(return_value.status().message());
+    }
     return return_value;
   }
 
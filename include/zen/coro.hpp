@@ -0,0 +1,5 @@
+#pragma once
+
+// Zen
+#include <zen/coro/task.hpp>
+#include <zen/coro/dispatch_awaitable.hpp>
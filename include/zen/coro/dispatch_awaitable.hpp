@@ -0,0 +1,191 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <coroutine>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/coro/task.hpp>
+#include <zen/executor/executor.hpp>
+#include <zen/parallel/executor_dispatch.hpp>
+
+namespace zen
+{
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Awaitable which runs each invocable of a parallel dispatch on its executor, and resumes the awaiting
+ *        coroutine on the thread which completes last
+ *
+ * No thread is blocked while invocables run. Invocables are called with no arguments, or with only a handle of the
+ * executor's <code>handle_type</code>, which is cancelled once the dispatch outcome is known. If the dispatch produces
+ * an invalid result, the awaiting task completes with its status, as when awaiting an invalid result<T>.
+ *
+ * @tparam DispatchT  any_dispatch or all_dispatch over an executor
+ * @tparam kAll  <code>true</code> if all results are combined, as with all(); otherwise, the first valid result is
+ *               selected, as with any()
+ */
+template <typename DispatchT, bool kAll, typename... InvocableTs> class dispatch_awaitable
+{
+public:
+  explicit dispatch_awaitable(const DispatchT& dispatch) : dispatch_{dispatch} {}
+
+  [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+  template <typename PromiseT> std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseT> continuation)
+  {
+    continuation_ = continuation;
+    fail_ = [](std::coroutine_handle<> awaiting, result_status status) -> std::coroutine_handle<> {
+      auto& promise = std::coroutine_handle<PromiseT>::from_address(awaiting.address()).promise();
+      promise.return_status(std::move(status));
+      return promise.continuation();
+    };
+    launch(std::make_index_sequence<N>{});
+
+    // Launching holds one count, so that the coroutine cannot be resumed before all work has been enqueued
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) > 1)
+    {
+      return std::noop_coroutine();
+    }
+    return complete();
+  }
+
+  decltype(auto) await_resume() { return std::remove_reference_t<decltype(**r_)>{std::move(**r_)}; }
+
+private:
+  static constexpr std::size_t N = sizeof...(InvocableTs);
+
+  template <std::size_t I>
+  using result_type_at = to_result_t<std::decay_t<decltype(exec::apply_with_handle(
+    std::declval<std::tuple_element_t<I, std::tuple<InvocableTs&...>>>(),
+    std::declval<typename DispatchT::handle_type&>(),
+    std::declval<std::tuple<>&>()))>>;
+
+  template <std::size_t... Is> static auto make_results(std::index_sequence<Is...>)
+  {
+    return std::tuple<result_type_at<Is>...>{};
+  }
+
+  template <std::size_t... Is> void launch(std::index_sequence<Is...>)
+  {
+    (dispatch_.executor().execute([this] { run<Is>(); }), ...);
+  }
+
+  template <std::size_t I> void run()
+  {
+    std::tuple<> no_args;
+    auto& r = std::get<I>(results_);
+    {
+      const arena_scope scope{handle_.arena()};
+      r = result_type_at<I>{exec::apply_with_handle(std::get<I>(dispatch_.invocables()), handle_, no_args)};
+    }
+
+    // Stop remaining work as soon as the outcome is known
+    if (kAll != r.valid())
+    {
+      handle_.cancel();
+    }
+
+    if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+      complete().resume();
+    }
+  }
+
+  /**
+   * @brief Combines results of all invocables; returns the coroutine to resume next
+   */
+  std::coroutine_handle<> complete()
+  {
+    r_.emplace(collect(std::make_index_sequence<N>{}));
+    return r_->valid() ? continuation_ : fail_(continuation_, r_->status());
+  }
+
+  template <std::size_t... Is> decltype(auto) collect(std::index_sequence<Is...>)
+  {
+    if constexpr (kAll)
+    {
+      return create(make_deferred_result([&r = std::get<Is>(results_)]() mutable { return std::move(r); })...);
+    }
+    else
+    {
+      result_type_at<0> r;
+      [[maybe_unused]] const bool found = ((r = std::move(std::get<Is>(results_)), r.valid()) || ...);
+      return r;
+    }
+  }
+
+  /// Dispatch being awaited; lives until the end of the <code>co_await</code> expression
+  const DispatchT& dispatch_;
+
+  /// Handle passed to invocables which accept one
+  typename DispatchT::handle_type handle_;
+
+  /// Results of each invocable, in order of invocables
+  decltype(make_results(std::make_index_sequence<N>{})) results_;
+
+  /// Number of invocables which have not completed, plus one while work is being launched
+  std::atomic<std::size_t> remaining_{N + 1};
+
+  /// Combined result of the dispatch
+  std::optional<decltype(std::declval<dispatch_awaitable&>().collect(std::make_index_sequence<N>{}))> r_;
+
+  /// Coroutine awaiting the dispatch
+  std::coroutine_handle<> continuation_;
+
+  /// Completes awaiting coroutine with an invalid status; returns the coroutine to resume in its place
+  std::coroutine_handle<> (*fail_)(std::coroutine_handle<>, result_status) = nullptr;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Awaits the first valid result of invocables dispatched with any() to an executor
+ *
+ * The awaiting coroutine is suspended, holding no thread, until all invocables have completed.
+ *
+ * @return value of the first valid result; if no result is valid, the awaiting task completes with the status of
+ *         the last one
+ *
+@verbatim
+  const auto value = co_await any(tp, [] { return from_cache(); }, [] { return from_database(); });
+@endverbatim
+ */
+template <typename ExecutorT, typename... InvocableTs>
+auto operator co_await(const any_dispatch<exec::executor<ExecutorT>, InvocableTs...>& dispatch)
+{
+  using dispatch_type = any_dispatch<exec::executor<ExecutorT>, InvocableTs...>;
+  return detail::dispatch_awaitable<dispatch_type, false, InvocableTs...>{dispatch};
+}
+
+/**
+ * @brief Awaits the combined results of invocables dispatched with all() to an executor
+ *
+ * The awaiting coroutine is suspended, holding no thread, until all invocables have completed.
+ *
+ * @return combined values, as produced by all(); if any result is invalid, the awaiting task completes with the
+ *         status of the first one
+ *
+@verbatim
+  const auto [a, b] = co_await all(tp, [] { return load_a(); }, [] { return load_b(); });
+@endverbatim
+ */
+template <typename ExecutorT, typename... InvocableTs>
+auto operator co_await(const all_dispatch<exec::executor<ExecutorT>, InvocableTs...>& dispatch)
+{
+  static_assert(
+    !(detail::is_move_into<std::decay_t<InvocableTs>>::value || ...),
+    "Awaited invocables receive no values, so there is nothing to hand over with move_into");
+  using dispatch_type = all_dispatch<exec::executor<ExecutorT>, InvocableTs...>;
+  return detail::dispatch_awaitable<dispatch_type, true, InvocableTs...>{dispatch};
+}
+
+}  // namespace zen
@@ -0,0 +1,348 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "zen/coro requires C++20 coroutine support"
+#endif  // !defined(__cpp_impl_coroutine)
+
+// C++ Standard Library
+#include <condition_variable>
+#include <coroutine>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/result.hpp>
+
+namespace zen
+{
+
+template <typename T> class task;
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Transfers execution to the coroutine which awaited a task once that task completes
+ */
+struct task_final_awaitable
+{
+  [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+  template <typename PromiseT>
+  std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseT> handle) const noexcept
+  {
+    return handle.promise().continuation();
+  }
+
+  constexpr void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Promise of a <code>task<T></code>
+ */
+template <typename T> class task_promise
+{
+public:
+  task<T> get_return_object() noexcept;
+
+  [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+
+  [[nodiscard]] task_final_awaitable final_suspend() const noexcept { return {}; }
+
+  template <typename ValueT> void return_value(ValueT&& value) { value_.emplace(std::forward<ValueT>(value)); }
+
+  void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+  /**
+   * @brief Completes task with an invalid <code>status</code>, without resuming the coroutine body
+   */
+  void return_status(result_status status) { value_.emplace(std::move(status)); }
+
+  void set_continuation(std::coroutine_handle<> continuation) noexcept { continuation_ = continuation; }
+
+  [[nodiscard]] std::coroutine_handle<> continuation() const noexcept { return continuation_; }
+
+  /**
+   * @brief Returns value produced by the task, or rethrows exception which escaped the coroutine body
+   */
+  T get()
+  {
+    if (exception_)
+    {
+      std::rethrow_exception(exception_);
+    }
+    return std::move(*value_);
+  }
+
+private:
+  /// Coroutine which awaits this task
+  std::coroutine_handle<> continuation_ = std::noop_coroutine();
+
+  /// Exception which escaped the coroutine body
+  std::exception_ptr exception_;
+
+  /// Value produced by the task
+  std::optional<T> value_;
+};
+
+/**
+ * @brief Awaitable which continues with the value of a valid result<T>, or completes the awaiting task early with
+ *        the status of an invalid one
+ *
+ * @tparam ResultT  result<T> held by value, or <code>const result<T>&</code>
+ */
+template <typename ResultT> class result_awaitable
+{
+public:
+  explicit constexpr result_awaitable(ResultT r) : r_{std::forward<ResultT>(r)} {}
+
+  [[nodiscard]] constexpr bool await_ready() const noexcept { return r_.valid(); }
+
+  template <typename PromiseT> std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseT> handle)
+  {
+    // Awaiting coroutine is never resumed; it is destroyed along with its task
+    handle.promise().return_status(r_.status());
+    return handle.promise().continuation();
+  }
+
+  decltype(auto) await_resume()
+  {
+    if constexpr (std::is_reference_v<ResultT>)
+    {
+      return *r_;
+    }
+    else
+    {
+      return std::remove_reference_t<decltype(*r_)>{std::move(*r_)};
+    }
+  }
+
+private:
+  ResultT r_;
+};
+
+/**
+ * @brief Blocking flag set by a sync_wait_task on completion
+ */
+class sync_wait_event
+{
+public:
+  void set()
+  {
+    std::lock_guard lock{mtx_};
+    set_ = true;
+    cv_.notify_all();
+  }
+
+  void wait()
+  {
+    std::unique_lock lock{mtx_};
+    cv_.wait(lock, [this] { return set_; });
+  }
+
+private:
+  std::mutex mtx_;
+  std::condition_variable cv_;
+  bool set_ = false;
+};
+
+/**
+ * @brief Coroutine which awaits a task on behalf of a thread blocked in sync_wait
+ */
+class sync_wait_task
+{
+public:
+  struct promise_type
+  {
+    struct final_awaitable
+    {
+      [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+      void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept { handle.promise().event.set(); }
+
+      constexpr void await_resume() const noexcept {}
+    };
+
+    sync_wait_task get_return_object() noexcept
+    {
+      return sync_wait_task{std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+
+    [[nodiscard]] std::suspend_always initial_suspend() const noexcept { return {}; }
+
+    [[nodiscard]] final_awaitable final_suspend() const noexcept { return {}; }
+
+    constexpr void return_void() const noexcept {}
+
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    /// Set once the coroutine has suspended for the last time
+    sync_wait_event event;
+
+    /// Exception which escaped the coroutine body
+    std::exception_ptr exception;
+  };
+
+  sync_wait_task(sync_wait_task&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+
+  ~sync_wait_task()
+  {
+    if (handle_)
+    {
+      handle_.destroy();
+    }
+  }
+
+  /**
+   * @brief Starts coroutine on the calling thread and blocks until it has completed
+   */
+  void run()
+  {
+    handle_.resume();
+    handle_.promise().event.wait();
+    if (handle_.promise().exception)
+    {
+      std::rethrow_exception(handle_.promise().exception);
+    }
+  }
+
+private:
+  explicit sync_wait_task(std::coroutine_handle<promise_type> handle) : handle_{handle} {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+template <typename T> sync_wait_task make_sync_wait_task(task<T>& t, std::optional<T>& value)
+{
+  value.emplace(co_await std::move(t));
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Lazily-started coroutine which produces a value of type <code>T</code>, usually a result<T>
+ *
+ * A task starts running when it is awaited, and resumes its awaiter when it completes, by symmetric transfer. Inside
+ * a <code>task<result<T>></code>, awaiting an invalid result<U> completes the task with that result's status, just as
+ * <code>operator|</code> short-circuits a pipeline.
+ *
+@verbatim
+  task<result<float>> handle_request(exec::thread_pool<>& tp, int id)
+  {
+    co_await tp.schedule();
+
+    const auto record = co_await load(id);  // returns early if invalid
+    const auto [a, b] = co_await all(tp, [&] { return score_a(record); }, [&] { return score_b(record); });
+    co_return a + b;
+  }
+@endverbatim
+ *
+ * @tparam T  value type produced by the coroutine
+ */
+template <typename T> class [[nodiscard]] task
+{
+public:
+  using promise_type = detail::task_promise<T>;
+  using value_type = T;
+
+  task(task&& other) noexcept : handle_{std::exchange(other.handle_, nullptr)} {}
+
+  task& operator=(task&& other) noexcept
+  {
+    if (this != &other)
+    {
+      this->~task();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+
+  ~task()
+  {
+    if (handle_)
+    {
+      handle_.destroy();
+    }
+  }
+
+  /**
+   * @brief Returns awaitable which starts this task and resumes the awaiting coroutine with its value
+   */
+  auto operator co_await() && noexcept
+  {
+    struct awaitable
+    {
+      [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+      std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) const noexcept
+      {
+        handle.promise().set_continuation(continuation);
+        return handle;
+      }
+
+      T await_resume() const { return handle.promise().get(); }
+
+      std::coroutine_handle<promise_type> handle;
+    };
+    return awaitable{handle_};
+  }
+
+private:
+  friend promise_type;
+
+  explicit task(std::coroutine_handle<promise_type> handle) : handle_{handle} {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+template <typename T> task<T> task_promise<T>::get_return_object() noexcept
+{
+  return task<T>{std::coroutine_handle<task_promise>::from_promise(*this)};
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Awaits a result<T> from inside a <code>task<result<U>></code>
+ *
+ * @return value of <code>r</code> if it is valid; otherwise, the awaiting task completes with <code>r.status()</code>
+ */
+template <typename T> constexpr detail::result_awaitable<result<T>> operator co_await(result<T>&& r)
+{
+  return detail::result_awaitable<result<T>>{std::move(r)};
+}
+
+/**
+ * @copydoc operator co_await(result<T>&&)
+ */
+template <typename T> constexpr detail::result_awaitable<const result<T>&> operator co_await(const result<T>& r)
+{
+  return detail::result_awaitable<const result<T>&>{r};
+}
+
+/**
+ * @brief Runs task <code>t</code> to completion, blocking the calling thread
+ *
+ * Used to await a task from outside of a coroutine, for example from <code>main</code>.
+ *
+ * @return value produced by <code>t</code>
+ */
+template <typename T> T sync_wait(task<T> t)
+{
+  std::optional<T> value;
+  detail::make_sync_wait_task(t, value).run();
+  return std::move(*value);
+}
+
+}  // namespace zen
@@ -1,5 +1,14 @@
 #pragma once
 
 // Zen
+#include <zen/executor/adaptive_executor.hpp>
 #include <zen/executor/executor.hpp>
+#include <zen/executor/fair_queue.hpp>
+#include <zen/executor/inline_executor.hpp>
+#include <zen/executor/locked_queue.hpp>
+#include <zen/executor/mpmc_queue.hpp>
+#include <zen/executor/pool_metrics.hpp>
+#include <zen/executor/task_node.hpp>
+#include <zen/executor/tenant.hpp>
 #include <zen/executor/thread_pool.hpp>
+#include <zen/executor/worker_storage.hpp>
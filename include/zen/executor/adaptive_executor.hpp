@@ -0,0 +1,320 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <utility>
+
+// Zen
+#include <zen/executor/executor.hpp>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Measurements and dispatch decisions of an adaptive_executor
+ */
+struct adaptive_report
+{
+  /// Name of the dispatch site
+  std::string_view name;
+
+  /// Moving average of the time taken by a single invocation
+  std::chrono::nanoseconds work;
+
+  /// Moving average of the time from submitting work to the inner executor until it starts running
+  std::chrono::nanoseconds latency;
+
+  /// Number of dispatches run entirely on the calling thread
+  std::size_t inline_count;
+
+  /// Number of dispatches split between the calling thread and the inner executor
+  std::size_t partial_count;
+
+  /// Number of dispatches run entirely on the inner executor
+  std::size_t parallel_count;
+};
+
+/**
+ * @brief <code>std::ostream</code> overload for adaptive_report
+ */
+inline std::ostream& operator<<(std::ostream& os, const adaptive_report& r)
+{
+  return os << r.name << ": inline=" << r.inline_count << " partial=" << r.partial_count
+            << " parallel=" << r.parallel_count << " work=" << r.work.count() << "ns latency=" << r.latency.count()
+            << "ns";
+}
+
+/**
+ * @brief Executor which decides, for each bulk dispatch, how much work to run on the calling thread rather than on an
+ *        inner executor
+ *
+ * Keeps moving averages of how long a single invocation takes, and of how long work submitted to the inner executor
+ * waits before it starts. Each bulk dispatch runs the split of invocations between the calling thread and the inner
+ * executor which is expected to finish first: all inline for tiny invocables, where submitting and waking would cost
+ * more than the work itself; all on the inner executor for heavy ones; or partially inline in between. Every so often,
+ * a dispatch is fanned out regardless, so that measurements of the inner executor stay current.
+ *
+ * Measurements are specific to the invocables dispatched through each adaptive_executor, so one should be declared for
+ * each dispatch site.
+ *
+@verbatim
+  exec::thread_pool tp{4};
+  exec::adaptive_executor decode_site{tp, "decode"};
+
+  auto r = pass(frame)
+         | all(decode_site, decode_header, decode_payload);
+
+  std::cout << decode_site.report() << std::endl;
+@endverbatim
+ *
+ * @tparam ExecutorT  inner executor type
+ */
+template <typename ExecutorT> class adaptive_executor final : public executor<adaptive_executor<ExecutorT>>
+{
+  using base = executor<adaptive_executor>;
+  friend base;
+
+  using clock_type = std::chrono::steady_clock;
+
+public:
+  /// Handle type passed to work dispatched on the inner executor
+  using handle_type = handle_type_t<ExecutorT>;
+
+  /// Weight of each new measurement in moving averages
+  static constexpr double kSmoothing = 0.125;
+
+  /// Number of dispatches between forced dispatches to the inner executor
+  static constexpr std::size_t kExploreInterval = 64;
+
+  /**
+   * @brief Creates adaptive_executor for a dispatch site
+   *
+   * @param inner  executor which runs work which is not run inline; must outlive this object
+   * @param name  name of the dispatch site, shown in reports
+   */
+  explicit adaptive_executor(ExecutorT& inner, std::string_view name = "adaptive") :
+      inner_{inner}, name_{name}, concurrency_{std::max<std::size_t>(1, concurrency_of(inner, 0))}
+  {}
+
+  /**
+   * @brief Returns measurements and dispatch decisions made so far
+   */
+  [[nodiscard]] adaptive_report report() const
+  {
+    return adaptive_report{
+      name_,
+      std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(work_ns_.load(std::memory_order_relaxed))},
+      std::chrono::nanoseconds{static_cast<std::chrono::nanoseconds::rep>(latency_ns_.load(std::memory_order_relaxed))},
+      inline_count_.load(std::memory_order_relaxed),
+      partial_count_.load(std::memory_order_relaxed),
+      parallel_count_.load(std::memory_order_relaxed)};
+  }
+
+  /**
+   * @brief Returns inner executor
+   */
+  [[nodiscard]] constexpr ExecutorT& inner() const { return inner_; }
+
+private:
+  /**
+   * @brief Work-enqueue implementation; single invocations always go to the inner executor
+   */
+  template <typename FnT> constexpr void execute_impl(FnT&& fn) { inner_.execute(std::forward<FnT>(fn)); }
+
+  /**
+   * @brief Runs invocations of a bulk dispatch which are submitted to the inner executor, offset by the number run
+   *        inline, and records their measurements
+   *
+   * Lives on the stack of bulk_execute_impl, which waits for every invocation to finish with it before returning.
+   */
+  template <typename FnT> class offload
+  {
+  public:
+    offload(adaptive_executor& site, FnT& fn, std::size_t first, std::size_t count) :
+        site_{site}, fn_{fn}, first_{first}, remaining_{count}, submitted_{clock_type::now()}
+    {}
+
+    void operator()(std::size_t i)
+    {
+      const auto started = clock_type::now();
+      update(site_.latency_ns_, started - submitted_);
+      fn_(first_ + i);
+      update(site_.work_ns_, clock_type::now() - started);
+
+      if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        // Notified under lock, so that wait() can not return, and destroy this object, before notify_one() does
+        std::lock_guard lock{mtx_};
+        done_ = true;
+        cv_.notify_one();
+      }
+    }
+
+    /**
+     * @brief Blocks until all invocations have run
+     */
+    void wait()
+    {
+      std::unique_lock lock{mtx_};
+      cv_.wait(lock, [this] { return done_; });
+    }
+
+  private:
+    adaptive_executor& site_;
+    FnT& fn_;
+    std::size_t first_;
+    std::atomic<std::size_t> remaining_;
+    clock_type::time_point submitted_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    bool done_ = false;
+  };
+
+  /**
+   * @brief Bulk work-enqueue implementation; runs invocations <code>[0, k)</code> inline, and submits the rest to the
+   *        inner executor as a single bulk dispatch, where <code>k</code> is chosen by plan()
+   *
+   * Returns once all invocations have run, since those on the inner executor record measurements after invoking
+   * <code>fn</code>.
+   */
+  template <typename FnT> void bulk_execute_impl(std::size_t n, FnT& fn)
+  {
+    const std::size_t k = plan(n);
+    if (k == n)
+    {
+      inline_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else if (k == 0)
+    {
+      parallel_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      partial_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (k == n)
+    {
+      run_inline(n, fn);
+      return;
+    }
+
+    // Submit work to the inner executor first, so that it runs alongside inline work
+    offload<FnT> rest{*this, fn, k, n - k};
+    inner_.bulk_execute(n - k, rest);
+    if (k > 0)
+    {
+      run_inline(k, fn);
+    }
+    rest.wait();
+  }
+
+  /**
+   * @brief Runs invocations <code>[0, k)</code> on the calling thread, and records their mean time
+   */
+  template <typename FnT> void run_inline(std::size_t k, FnT& fn)
+  {
+    const auto started = clock_type::now();
+    for (std::size_t i = 0; i < k; ++i)
+    {
+      fn(i);
+    }
+    update(work_ns_, (clock_type::now() - started) / k);
+  }
+
+  /**
+   * @brief Returns the number of <code>n</code> invocations to run inline which minimizes expected completion time
+   *
+   * Submitting work to the inner executor, and being woken once it completes, are each expected to cost one
+   * latency. Inline work runs one invocation at a time; work on the inner executor runs on all of its workers. Inline
+   * time grows with <code>k</code> while inner time shrinks, so the best split is next to where they cross, which is
+   * solved for directly rather than searched for.
+   */
+  std::size_t plan(std::size_t n)
+  {
+    if (calls_.fetch_add(1, std::memory_order_relaxed) % kExploreInterval == 0)
+    {
+      return 0;
+    }
+
+    const double work = work_ns_.load(std::memory_order_relaxed);
+    const double latency = latency_ns_.load(std::memory_order_relaxed);
+    if (work <= 0.0)
+    {
+      return n;
+    }
+
+    const auto time = [&](std::size_t k) {
+      const std::size_t rounds = (n - k + concurrency_ - 1) / concurrency_;
+      return std::max(static_cast<double>(k) * work, 2.0 * latency + static_cast<double>(rounds) * work);
+    };
+
+    // Solves k * work = 2 * latency + (n - k) / concurrency * work; rounding up to whole rounds moves the crossing
+    // by less than one invocation, so the best k is one of the three which follow
+    const double c = static_cast<double>(concurrency_);
+    const double crossing = (2.0 * latency * c / work + static_cast<double>(n)) / (c + 1.0);
+    const auto first = static_cast<std::size_t>(std::min(std::floor(crossing), static_cast<double>(n)));
+
+    std::size_t best_k = n;
+    double best_time = static_cast<double>(n) * work;
+    for (std::size_t k = first; k < std::min(first + 3, n); ++k)
+    {
+      if (const double t = time(k); t < best_time)
+      {
+        best_time = t;
+        best_k = k;
+      }
+    }
+    return best_k;
+  }
+
+  /**
+   * @brief Folds <code>sample</code> into moving <code>average</code>; concurrent updates may be dropped
+   */
+  static void update(std::atomic<double>& average, clock_type::duration sample)
+  {
+    const double ns = std::chrono::duration<double, std::nano>(sample).count();
+    double prev = average.load(std::memory_order_relaxed);
+    while (!average.compare_exchange_weak(
+      prev, (prev == 0.0) ? ns : (prev + kSmoothing * (ns - prev)), std::memory_order_relaxed))
+    {}
+  }
+
+  template <typename E> static auto concurrency_of(const E& e, int) -> decltype(std::size_t{e.workers()})
+  {
+    return e.workers();
+  }
+
+  template <typename E> static std::size_t concurrency_of(const E& e, long) { return 1; }
+
+  /// Executor which runs work which is not run inline
+  ExecutorT& inner_;
+
+  /// Name of the dispatch site
+  std::string_view name_;
+
+  /// Number of workers of the inner executor
+  std::size_t concurrency_;
+
+  /// Moving average of the time taken by a single invocation, in nanoseconds
+  std::atomic<double> work_ns_{0.0};
+
+  /// Moving average of the time from submission to the inner executor until work starts, in nanoseconds
+  std::atomic<double> latency_ns_{0.0};
+
+  /// Number of bulk dispatches so far
+  std::atomic<std::size_t> calls_{0};
+
+  /// Dispatch decision counts
+  std::atomic<std::size_t> inline_count_{0}, partial_count_{0}, parallel_count_{0};
+};
+
+}  // namespace zen::exec
@@ -1,31 +1,228 @@
 #pragma once
 
 // C++ Standard Library
+#include <atomic>
+#include <cstddef>
+#include <tuple>
 #include <type_traits>
 #include <utility>
+#if defined(__cpp_impl_coroutine)
+#include <coroutine>
+#endif  // defined(__cpp_impl_coroutine)
+
+// Zen
+#include <zen/executor/task_node.hpp>
+#include <zen/executor/worker_storage.hpp>
+#include <zen/utility/arena.hpp>
+#include <zen/utility/trace.hpp>
 
 namespace zen::exec
 {
 
+#if defined(__cpp_impl_coroutine)
+/**
+ * @brief Awaitable which resumes the awaiting coroutine on an executor
+ */
+template <typename ExecutorT> class schedule_awaitable
+{
+public:
+  explicit constexpr schedule_awaitable(ExecutorT& e) : e_{e} {}
+
+  [[nodiscard]] constexpr bool await_ready() const noexcept { return false; }
+
+  void await_suspend(std::coroutine_handle<> continuation) { e_.execute([continuation] { continuation.resume(); }); }
+
+  constexpr void await_resume() const noexcept {}
+
+private:
+  ExecutorT& e_;
+};
+#endif  // defined(__cpp_impl_coroutine)
+
+/**
+ * @brief Base for executors, which run work submitted with execute()
+ *
+ * Executors provide <code>execute_impl(fn)</code>. They may also provide <code>bulk_execute_impl(n, fn)</code> to
+ * submit a batch of work at once, <code>execute_intrusive_impl(first, last)</code> to link a chain of task nodes into
+ * their queue, and declare the <code>handle_type</code> passed to dispatched invocables; otherwise, exec::basic_handle
+ * is used.
+ *
+ * @tparam ExecutorT  executor implementation type
+ */
 template <typename ExecutorT> class executor
 {
 public:
-  template <typename FnT> constexpr void execute(FnT&& fn) { derived()->execute_impl(std::forward<FnT>(fn)); };
+  template <typename FnT> constexpr void execute(FnT&& fn)
+  {
+    ZEN_TRACE_INSTANT("enqueue", "executor");
+    derived()->execute_impl(std::forward<FnT>(fn));
+  };
+
+  /**
+   * @brief Submits work which invokes <code>fn(i)</code>, for each <code>i</code> in <code>[0, n)</code>
+   *
+   * @param n  number of invocations
+   * @param fn  invocable called with an index; must remain valid until all invocations have completed
+   */
+  template <typename FnT> constexpr void bulk_execute(std::size_t n, FnT& fn)
+  {
+    ZEN_TRACE_INSTANT("enqueue", "executor");
+    bulk_execute_or_loop(*derived(), n, fn, 0);
+  }
+
+  /**
+   * @brief Submits work which invokes <code>fn(i)</code>, for each <code>i</code> in <code>[0, N)</code>, from a batch
+   *        of task nodes
+   *
+   * Executors with an intrusive queue link the batch's nodes into it, without allocating or copying; others submit
+   * the batch's invocable with bulk_execute(N, fn).
+   *
+   * @param batch  task nodes; must remain valid until all invocations have completed
+   */
+  template <std::size_t N, typename FnT> constexpr void bulk_execute(task_batch<N, FnT>& batch)
+  {
+    ZEN_TRACE_INSTANT("enqueue", "executor");
+    intrusive_or_bulk_execute(*derived(), batch, 0);
+  }
+
+  /**
+   * @brief Submits a chain of task nodes, from <code>first</code> to <code>last</code>, each of which runs its own work
+   *
+   * Executors with an intrusive queue link the nodes into it, without allocating or copying; others submit each node
+   * with execute().
+   *
+   * @param first  first node of the chain
+   * @param last  last node of the chain; its <code>next</code> is ignored
+   */
+  constexpr void execute_intrusive(task_node& first, task_node& last)
+  {
+    ZEN_TRACE_INSTANT("enqueue", "executor");
+    intrusive_or_execute(*derived(), first, last, 0);
+  }
+
+#if defined(__cpp_impl_coroutine)
+  /**
+   * @brief Returns an awaitable which suspends the awaiting coroutine and resumes it on this executor
+   *
+@verbatim
+  co_await tp.schedule();  // now running on a worker of tp
+@endverbatim
+   */
+  [[nodiscard]] constexpr schedule_awaitable<ExecutorT> schedule()
+  {
+    return schedule_awaitable<ExecutorT>{*derived()};
+  }
+#endif  // defined(__cpp_impl_coroutine)
 
 private:
+  template <typename DerivedT, typename FnT>
+  static constexpr auto bulk_execute_or_loop(DerivedT& e, std::size_t n, FnT& fn, int)
+    -> decltype(e.bulk_execute_impl(n, fn))
+  {
+    return e.bulk_execute_impl(n, fn);
+  }
+
+  template <typename DerivedT, typename FnT>
+  static constexpr void bulk_execute_or_loop(DerivedT& e, std::size_t n, FnT& fn, long)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      e.execute_impl([&fn, i] { fn(i); });
+    }
+  }
+
+  template <typename DerivedT, std::size_t N, typename FnT>
+  static constexpr auto intrusive_or_bulk_execute(DerivedT& e, task_batch<N, FnT>& batch, int)
+    -> decltype(e.execute_intrusive_impl(batch.front(), batch.back()))
+  {
+    return e.execute_intrusive_impl(batch.front(), batch.back());
+  }
+
+  template <typename DerivedT, std::size_t N, typename FnT>
+  static constexpr void intrusive_or_bulk_execute(DerivedT& e, task_batch<N, FnT>& batch, long)
+  {
+    bulk_execute_or_loop(e, N, batch.fn(), 0);
+  }
+
+  template <typename DerivedT>
+  static constexpr auto intrusive_or_execute(DerivedT& e, task_node& first, task_node& last, int)
+    -> decltype(e.execute_intrusive_impl(first, last))
+  {
+    return e.execute_intrusive_impl(first, last);
+  }
+
+  template <typename DerivedT>
+  static constexpr void intrusive_or_execute(DerivedT& e, task_node& first, task_node& last, long)
+  {
+    // Links are read before submitting, since a node may be reused as soon as its work has run
+    for (task_node* n = &first;;)
+    {
+      task_node* const next = (n == &last) ? nullptr : n->next;
+      e.execute_impl([n] { n->run(*n); });
+      if (next == nullptr)
+      {
+        return;
+      }
+      n = next;
+    }
+  }
+
   [[nodiscard]] constexpr ExecutorT* derived() { return reinterpret_cast<ExecutorT*>(this); }
   [[nodiscard]] constexpr const ExecutorT* derived() const { return reinterpret_cast<const ExecutorT*>(this); }
 };
 
+/**
+ * @brief Base for handles passed to dispatched work
+ *
+ * Handles capture the arena which is current when they are created, so that work may allocate memory which ends with
+ * the pipeline invocation which dispatched it.
+ */
 template <typename HandleT> class executor_handle
 {
 public:
   [[nodiscard]] constexpr bool is_working() const { return derived()->is_working_impl(); };
   [[nodiscard]] constexpr bool is_cancelled() const { return !derived()->is_working_impl(); };
-  constexpr void cancel() { derived()->cancel_impl(); };
+  constexpr void cancel()
+  {
+    ZEN_TRACE_INSTANT("cancel", "dispatch");
+    derived()->cancel_impl();
+  };
   constexpr void yield() const { derived()->yield_impl(); };
 
+  /**
+   * @brief Returns arena of the dispatching pipeline invocation, or <code>nullptr</code> if there is none
+   */
+  [[nodiscard]] constexpr zen::arena* arena() const { return arena_; }
+
+  /**
+   * @brief Returns resource for allocations which end with the dispatching pipeline invocation
+   */
+  [[nodiscard]] std::pmr::memory_resource* resource() const
+  {
+    return (arena_ == nullptr) ? std::pmr::get_default_resource() : arena_;
+  }
+
+  /**
+   * @brief Returns object of type <code>T</code> local to the worker thread running this work
+   *
+   * The object is default-constructed on first use, and persists across work run on the same worker, so hot stages
+   * may reuse buffers without allocating or synchronizing. It must not be used outside of the work which requested it.
+   *
+@verbatim
+  [](const auto& handle, int n) -> result<int>
+  {
+    auto& buffer = handle.template local<std::vector<float>>();
+    buffer.resize(n);
+    ...
+  }
+@endverbatim
+   */
+  template <typename T> [[nodiscard]] T& local() const { return worker_storage::current().get<T>(); }
+
 private:
+  /// Arena which was current when this handle was created
+  zen::arena* arena_ = current_arena();
+
   constexpr static void yield_impl()
   { /*fallback*/
   }
@@ -33,9 +230,70 @@ private:
   constexpr const HandleT* derived() const { return reinterpret_cast<const HandleT*>(this); }
 };
 
+/**
+ * @brief Handle with a shared cancellation flag; default handle type of executors which do not declare one
+ */
+class basic_handle : public executor_handle<basic_handle>
+{
+  friend class executor_handle<basic_handle>;
+
+public:
+  basic_handle() = default;
+
+private:
+  /// @copydoc executor_handle<basic_handle>::is_working_impl
+  bool is_working_impl() const { return working_.load(std::memory_order_relaxed); };
+
+  /// @copydoc executor_handle<basic_handle>::cancel_impl
+  void cancel_impl() { working_.store(false, std::memory_order_relaxed); };
+
+  /// Atomic flag shared between work to check if it should still run
+  std::atomic<bool> working_{true};
+};
+
+template <typename T> struct is_executor : std::integral_constant<bool, std::is_base_of_v<executor<T>, T>>
+{};
+
+template <typename T> static constexpr bool is_executor_v = is_executor<T>::value;
+
+/**
+ * @brief Handle type passed to work dispatched on executor <code>ExecutorT</code>
+ */
+template <typename ExecutorT, typename = void> struct handle_type
+{
+  using type = basic_handle;
+};
+
+template <typename ExecutorT> struct handle_type<ExecutorT, std::void_t<typename ExecutorT::handle_type>>
+{
+  using type = typename ExecutorT::handle_type;
+};
+
+template <typename ExecutorT> using handle_type_t = typename handle_type<ExecutorT>::type;
+
 template <typename T> struct is_executor_handle : std::integral_constant<bool, std::is_base_of_v<executor_handle<T>, T>>
 {};
 
 template <typename T> static constexpr bool is_executor_handle_v = is_executor_handle<T>::value;
 
+/**
+ * @brief Applies <code>args</code> to <code>fn</code>, passing <code>handle</code> first if <code>fn</code> accepts it
+ */
+template <typename FnT, typename HandleT, typename ArgTupleT>
+constexpr decltype(auto) apply_with_handle(FnT& fn, HandleT& handle, ArgTupleT& args)
+{
+  return std::apply(
+    [&fn, &handle](auto&... args) -> decltype(auto) {
+      if constexpr (std::is_invocable_v<FnT&, HandleT&, decltype(args)...>)
+      {
+        return fn(handle, args...);
+      }
+      else
+      {
+        return fn(args...);
+      }
+    },
+    args);
+}
+
 }  // namespace zen::exec
@@ -0,0 +1,535 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+// Zen
+#include <zen/executor/pool_metrics.hpp>
+#include <zen/executor/task_node.hpp>
+#include <zen/executor/tenant.hpp>
+#include <zen/utility/histogram.hpp>
+#include <zen/utility/trace.hpp>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Work queue which shares workers fairly between tenants, by deficit round robin
+ *
+ * Work is queued per tenant, under the tenant which is current on the submitting thread (see tenant_scope). Tenants
+ * with queued work take turns; on each turn, a tenant is credited <code>weight * kQuantum</code> of worker time, and
+ * its oldest work is served for as long as it has credit left. The time each piece of work actually ran for is
+ * charged once it completes, so tenants receive worker time in proportion to their weights, however long their work
+ * is, and a tenant with a large fan-out can not monopolize workers. Tenants which have reached their concurrency cap
+ * are skipped, without being credited.
+ * \n
+ * Work which a worker submits while running work of this queue, e.g. branches of a dispatch nested in a stage, is
+ * nested work. It is queued apart, served ahead of other work of its tenant, and is not subject to, nor counted
+ * towards, the concurrency cap: the work which submitted it may be blocked waiting on it, so holding it back for the
+ * cap could deadlock.
+ *
+ * All state is guarded by a single mutex, as with locked_queue.
+ *
+ * @tparam FuncWrapperT  type-erased work type
+ * @tparam FuncWrapperAllocatorT  allocator of type-erased work
+ */
+template <typename FuncWrapperT, typename FuncWrapperAllocatorT> class fair_queue
+{
+  using clock_type = std::chrono::steady_clock;
+
+  /**
+   * @brief Queued type-erased work
+   */
+  struct entry
+  {
+    FuncWrapperT fn;
+    clock_type::time_point enqueued;
+  };
+
+  using entry_allocator_type = typename std::allocator_traits<FuncWrapperAllocatorT>::template rebind_alloc<entry>;
+
+  /**
+   * @brief Queued work of a tenant
+   */
+  struct lane
+  {
+    [[nodiscard]] bool empty() const { return entries.empty() && head == nullptr; }
+
+    /// Queued type-erased work, oldest first
+    std::deque<entry, entry_allocator_type> entries;
+
+    /// First node of intrusive queue of work, owned by submitters
+    task_node* head = nullptr;
+
+    /// Last node of intrusive queue of work
+    task_node* tail = nullptr;
+  };
+
+  /**
+   * @brief Queue and scheduling state of a tenant
+   */
+  struct tenant
+  {
+    explicit tenant(std::size_t tenant_id) : id{tenant_id} {}
+
+    [[nodiscard]] bool empty() const { return queued.empty() && nested.empty(); }
+
+    [[nodiscard]] bool capped() const { return running >= config.max_concurrency; }
+
+    /// Returns <code>true</code> if any queued work may run now; nested work may run whether capped or not
+    [[nodiscard]] bool runnable() const { return !nested.empty() || (!queued.empty() && !capped()); }
+
+    [[nodiscard]] std::int64_t quantum() const
+    {
+      return static_cast<std::int64_t>(std::max<std::size_t>(config.weight, 1)) * kQuantum.count();
+    }
+
+    /// Identifier of this tenant
+    std::size_t id;
+
+    /// Work submitted from outside of work running on this queue
+    lane queued;
+
+    /// Work submitted by work running on this queue
+    lane nested;
+
+    /// Scheduling parameters
+    tenant_config config;
+
+    /// Worker time, in nanoseconds, which this tenant may still use before its turn ends; negative while it is in debt
+    std::int64_t deficit = 0;
+
+    /// Work which is running, other than nested work
+    std::size_t running = 0;
+
+    /// Set once this tenant has been credited for its current turn
+    bool credited = false;
+
+    /// Set while this tenant is in the round robin
+    bool active = false;
+
+    /// Live counters of this tenant
+    tenant_stats stats;
+  };
+
+public:
+  /// Worker time credited to a tenant of weight 1 on each of its turns
+  static constexpr std::chrono::microseconds kQuantum{100};
+
+  /**
+   * @param worker_count  number of workers which will attach() to this queue; unused
+   */
+  explicit fair_queue(std::size_t worker_count = 0) {}
+
+  /**
+   * @brief Identifies calling thread as worker <code>index</code> of this queue; all workers are served alike
+   */
+  constexpr void attach(std::size_t index) {}
+
+  /**
+   * @brief Sets scheduling parameters of <code>tenant_id</code>
+   */
+  void configure(std::size_t tenant_id, const tenant_config& config)
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    find_or_add(tenant_id).config = config;
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Returns live counters of <code>tenant_id</code>; valid for as long as this queue
+   */
+  [[nodiscard]] const tenant_stats& stats(std::size_t tenant_id)
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    return find_or_add(tenant_id).stats;
+  }
+
+  /**
+   * @brief Enqueues work under the current tenant
+   */
+  template <typename FnT> void push(FnT&& fn)
+  {
+    const auto now = clock_type::now();
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    tenant& t = find_or_add(current_tenant());
+    submit_lane(t).entries.push_back(entry{FuncWrapperT{std::forward<FnT>(fn)}, now});
+    enqueued(t, 1);
+    work_queue_cv_.notify_one();
+  }
+
+  /**
+   * @brief Enqueues work which invokes <code>fn(i)</code>, for each <code>i</code> in <code>[0, n)</code>, under the
+   *        current tenant and a single lock
+   */
+  template <typename FnT> void push_bulk(std::size_t n, FnT& fn)
+  {
+    const auto now = clock_type::now();
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    tenant& t = find_or_add(current_tenant());
+    auto& l = submit_lane(t);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      l.entries.push_back(entry{FuncWrapperT{[&fn, i] { fn(i); }}, now});
+    }
+    enqueued(t, n);
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Links the chain of nodes <code>[first, last]</code> into the intrusive list of the current tenant, without
+   *        allocating or copying
+   */
+  void push_intrusive(task_node& first, task_node& last)
+  {
+    const auto now = clock_type::now();
+    std::size_t n = 1;
+    for (task_node* node = &first; node != &last; node = node->next)
+    {
+      node->enqueued = now;
+      ++n;
+    }
+    last.enqueued = now;
+
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    tenant& t = find_or_add(current_tenant());
+    auto& l = submit_lane(t);
+    last.next = nullptr;
+    if (l.tail == nullptr)
+    {
+      l.head = &first;
+    }
+    else
+    {
+      l.tail->next = &first;
+    }
+    l.tail = &last;
+    enqueued(t, n);
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Waits for work and runs it, with its tenant current
+   *
+   * @param counters  counters of the calling worker
+   *
+   * @retval true  if work was run
+   * @retval false  if the queue was stopped
+   */
+  bool run_next(worker_counters& counters)
+  {
+    const auto waiting = clock_type::now();
+    auto lock = detail::lock_counting_contention(work_queue_mtx_, counters.contended);
+    while (is_working_)
+    {
+      tenant* const t = choose();
+      if (t == nullptr)
+      {
+        work_queue_cv_.wait(lock);
+        continue;
+      }
+
+      // Take oldest work of tenant under lock, nested work first, since running work may be waiting on it
+      const auto now = clock_type::now();
+      const bool nested = !t->nested.empty();
+      auto& l = nested ? t->nested : t->queued;
+      task_node* node = nullptr;
+      std::optional<FuncWrapperT> fn;
+      clock_type::time_point enqueued;
+      if (l.head != nullptr && (l.entries.empty() || l.head->enqueued <= l.entries.front().enqueued))
+      {
+        node = l.head;
+        l.head = node->next;
+        if (l.head == nullptr)
+        {
+          l.tail = nullptr;
+        }
+        enqueued = node->enqueued;
+      }
+      else
+      {
+        fn.emplace(std::move(l.entries.front().fn));
+        enqueued = l.entries.front().enqueued;
+        l.entries.pop_front();
+      }
+      dequeued(*t, nested);
+      counters.idle(now - waiting);
+      age_.record(now - enqueued);
+      t->stats.wait.record(now - enqueued);
+      ZEN_TRACE_COMPLETE("queue_wait", "queue", enqueued, now);
+
+      // Unlock before executing work to allow new work to be
+      // enqueue during work execution
+      lock.unlock();
+      const auto started = clock_type::now();
+      {
+        const tenant_scope scope{t->id};
+        const running_scope in_queue{this};
+        ZEN_TRACE_SPAN("task", "queue");
+        if (node == nullptr)
+        {
+          (*fn)();
+        }
+        else
+        {
+          node->run(*node);
+        }
+      }
+      const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now() - started);
+      t->stats.run.record(elapsed);
+      counters.ran(elapsed);
+
+      lock = detail::lock_counting_contention(work_queue_mtx_, counters.contended);
+      completed(*t, nested, elapsed);
+      return true;
+    }
+    return false;
+  }
+
+  /**
+   * @brief Wakes all waiting workers, and makes run_next() return <code>false</code> from now on
+   */
+  void stop()
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    is_working_ = false;
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Returns histogram of how long work of all tenants waited in this queue before it started running
+   */
+  [[nodiscard]] const histogram& age() const { return age_; }
+
+  /**
+   * @brief Returns the number of queued work of all tenants
+   */
+  [[nodiscard]] std::size_t depth() const
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    return depth_;
+  }
+
+  /**
+   * @brief Returns counters of work submitted to this queue
+   */
+  [[nodiscard]] const submit_counters& counters() const { return counters_; }
+
+private:
+  /**
+   * @brief Marks the calling worker as running work of a queue, until destroyed
+   */
+  class running_scope
+  {
+  public:
+    explicit running_scope(const fair_queue* q) noexcept : previous_{current()} { current() = q; }
+
+    ~running_scope() { current() = previous_; }
+
+    running_scope(const running_scope&) = delete;
+    running_scope& operator=(const running_scope&) = delete;
+
+    /// Returns queue whose work the calling thread is running, if any
+    static const fair_queue*& current() noexcept
+    {
+      static thread_local const fair_queue* q = nullptr;
+      return q;
+    }
+
+  private:
+    const fair_queue* previous_;
+  };
+
+  /**
+   * @brief Returns lane of <code>t</code> which work submitted from the calling thread is queued in
+   */
+  lane& submit_lane(tenant& t) const { return (running_scope::current() == this) ? t.nested : t.queued; }
+
+  tenant& find_or_add(std::size_t tenant_id)
+  {
+    auto& t = tenants_[tenant_id];
+    if (t == nullptr)
+    {
+      t = std::make_unique<tenant>(tenant_id);
+    }
+    return *t;
+  }
+
+  /**
+   * @brief Accounts for <code>n</code> pieces of work queued under <code>t</code>, and adds it to the round robin
+   */
+  void enqueued(tenant& t, std::size_t n)
+  {
+    t.stats.depth.fetch_add(n, std::memory_order_relaxed);
+    t.stats.submitted.fetch_add(n, std::memory_order_relaxed);
+    counters_.submitted.fetch_add(n, std::memory_order_relaxed);
+    depth_ += n;
+    if (!t.active)
+    {
+      t.active = true;
+      round_robin_.push_back(&t);
+    }
+  }
+
+  /**
+   * @brief Accounts for work of <code>t</code> taken from queue, and removes it from the round robin once it has no
+   *        queued work left; <code>t</code> is at the front of the round robin
+   */
+  void dequeued(tenant& t, bool nested)
+  {
+    if (!nested)
+    {
+      ++t.running;
+    }
+    --depth_;
+    t.stats.depth.fetch_sub(1, std::memory_order_relaxed);
+    t.stats.running.fetch_add(1, std::memory_order_relaxed);
+    if (t.empty())
+    {
+      // Unused credit is not carried over to the next time this tenant has work; debt is
+      t.active = false;
+      t.credited = false;
+      t.deficit = std::min<std::int64_t>(t.deficit, 0);
+      round_robin_.pop_front();
+    }
+  }
+
+  /**
+   * @brief Charges <code>t</code> for the time its work ran for
+   */
+  void completed(tenant& t, bool nested, std::chrono::nanoseconds elapsed)
+  {
+    const bool was_capped = t.capped();
+    if (!nested)
+    {
+      --t.running;
+    }
+    t.deficit -= elapsed.count();
+    t.stats.running.fetch_sub(1, std::memory_order_relaxed);
+    t.stats.completed.fetch_add(1, std::memory_order_relaxed);
+
+    // Workers may be waiting on work which this tenant could not run until now
+    if (was_capped && !t.empty())
+    {
+      work_queue_cv_.notify_one();
+    }
+  }
+
+  /**
+   * @brief Selects tenant whose work runs next, if any
+   */
+  tenant* choose()
+  {
+    std::size_t unserved = 0;
+    while (!round_robin_.empty())
+    {
+      // Tenant at front of the round robin is having its turn
+      tenant& t = *round_robin_.front();
+      if (t.runnable())
+      {
+        if (!t.credited)
+        {
+          t.deficit += t.quantum();
+          t.credited = true;
+        }
+        if (t.deficit > 0)
+        {
+          return &t;
+        }
+      }
+
+      // End turn
+      t.credited = false;
+      round_robin_.pop_front();
+      round_robin_.push_back(&t);
+
+      if (++unserved == round_robin_.size())
+      {
+        if (!skip_rounds())
+        {
+          return nullptr;
+        }
+        unserved = 0;
+      }
+    }
+    return nullptr;
+  }
+
+  /**
+   * @brief Credits tenants for the rounds in which all of them would only pay off debt, after a round in which none
+   *        could be served
+   *
+   * @retval true  if any tenant can be served in the next round
+   * @retval false  if no tenant has work which may run
+   */
+  bool skip_rounds()
+  {
+    std::int64_t rounds = -1;
+    for (const tenant* t : round_robin_)
+    {
+      if (t->runnable())
+      {
+        // Rounds after which the tenant's next turn leaves it with credit
+        const std::int64_t needed = (-t->deficit) / t->quantum();
+        rounds = (rounds < 0) ? needed : std::min(rounds, needed);
+      }
+    }
+    if (rounds < 0)
+    {
+      return false;
+    }
+    for (tenant* t : round_robin_)
+    {
+      if (t->runnable())
+      {
+        t->deficit += rounds * t->quantum();
+      }
+    }
+    return true;
+  }
+
+  /// Mutex which synchronizes all other members between threads of execution
+  mutable std::mutex work_queue_mtx_;
+
+  /// Tenants, by identifier; identifiers may be sparse, and only tenants with queued work are scheduled
+  std::unordered_map<std::size_t, std::unique_ptr<tenant>> tenants_;
+
+  /// Tenants with queued work, in the order they take turns
+  std::deque<tenant*> round_robin_;
+
+  /// Conditional variable used to notify about new work
+  std::condition_variable work_queue_cv_;
+
+  /// Time which work waited before it started running
+  histogram age_;
+
+  /// Number of queued work of all tenants
+  std::size_t depth_ = 0;
+
+  /// Work submitted, and contention between submitters
+  submit_counters counters_;
+
+  /// Flag used to indicate that queue is still active
+  bool is_working_ = true;
+};
+
+/**
+ * @brief Queue policy of thread_pool which selects fair_queue
+ */
+struct fair_queue_policy
+{
+  template <typename FuncWrapperT, typename FuncWrapperAllocatorT>
+  using queue_type = fair_queue<FuncWrapperT, FuncWrapperAllocatorT>;
+};
+
+}  // namespace zen::exec
@@ -0,0 +1,30 @@
+#pragma once
+
+// C++ Standard Library
+#include <utility>
+
+// Zen
+#include <zen/executor/executor.hpp>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Executor which runs work immediately, on the thread which submits it
+ *
+ * Runs parallel dispatches deterministically, in order of invocables, which is useful for testing and for
+ * pipelines whose stages are too cheap to benefit from running on other threads.
+ */
+class inline_executor final : public executor<inline_executor>
+{
+  using base = executor<inline_executor>;
+  friend base;
+
+private:
+  /**
+   * @brief Work-execute implementation
+   */
+  template <typename FnT> constexpr void execute_impl(FnT&& fn) { std::forward<FnT>(fn)(); }
+};
+
+}  // namespace zen::exec
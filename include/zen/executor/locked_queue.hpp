@@ -0,0 +1,516 @@
+#pragma once
+
+// C++ Standard Library
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/executor/pool_metrics.hpp>
+#include <zen/executor/task_node.hpp>
+#include <zen/utility/histogram.hpp>
+#include <zen/utility/trace.hpp>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Order in which a locked_queue hands out work
+ */
+enum class queue_order
+{
+  /// Newest work first; keeps caches warm, but old work may wait behind a steady stream of new work
+  lifo,
+
+  /// Oldest work first
+  fifo,
+
+  /// Work submitted by a worker goes to that worker's own stack, which it serves newest first; other work is served
+  /// oldest first. Idle workers take the oldest work from other workers' stacks.
+  lifo_local_fifo_global,
+};
+
+/**
+ * @brief Work queue guarded by a single mutex, with a condition variable on which idle workers wait
+ *
+ * Holds type-erased work in <code>std::vector</code>s, and task nodes in an intrusive list, which is served oldest
+ * first. Task nodes and type-erased work are ordered against each other by when they were enqueued, following
+ * <code>kOrder</code>, so that neither is starved by a stream of the other.
+ * \n
+ * With <code>kMaxWait</code>, work which has waited longer than max_wait() is served before any newer work, whatever
+ * the order, which bounds how long work can be starved by newer work. Finding the oldest work only compares the
+ * heads of the intrusive list and the global queue, except with queue_order::lifo_local_fifo_global, where it
+ * searches the stacks of all workers on every pop; the bound is therefore on by default, except with that order.
+ *
+ * @tparam FuncWrapperT  type-erased work type
+ * @tparam FuncWrapperAllocatorT  allocator of type-erased work
+ * @tparam kOrder  order in which work is served
+ * @tparam kMaxWait  if <code>true</code>, bounds how long work may wait before it is served ahead of newer work
+ */
+template <
+  typename FuncWrapperT,
+  typename FuncWrapperAllocatorT,
+  queue_order kOrder = queue_order::lifo,
+  bool kMaxWait = (kOrder != queue_order::lifo_local_fifo_global)>
+class locked_queue
+{
+  using clock_type = std::chrono::steady_clock;
+
+  /**
+   * @brief Queued type-erased work
+   */
+  struct entry
+  {
+    FuncWrapperT fn;
+    clock_type::time_point enqueued;
+  };
+
+  /**
+   * @brief Entries which may be removed from either end, without shifting remaining entries on every removal from
+   *        the front
+   */
+  class entry_queue
+  {
+  public:
+    [[nodiscard]] bool empty() const { return head_ == entries_.size(); }
+
+    [[nodiscard]] const entry& front() const { return entries_[head_]; }
+
+    [[nodiscard]] const entry& back() const { return entries_.back(); }
+
+    template <typename FnT> void push(FnT&& fn, clock_type::time_point enqueued)
+    {
+      entries_.push_back(entry{FuncWrapperT{std::forward<FnT>(fn)}, enqueued});
+    }
+
+    entry pop_front()
+    {
+      entry e{std::move(entries_[head_++])};
+      if (empty())
+      {
+        clear();
+      }
+      else if (head_ * 2 >= entries_.size())
+      {
+        entries_.erase(entries_.begin(), entries_.begin() + head_);
+        head_ = 0;
+      }
+      return e;
+    }
+
+    entry pop_back()
+    {
+      entry e{std::move(entries_.back())};
+      entries_.pop_back();
+      if (empty())
+      {
+        clear();
+      }
+      return e;
+    }
+
+  private:
+    void clear()
+    {
+      entries_.clear();
+      head_ = 0;
+    }
+
+    std::vector<entry, typename std::allocator_traits<FuncWrapperAllocatorT>::template rebind_alloc<entry>> entries_;
+    std::size_t head_ = 0;
+  };
+
+  /**
+   * @brief Work selected to run next
+   */
+  struct choice
+  {
+    /// Task node to run, if work is in the intrusive list
+    task_node* node = nullptr;
+
+    /// Queue of type-erased work to run, otherwise
+    entry_queue* queue = nullptr;
+
+    /// If <code>true</code>, takes the oldest work from <code>queue</code>; otherwise, the newest
+    bool front = false;
+
+    [[nodiscard]] constexpr bool empty() const { return node == nullptr && queue == nullptr; }
+
+    /// Returns time at which the oldest work of the choice was enqueued
+    [[nodiscard]] clock_type::time_point enqueued() const
+    {
+      return (node == nullptr) ? queue->front().enqueued : node->enqueued;
+    }
+  };
+
+  static constexpr bool kLocal = (kOrder == queue_order::lifo_local_fifo_global);
+
+public:
+  /// Default value of max_wait()
+  static constexpr std::chrono::milliseconds kDefaultMaxWait{10};
+
+  /**
+   * @param worker_count  number of workers which will attach() to this queue
+   */
+  explicit locked_queue(std::size_t worker_count = 0) : local_(kLocal ? worker_count : 0) {}
+
+  /**
+   * @brief Identifies calling thread as worker <code>index</code> of this queue
+   */
+  void attach(std::size_t index) { current_worker() = worker{this, index}; }
+
+  /**
+   * @brief Enqueues work
+   */
+  template <typename FnT> void push(FnT&& fn)
+  {
+    const auto now = clock_type::now();
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    submit_queue().push(std::forward<FnT>(fn), now);
+    ++depth_;
+    counters_.submitted.fetch_add(1, std::memory_order_relaxed);
+    work_queue_cv_.notify_one();
+  }
+
+  /**
+   * @brief Enqueues work which invokes <code>fn(i)</code>, for each <code>i</code> in <code>[0, n)</code>, under a
+   *        single lock
+   */
+  template <typename FnT> void push_bulk(std::size_t n, FnT& fn)
+  {
+    const auto now = clock_type::now();
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    auto& queue = submit_queue();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      queue.push([&fn, i] { fn(i); }, now);
+    }
+    depth_ += n;
+    counters_.submitted.fetch_add(n, std::memory_order_relaxed);
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Links the chain of nodes <code>[first, last]</code> into the intrusive list, without allocating or copying
+   */
+  void push_intrusive(task_node& first, task_node& last)
+  {
+    const auto now = clock_type::now();
+    std::size_t n = 1;
+    for (task_node* node = &first; node != &last; node = node->next, ++n)
+    {
+      node->enqueued = now;
+    }
+    last.enqueued = now;
+
+    const auto lock = detail::lock_counting_contention(work_queue_mtx_, counters_.contended);
+    last.next = nullptr;
+    if (intrusive_tail_ == nullptr)
+    {
+      intrusive_head_ = &first;
+    }
+    else
+    {
+      intrusive_tail_->next = &first;
+    }
+    intrusive_tail_ = &last;
+    depth_ += n;
+    counters_.submitted.fetch_add(n, std::memory_order_relaxed);
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Waits for work and runs it
+   *
+   * @param counters  counters of the calling worker
+   *
+   * @retval true  if work was run
+   * @retval false  if the queue was stopped
+   */
+  bool run_next(worker_counters& counters)
+  {
+    const auto waiting = clock_type::now();
+    auto lock = detail::lock_counting_contention(work_queue_mtx_, counters.contended);
+    while (is_working_)
+    {
+      const auto now = clock_type::now();
+      const choice c = choose(now);
+      if (c.empty())
+      {
+        work_queue_cv_.wait(lock);
+        continue;
+      }
+
+      --depth_;
+      counters.idle(now - waiting);
+      if (c.queue != nullptr && c.queue != &global_ && c.queue != local_queue())
+      {
+        counters.steals.fetch_add(1, std::memory_order_relaxed);
+      }
+
+      if (c.node != nullptr)
+      {
+        // Unlink next node under lock; its owner keeps it valid until its work has run
+        task_node* const node = intrusive_head_;
+        intrusive_head_ = node->next;
+        if (intrusive_head_ == nullptr)
+        {
+          intrusive_tail_ = nullptr;
+        }
+        age_.record(now - node->enqueued);
+        ZEN_TRACE_COMPLETE("queue_wait", "queue", node->enqueued, now);
+
+        lock.unlock();
+        {
+          ZEN_TRACE_SPAN("task", "queue");
+          node->run(*node);
+        }
+        counters.ran(clock_type::now() - now);
+        return true;
+      }
+      else
+      {
+        // Grab next work under lock and remove from queue
+        entry e = c.front ? c.queue->pop_front() : c.queue->pop_back();
+        age_.record(now - e.enqueued);
+        ZEN_TRACE_COMPLETE("queue_wait", "queue", e.enqueued, now);
+
+        // Unlock before executing work to allow new work to be
+        // enqueue during work execution
+        lock.unlock();
+        {
+          ZEN_TRACE_SPAN("task", "queue");
+          e.fn();
+        }
+        counters.ran(clock_type::now() - now);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Wakes all waiting workers, and makes run_next() return <code>false</code> from now on
+   */
+  void stop()
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    is_working_ = false;
+    work_queue_cv_.notify_all();
+  }
+
+  /**
+   * @brief Sets how long work may wait before it is served ahead of all newer work
+   */
+  void set_max_wait(std::chrono::nanoseconds max_wait)
+  {
+    static_assert(kMaxWait, "Queue was not created with a max-wait bound; see locked_queue_policy");
+    std::lock_guard lock{work_queue_mtx_};
+    max_wait_ = max_wait;
+  }
+
+  /**
+   * @brief Returns how long work may wait before it is served ahead of all newer work
+   */
+  [[nodiscard]] std::chrono::nanoseconds max_wait() const
+  {
+    static_assert(kMaxWait, "Queue was not created with a max-wait bound; see locked_queue_policy");
+    std::lock_guard lock{work_queue_mtx_};
+    return max_wait_;
+  }
+
+  /**
+   * @brief Returns histogram of how long work waited in this queue before it started running
+   */
+  [[nodiscard]] const histogram& age() const { return age_; }
+
+  /**
+   * @brief Returns the number of queued work
+   */
+  [[nodiscard]] std::size_t depth() const
+  {
+    std::lock_guard lock{work_queue_mtx_};
+    return depth_;
+  }
+
+  /**
+   * @brief Returns counters of work submitted to this queue
+   */
+  [[nodiscard]] const submit_counters& counters() const { return counters_; }
+
+private:
+  /**
+   * @brief Worker identity of a thread
+   */
+  struct worker
+  {
+    const locked_queue* queue = nullptr;
+    std::size_t index = 0;
+  };
+
+  static worker& current_worker()
+  {
+    static thread_local worker current;
+    return current;
+  }
+
+  /**
+   * @brief Returns stack of calling worker, or <code>nullptr</code> if calling thread is not a worker of this queue
+   */
+  entry_queue* local_queue()
+  {
+    if constexpr (kLocal)
+    {
+      const worker& w = current_worker();
+      return (w.queue == this && w.index < local_.size()) ? &local_[w.index] : nullptr;
+    }
+    else
+    {
+      return nullptr;
+    }
+  }
+
+  /**
+   * @brief Returns queue which work submitted by the calling thread goes to
+   */
+  entry_queue& submit_queue()
+  {
+    entry_queue* const local = local_queue();
+    return (local == nullptr) ? global_ : *local;
+  }
+
+  /**
+   * @brief Returns oldest work, if any; the intrusive list and every queue hold their oldest work at the front
+   */
+  choice oldest()
+  {
+    choice c;
+    auto enqueued = clock_type::time_point::max();
+    if (intrusive_head_ != nullptr)
+    {
+      c = choice{intrusive_head_, nullptr, true};
+      enqueued = intrusive_head_->enqueued;
+    }
+    if (!global_.empty() && global_.front().enqueued < enqueued)
+    {
+      c = choice{nullptr, &global_, true};
+      enqueued = global_.front().enqueued;
+    }
+    for (auto& local : local_)
+    {
+      if (!local.empty() && local.front().enqueued < enqueued)
+      {
+        c = choice{nullptr, &local, true};
+        enqueued = local.front().enqueued;
+      }
+    }
+    return c;
+  }
+
+  /**
+   * @brief Selects work to run next, if any
+   */
+  choice choose([[maybe_unused]] clock_type::time_point now)
+  {
+    if constexpr (kMaxWait && kOrder != queue_order::fifo)
+    {
+      // Serve oldest work first once it has waited too long
+      if (const choice c = oldest(); c.empty() || now - c.enqueued() > max_wait_)
+      {
+        return c;
+      }
+    }
+
+    if constexpr (kOrder == queue_order::fifo)
+    {
+      // Only the heads of the intrusive list and the global queue are compared, since there are no worker stacks
+      return oldest();
+    }
+    else if constexpr (kLocal)
+    {
+      // Own newest work, then oldest global work, then oldest work of other workers
+      if (entry_queue* const local = local_queue(); local != nullptr && !local->empty())
+      {
+        return choice{nullptr, local, false};
+      }
+      if (intrusive_head_ != nullptr && (global_.empty() || intrusive_head_->enqueued <= global_.front().enqueued))
+      {
+        return choice{intrusive_head_, nullptr, true};
+      }
+      if (!global_.empty())
+      {
+        return choice{nullptr, &global_, true};
+      }
+      return oldest();
+    }
+    else
+    {
+      // Newer of the next task node and the newest type-erased work; task nodes win ties, since they belong to
+      // dispatches which are blocked on them
+      if (intrusive_head_ != nullptr && (global_.empty() || intrusive_head_->enqueued >= global_.back().enqueued))
+      {
+        return choice{intrusive_head_, nullptr, true};
+      }
+      if (!global_.empty())
+      {
+        return choice{nullptr, &global_, false};
+      }
+      return choice{};
+    }
+  }
+
+  /// Mutex which synchronizes all other members between threads of execution
+  mutable std::mutex work_queue_mtx_;
+
+  /// Queue of work submitted by all threads; only by non-workers with queue_order::lifo_local_fifo_global
+  entry_queue global_;
+
+  /// Queue of work submitted by each worker, with queue_order::lifo_local_fifo_global
+  std::vector<entry_queue> local_;
+
+  /// First node of intrusive queue of work, owned by submitters
+  task_node* intrusive_head_ = nullptr;
+
+  /// Last node of intrusive queue of work
+  task_node* intrusive_tail_ = nullptr;
+
+  /// Conditional variable used to notify about new work
+  std::condition_variable work_queue_cv_;
+
+  /// How long work may wait before it is served ahead of all newer work, with <code>kMaxWait</code>
+  std::chrono::nanoseconds max_wait_ = kDefaultMaxWait;
+
+  /// Time which work waited before it started running
+  histogram age_;
+
+  /// Number of queued work
+  std::size_t depth_ = 0;
+
+  /// Work submitted, and contention between submitters
+  submit_counters counters_;
+
+  /// Flag used to indicate that queue is still active
+  bool is_working_ = true;
+};
+
+/**
+ * @brief Queue policy of thread_pool which selects locked_queue; the default
+ *
+ * @tparam kOrder  order in which work is served
+ * @tparam kMaxWait  if <code>true</code>, bounds how long work may wait before it is served ahead of newer work; see
+ *                   thread_pool::set_max_queue_wait(). On by default, except with queue_order::lifo_local_fifo_global
+ */
+template <
+  queue_order kOrder = queue_order::lifo,
+  bool kMaxWait = (kOrder != queue_order::lifo_local_fifo_global)>
+struct locked_queue_policy
+{
+  template <typename FuncWrapperT, typename FuncWrapperAllocatorT>
+  using queue_type = locked_queue<FuncWrapperT, FuncWrapperAllocatorT, kOrder, kMaxWait>;
+};
+
+}  // namespace zen::exec
@@ -0,0 +1,490 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/executor/pool_metrics.hpp>
+#include <zen/executor/task_node.hpp>
+#include <zen/utility/histogram.hpp>
+#include <zen/utility/trace.hpp>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Bounded lock-free multi-producer, multi-consumer work queue
+ *
+ * Ring buffer of <code>kCapacity</code> cells, each tagged with a sequence number which tells producers and consumers
+ * whether it is free or holds work, after Dmitry Vyukov's bounded MPMC queue. Pushing and popping each take a single
+ * compare-and-swap when uncontended. Task nodes are stored by pointer, without allocating or copying. Work is served
+ * strictly oldest first.
+ *
+ * Idle workers park on a condition variable; producers only take its mutex when a worker is parked. When the ring is
+ * full, work spills into an overflow list guarded by a mutex, and later work follows it there until workers have
+ * drained it, so that work is still served oldest first. Producers never block on workers, nor run work themselves,
+ * unless <code>kRunInlineWhenFull</code> asks for work to run on the submitting thread instead, as back-pressure.
+ *
+ * @tparam FuncWrapperT  type-erased work type
+ * @tparam FuncWrapperAllocatorT  allocator of type-erased work
+ * @tparam kCapacity  number of cells in the ring; must be a power of two
+ * @tparam kRunInlineWhenFull  runs work on the submitting thread when the ring is full, rather than spilling it
+ */
+template <typename FuncWrapperT, typename FuncWrapperAllocatorT, std::size_t kCapacity, bool kRunInlineWhenFull = false>
+class mpmc_queue
+{
+  static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0, "'kCapacity' must be a power of two");
+
+  /**
+   * @brief Ring buffer cell
+   */
+  struct cell
+  {
+    /// Position of the push which may fill this cell, or one past the position of the push which has filled it
+    std::atomic<std::size_t> sequence;
+
+    /// Task node held by this cell, if any
+    task_node* node;
+
+    /// Type-erased work held by this cell, if it does not hold a task node
+    std::optional<FuncWrapperT> fn;
+
+    /// Time at which work was enqueued
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  using cell_allocator_type = typename std::allocator_traits<FuncWrapperAllocatorT>::template rebind_alloc<cell>;
+
+  /**
+   * @brief Work which did not fit in the ring
+   */
+  struct spilled
+  {
+    /// Task node, if any
+    task_node* node;
+
+    /// Type-erased work, if there is no task node
+    std::optional<FuncWrapperT> fn;
+
+    /// Time at which work was enqueued
+    std::chrono::steady_clock::time_point enqueued;
+  };
+
+  using spilled_allocator_type =
+    typename std::allocator_traits<FuncWrapperAllocatorT>::template rebind_alloc<spilled>;
+
+public:
+  /**
+   * @param worker_count  number of workers which will attach() to this queue; unused
+   */
+  explicit mpmc_queue(std::size_t worker_count = 0) : cells_(kCapacity)
+  {
+    for (std::size_t i = 0; i < kCapacity; ++i)
+    {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Identifies calling thread as worker <code>index</code> of this queue; all workers are served alike
+   */
+  constexpr void attach(std::size_t index) {}
+
+  /**
+   * @brief Enqueues work; spills it into the overflow list, or runs it on the calling thread if
+   *        <code>kRunInlineWhenFull</code>, if the ring is full
+   */
+  template <typename FnT> void push(FnT&& fn)
+  {
+    if (overflowing() || !try_push([&fn](cell& c) {
+          c.node = nullptr;
+          c.fn.emplace(std::forward<FnT>(fn));
+        }))
+    {
+      if constexpr (kRunInlineWhenFull)
+      {
+        std::forward<FnT>(fn)();
+        return;
+      }
+      else
+      {
+        spill(spilled{nullptr, FuncWrapperT{std::forward<FnT>(fn)}, std::chrono::steady_clock::now()});
+      }
+    }
+    counters_.submitted.fetch_add(1, std::memory_order_relaxed);
+    wake();
+  }
+
+  /**
+   * @brief Enqueues work which invokes <code>fn(i)</code>, for each <code>i</code> in <code>[0, n)</code>
+   */
+  template <typename FnT> void push_bulk(std::size_t n, FnT& fn)
+  {
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      push([&fn, i] { fn(i); });
+    }
+  }
+
+  /**
+   * @brief Enqueues each node of the chain <code>[first, last]</code>, without allocating or copying
+   */
+  void push_intrusive(task_node& first, task_node& last)
+  {
+    task_node* node = &first;
+    while (true)
+    {
+      task_node* const next = (node == &last) ? nullptr : node->next;
+      if (!overflowing() && try_push([node](cell& c) {
+            c.node = node;
+            c.fn.reset();
+          }))
+      {
+        counters_.submitted.fetch_add(1, std::memory_order_relaxed);
+        wake();
+      }
+      else if constexpr (kRunInlineWhenFull)
+      {
+        node->run(*node);
+      }
+      else
+      {
+        spill(spilled{node, std::nullopt, std::chrono::steady_clock::now()});
+        counters_.submitted.fetch_add(1, std::memory_order_relaxed);
+        wake();
+      }
+
+      if (next == nullptr)
+      {
+        return;
+      }
+      node = next;
+    }
+  }
+
+  /**
+   * @brief Waits for work and runs it
+   *
+   * @param counters  counters of the calling worker
+   *
+   * @retval true  if work was run
+   * @retval false  if the queue was stopped
+   */
+  bool run_next(worker_counters& counters)
+  {
+    const auto waiting = std::chrono::steady_clock::now();
+    while (working_.load(std::memory_order_acquire))
+    {
+      if (try_run_one(counters, waiting) || try_run_spilled(counters, waiting))
+      {
+        return true;
+      }
+      park();
+    }
+    return false;
+  }
+
+  /**
+   * @brief Returns histogram of how long work waited in this queue before it started running
+   */
+  [[nodiscard]] const histogram& age() const { return age_; }
+
+  /**
+   * @brief Returns the number of queued work, as last seen by this thread
+   */
+  [[nodiscard]] std::size_t depth() const
+  {
+    const std::size_t dequeued = dequeue_pos_.load(std::memory_order_relaxed);
+    const std::size_t enqueued = enqueue_pos_.load(std::memory_order_relaxed);
+    return ((enqueued > dequeued) ? (enqueued - dequeued) : 0) + spilled_count_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns counters of work submitted to this queue; work which ran on its submitter is not counted
+   */
+  [[nodiscard]] const submit_counters& counters() const { return counters_; }
+
+  /**
+   * @brief Wakes all parked workers, and makes run_next() return <code>false</code> once they are idle
+   */
+  void stop()
+  {
+    working_.store(false, std::memory_order_release);
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    std::lock_guard lock{park_mtx_};
+    park_cv_.notify_all();
+  }
+
+private:
+  /**
+   * @brief Claims the next free cell, and fills it with <code>write(cell)</code>
+   *
+   * Races for a cell which are lost to other producers are counted as contention.
+   *
+   * @retval true  if the cell was filled
+   * @retval false  if the ring is full
+   */
+  template <typename WriteT> bool try_push(WriteT&& write)
+  {
+    std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell& c = cells_[pos & kMask];
+      const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+      if (diff == 0)
+      {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          write(c);
+          c.enqueued = std::chrono::steady_clock::now();
+          c.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+        counters_.contended.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        counters_.contended.fetch_add(1, std::memory_order_relaxed);
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Pops and runs next work, if any
+   *
+   * Races for work which are lost to other workers are counted as contention.
+   *
+   * @param counters  counters of the calling worker
+   * @param waiting  time at which the calling worker started waiting for work
+   *
+   * @retval true  if work was run
+   * @retval false  if the queue is empty
+   */
+  bool try_run_one(worker_counters& counters, std::chrono::steady_clock::time_point waiting)
+  {
+    std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    while (true)
+    {
+      cell& c = cells_[pos & kMask];
+      const std::size_t seq = c.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+      if (diff == 0)
+      {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          // Take work out of the cell, and release the cell, before running it
+          task_node* const node = c.node;
+          std::optional<FuncWrapperT> work;
+          if (node == nullptr)
+          {
+            work.emplace(std::move(*c.fn));
+            c.fn.reset();
+          }
+          const auto enqueued = c.enqueued;
+          c.sequence.store(pos + kCapacity, std::memory_order_release);
+          run(counters, waiting, node, work, enqueued);
+          return true;
+        }
+        counters.contended.fetch_add(1, std::memory_order_relaxed);
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        counters.contended.fetch_add(1, std::memory_order_relaxed);
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * @brief Pops and runs the oldest work of the overflow list, if any
+   *
+   * @param counters  counters of the calling worker
+   * @param waiting  time at which the calling worker started waiting for work
+   *
+   * @retval true  if work was run
+   * @retval false  if the overflow list is empty
+   */
+  bool try_run_spilled(worker_counters& counters, std::chrono::steady_clock::time_point waiting)
+  {
+    if (spilled_count_.load(std::memory_order_acquire) == 0)
+    {
+      return false;
+    }
+
+    std::optional<spilled> next;
+    {
+      const auto lock = detail::lock_counting_contention(spilled_mtx_, counters.contended);
+      if (spilled_.empty())
+      {
+        return false;
+      }
+      next.emplace(std::move(spilled_.front()));
+      spilled_.pop_front();
+      spilled_count_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+    run(counters, waiting, next->node, next->fn, next->enqueued);
+    return true;
+  }
+
+  /**
+   * @brief Runs work taken out of the queue, and accounts for it
+   *
+   * @param counters  counters of the calling worker
+   * @param waiting  time at which the calling worker started waiting for work
+   * @param node  task node to run, if any
+   * @param work  type-erased work to run, if there is no task node
+   * @param enqueued  time at which work was enqueued
+   */
+  void run(
+    worker_counters& counters,
+    std::chrono::steady_clock::time_point waiting,
+    task_node* node,
+    std::optional<FuncWrapperT>& work,
+    std::chrono::steady_clock::time_point enqueued)
+  {
+    const auto now = std::chrono::steady_clock::now();
+    age_.record(now - enqueued);
+    counters.idle(now - waiting);
+    ZEN_TRACE_COMPLETE("queue_wait", "queue", enqueued, now);
+
+    {
+      ZEN_TRACE_SPAN("task", "queue");
+      if (node == nullptr)
+      {
+        (*work)();
+      }
+      else
+      {
+        node->run(*node);
+      }
+    }
+    counters.ran(std::chrono::steady_clock::now() - now);
+  }
+
+  /**
+   * @brief Returns <code>true</code> while work waits in the overflow list, which later work must queue behind
+   */
+  [[nodiscard]] bool overflowing() const
+  {
+    return !kRunInlineWhenFull && spilled_count_.load(std::memory_order_acquire) > 0;
+  }
+
+  /**
+   * @brief Appends work which did not fit in the ring to the overflow list
+   */
+  void spill(spilled&& s)
+  {
+    const auto lock = detail::lock_counting_contention(spilled_mtx_, counters_.contended);
+    spilled_.push_back(std::move(s));
+    spilled_count_.fetch_add(1, std::memory_order_seq_cst);
+  }
+
+  /**
+   * @brief Blocks calling worker until new work may have been pushed, or the queue is stopped
+   */
+  void park()
+  {
+    const std::size_t epoch = epoch_.load(std::memory_order_seq_cst);
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+
+    // Work pushed before the epoch was read is visible here; work pushed after it changes the epoch
+    if (enqueue_pos_.load(std::memory_order_seq_cst) == dequeue_pos_.load(std::memory_order_seq_cst) &&
+        spilled_count_.load(std::memory_order_seq_cst) == 0)
+    {
+      std::unique_lock lock{park_mtx_};
+      park_cv_.wait(lock, [this, epoch] {
+        return epoch_.load(std::memory_order_seq_cst) != epoch || !working_.load(std::memory_order_acquire);
+      });
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Wakes one parked worker, if any, after work was pushed
+   */
+  void wake()
+  {
+    epoch_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) > 0)
+    {
+      std::lock_guard lock{park_mtx_};
+      park_cv_.notify_one();
+    }
+  }
+
+  static constexpr std::size_t kMask = kCapacity - 1;
+
+  /// Ring buffer cells
+  std::vector<cell, cell_allocator_type> cells_;
+
+  /// Position of the next push
+  alignas(kCacheLineSize) std::atomic<std::size_t> enqueue_pos_{0};
+
+  /// Position of the next pop
+  alignas(kCacheLineSize) std::atomic<std::size_t> dequeue_pos_{0};
+
+  /// Incremented whenever work is pushed, so that workers about to park can tell that they missed it
+  alignas(kCacheLineSize) std::atomic<std::size_t> epoch_{0};
+
+  /// Number of parked, or parking, workers
+  std::atomic<std::size_t> sleepers_{0};
+
+  /// Flag used to indicate that queue is still active
+  std::atomic<bool> working_{true};
+
+  /// Time which work waited before it started running
+  histogram age_;
+
+  /// Work submitted, and races between submitters
+  submit_counters counters_;
+
+  /// Work which did not fit in the ring, oldest first
+  std::deque<spilled, spilled_allocator_type> spilled_;
+
+  /// Number of work in spilled_, read without locking
+  alignas(kCacheLineSize) std::atomic<std::size_t> spilled_count_{0};
+
+  /// Mutex which guards spilled_
+  std::mutex spilled_mtx_;
+
+  /// Mutex which parked workers wait under
+  std::mutex park_mtx_;
+
+  /// Conditional variable which parked workers wait on
+  std::condition_variable park_cv_;
+};
+
+/**
+ * @brief Queue policy of thread_pool which selects mpmc_queue
+ *
+ * @tparam kCapacity  number of cells in the ring; must be a power of two
+ * @tparam kRunInlineWhenFull  runs work on the submitting thread when the ring is full, rather than spilling it into
+ *                             an overflow list; off by default, since callers such as event loops must never block
+ */
+template <std::size_t kCapacity = 1024, bool kRunInlineWhenFull = false> struct mpmc_queue_policy
+{
+  template <typename FuncWrapperT, typename FuncWrapperAllocatorT>
+  using queue_type = mpmc_queue<FuncWrapperT, FuncWrapperAllocatorT, kCapacity, kRunInlineWhenFull>;
+};
+
+}  // namespace zen::exec
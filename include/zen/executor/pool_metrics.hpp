@@ -0,0 +1,235 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/utility/histogram.hpp>
+
+namespace zen::exec
+{
+
+/// Size of the cache line which counters written by different threads are padded to
+static constexpr std::size_t kCacheLineSize = 64;
+
+/**
+ * @brief Counters written by a single worker of a thread_pool
+ *
+ * Padded to a cache line, and updated with relaxed atomics, so that workers never share a written cache line.
+ */
+struct alignas(kCacheLineSize) worker_counters
+{
+  /// Work run by this worker
+  std::atomic<std::uint64_t> completed{0};
+
+  /// Time spent running work, in nanoseconds
+  std::atomic<std::int64_t> busy_ns{0};
+
+  /// Time spent waiting for work, in nanoseconds
+  std::atomic<std::int64_t> idle_ns{0};
+
+  /// Times this worker found the work queue locked, or lost a race for work, when taking work
+  std::atomic<std::uint64_t> contended{0};
+
+  /// Work taken from queues of other workers
+  std::atomic<std::uint64_t> steals{0};
+
+  /// Time which work ran for
+  histogram run;
+
+  /**
+   * @brief Accounts for time spent waiting for work
+   */
+  void idle(std::chrono::nanoseconds duration) { idle_ns.fetch_add(duration.count(), std::memory_order_relaxed); }
+
+  /**
+   * @brief Accounts for work which ran for <code>duration</code>
+   */
+  void ran(std::chrono::nanoseconds duration)
+  {
+    completed.fetch_add(1, std::memory_order_relaxed);
+    busy_ns.fetch_add(duration.count(), std::memory_order_relaxed);
+    run.record(duration);
+  }
+};
+
+/**
+ * @brief Counters written by threads which submit work to a thread_pool
+ */
+struct alignas(kCacheLineSize) submit_counters
+{
+  /// Work queued
+  std::atomic<std::uint64_t> submitted{0};
+
+  /// Times a submitter found the work queue locked, or lost a race for a free slot
+  std::atomic<std::uint64_t> contended{0};
+};
+
+/**
+ * @brief Snapshot of the counters of a single worker
+ */
+struct worker_metrics
+{
+  std::uint64_t completed = 0;
+  std::chrono::nanoseconds busy{0};
+  std::chrono::nanoseconds idle{0};
+  std::uint64_t contended = 0;
+  std::uint64_t steals = 0;
+
+  /**
+   * @brief Returns the fraction of time spent running work, rather than waiting for it
+   */
+  [[nodiscard]] double utilization() const
+  {
+    const auto total = busy + idle;
+    return (total.count() == 0) ? 0.0 : static_cast<double>(busy.count()) / static_cast<double>(total.count());
+  }
+};
+
+/**
+ * @brief Snapshot of the runtime metrics of a thread_pool
+ *
+ * Counters are read one at a time while work may be running, so they need not be exactly consistent with each other.
+ */
+struct pool_metrics
+{
+  /// Work which is queued
+  std::size_t depth = 0;
+
+  /// Work queued so far
+  std::uint64_t submitted = 0;
+
+  /// Work run by workers so far
+  std::uint64_t completed = 0;
+
+  /// Times the work queue was found locked, or a race for it was lost, by submitters and workers
+  std::uint64_t contended = 0;
+
+  /// Work taken by workers from queues of other workers
+  std::uint64_t steals = 0;
+
+  /// Time which work waited in queue before it started running
+  histogram_summary wait;
+
+  /// Time which work ran for
+  histogram_summary run;
+
+  /// Snapshot of each worker
+  std::vector<worker_metrics> workers;
+};
+
+/**
+ * @brief <code>std::ostream</code> overload for pool_metrics
+ */
+inline std::ostream& operator<<(std::ostream& os, const pool_metrics& m)
+{
+  os << "depth=" << m.depth << " submitted=" << m.submitted << " completed=" << m.completed
+     << " contended=" << m.contended << " steals=" << m.steals << "\nwait: " << m.wait << "\nrun: " << m.run;
+  for (std::size_t i = 0; i < m.workers.size(); ++i)
+  {
+    const auto& w = m.workers[i];
+    os << "\nworker " << i << ": completed=" << w.completed << " utilization=" << w.utilization()
+       << " contended=" << w.contended << " steals=" << w.steals;
+  }
+  return os;
+}
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Locks <code>mtx</code>, counting the lock as contended if another thread holds it
+ */
+template <typename MutexT>
+std::unique_lock<MutexT> lock_counting_contention(MutexT& mtx, std::atomic<std::uint64_t>& contended)
+{
+  std::unique_lock lock{mtx, std::try_to_lock};
+  if (!lock.owns_lock())
+  {
+    contended.fetch_add(1, std::memory_order_relaxed);
+    lock.lock();
+  }
+  return lock;
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Thread which periodically passes a snapshot of metrics to a callback, until destroyed
+ */
+class metrics_reporter
+{
+public:
+  /**
+   * @param period  time between reports
+   * @param snapshot  returns metrics to report
+   * @param callback  receives each report, on the reporter's own thread
+   */
+  metrics_reporter(
+    std::chrono::nanoseconds period,
+    std::function<pool_metrics()> snapshot,
+    std::function<void(const pool_metrics&)> callback) :
+      period_{period}, snapshot_{std::move(snapshot)}, callback_{std::move(callback)}, thread_{[this] { loop(); }}
+  {}
+
+  ~metrics_reporter()
+  {
+    {
+      std::lock_guard lock{mtx_};
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    thread_.join();
+  }
+
+  metrics_reporter(const metrics_reporter&) = delete;
+  metrics_reporter& operator=(const metrics_reporter&) = delete;
+
+private:
+  void loop()
+  {
+    std::unique_lock lock{mtx_};
+    while (!cv_.wait_for(lock, period_, [this] { return stopped_; }))
+    {
+      lock.unlock();
+      callback_(snapshot_());
+      lock.lock();
+    }
+  }
+
+  /// Time between reports
+  std::chrono::nanoseconds period_;
+
+  /// Returns metrics to report
+  std::function<pool_metrics()> snapshot_;
+
+  /// Receives each report
+  std::function<void(const pool_metrics&)> callback_;
+
+  /// Mutex which guards stopped_
+  std::mutex mtx_;
+
+  /// Conditional variable used to wake the reporter when it is stopped
+  std::condition_variable cv_;
+
+  /// Set when the reporter is destroyed
+  bool stopped_ = false;
+
+  /// Reporter thread; started last
+  std::thread thread_;
+};
+
+}  // namespace zen::exec
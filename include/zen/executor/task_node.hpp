@@ -0,0 +1,105 @@
+#pragma once
+
+// C++ Standard Library
+#include <chrono>
+#include <cstddef>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Node of an intrusive work queue
+ *
+ * Nodes are owned by whoever submits them, and are linked into an executor's queue without allocation or copying.
+ * A node must remain valid until its work has started running.
+ */
+struct task_node
+{
+  /// Next node in queue
+  task_node* next = nullptr;
+
+  /// Runs work of this node; must not touch the node once work has signalled its completion
+  void (*run)(task_node&) = nullptr;
+
+  /// Time at which this node was enqueued; set by the queue
+  std::chrono::steady_clock::time_point enqueued;
+};
+
+/**
+ * @brief Fixed-size batch of task nodes, which invoke <code>fn(i)</code> for each <code>i</code> in <code>[0, N)</code>
+ *
+ * Meant to be embedded in the frame of a dispatch which blocks until all of its work has completed.
+ *
+@verbatim
+  auto work = [&](const std::size_t i) { ... };
+  exec::task_batch<4, decltype(work)> batch{work};
+  tp.bulk_execute(batch);
+  // ... wait for all work to complete before batch goes out of scope
+@endverbatim
+ *
+ * @tparam N  number of invocations
+ * @tparam FnT  invocable type
+ */
+template <std::size_t N, typename FnT> class task_batch
+{
+public:
+  explicit task_batch(FnT& fn) : fn_{fn}
+  {
+    for (std::size_t i = 0; i < N; ++i)
+    {
+      nodes_[i].next = (i + 1 < N) ? &nodes_[i + 1] : nullptr;
+      nodes_[i].run = &invoke;
+      nodes_[i].batch = this;
+      nodes_[i].index = i;
+    }
+  }
+
+  task_batch(const task_batch&) = delete;
+  task_batch& operator=(const task_batch&) = delete;
+
+  /**
+   * @brief Returns first node, which is linked to all other nodes in order
+   */
+  [[nodiscard]] constexpr task_node& front() { return nodes_[0]; }
+
+  /**
+   * @brief Returns last node
+   */
+  [[nodiscard]] constexpr task_node& back() { return nodes_[N - 1]; }
+
+  /**
+   * @brief Returns invocable called by each node
+   */
+  [[nodiscard]] constexpr FnT& fn() const { return fn_; }
+
+  /**
+   * @brief Returns number of nodes
+   */
+  [[nodiscard]] static constexpr std::size_t size() { return N; }
+
+private:
+  static_assert(N > 0, "'task_batch' must hold at least one node");
+
+  /**
+   * @brief Node which invokes fn(index) of its batch
+   */
+  struct node : task_node
+  {
+    task_batch* batch;
+    std::size_t index;
+  };
+
+  static void invoke(task_node& n)
+  {
+    const auto& self = static_cast<const node&>(n);
+    self.batch->fn_(self.index);
+  }
+
+  /// Invocable called by each node
+  FnT& fn_;
+
+  /// Nodes of all invocations
+  node nodes_[N];
+};
+
+}  // namespace zen::exec
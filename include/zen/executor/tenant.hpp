@@ -0,0 +1,111 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Zen
+#include <zen/utility/histogram.hpp>
+
+namespace zen::exec
+{
+
+/// Tenant of work submitted outside of any tenant_scope
+static constexpr std::size_t kDefaultTenant = 0;
+
+/**
+ * @brief Scheduling parameters of a tenant of a shared executor
+ */
+struct tenant_config
+{
+  /// Share of worker time given to this tenant, relative to other tenants with queued work
+  std::size_t weight = 1;
+
+  /// Most work of this tenant which may run at once; nested work, which running work of the tenant submits, e.g.
+  /// branches of a nested dispatch, is neither capped nor counted, since the work which submitted it may wait on it
+  std::size_t max_concurrency = std::numeric_limits<std::size_t>::max();
+};
+
+/**
+ * @brief Live counters of work submitted by a tenant
+ *
+ * Updated with relaxed atomics, so they may be read while work is running.
+ */
+struct tenant_stats
+{
+  /// Work which is queued
+  std::atomic<std::size_t> depth{0};
+
+  /// Work which is running
+  std::atomic<std::size_t> running{0};
+
+  /// Work submitted so far
+  std::atomic<std::uint64_t> submitted{0};
+
+  /// Work completed so far
+  std::atomic<std::uint64_t> completed{0};
+
+  /// Time which work waited in queue before it started running
+  histogram wait;
+
+  /// Time which work ran for
+  histogram run;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+inline std::size_t& current_tenant() noexcept
+{
+  static thread_local std::size_t current = kDefaultTenant;
+  return current;
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Returns tenant of work submitted from this thread
+ */
+[[nodiscard]] inline std::size_t current_tenant() noexcept { return detail::current_tenant(); }
+
+/**
+ * @brief Makes a tenant current on this thread, until destroyed
+ *
+ * Work submitted while a tenant is current is queued and accounted for under that tenant by executors which schedule
+ * tenants fairly, such as a thread_pool with fair_queue_policy. Such executors also make the tenant current while its
+ * work runs, so that nested dispatches are accounted for under the same tenant.
+ *
+@verbatim
+  {
+    const exec::tenant_scope scope{request.tenant_id};
+    auto r = pass(request) | all(tp, decode, lookup);
+  }
+@endverbatim
+ */
+class tenant_scope
+{
+public:
+  /**
+   * @param tenant  identifier of the tenant to make current; any value, e.g. a hash of a customer id
+   */
+  explicit tenant_scope(std::size_t tenant) noexcept : previous_{detail::current_tenant()}
+  {
+    detail::current_tenant() = tenant;
+  }
+
+  ~tenant_scope() { detail::current_tenant() = previous_; }
+
+  tenant_scope(const tenant_scope&) = delete;
+  tenant_scope& operator=(const tenant_scope&) = delete;
+
+private:
+  /// Tenant which was current before this scope
+  std::size_t previous_;
+};
+
+}  // namespace zen::exec
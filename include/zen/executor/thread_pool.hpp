@@ -2,30 +2,49 @@
 
 // C++ Standard Library
 #include <atomic>
-#include <condition_variable>
+#include <chrono>
 #include <functional>
 #include <memory>
-#include <mutex>
+#include <optional>
 #include <thread>
 #include <utility>
-#include <vector>
 
 // Zen
 #include <zen/executor/executor.hpp>
+#include <zen/executor/fair_queue.hpp>
+#include <zen/executor/locked_queue.hpp>
+#include <zen/executor/mpmc_queue.hpp>
+#include <zen/executor/pool_metrics.hpp>
 #include <zen/utility/value_mem.hpp>
 
 namespace zen::exec
 {
 
+class thread_pool_handle;
+
 /**
  * @brief Thread pool with variable number of worker threads
+ *
+ * Submitting work never runs it on the submitting thread, nor waits for workers, so work may be submitted from threads
+ * which must not block, such as event loops. The one exception is opt-in: <code>mpmc_queue_policy<N, true></code>
+ * runs work on its submitter when the ring is full, as back-pressure.
+ *
+ * @tparam FuncWrapperT  type-erased work type
+ * @tparam FuncWrapperAllocatorT  allocator of type-erased work
+ * @tparam QueuePolicyT  selects the work queue shared by workers, and the order in which it serves work; one of
+ *                       locked_queue_policy, mpmc_queue_policy or fair_queue_policy
  */
-template <typename FuncWrapperT = std::function<void()>, typename FuncWrapperAllocatorT = std::allocator<FuncWrapperT>>
-class thread_pool final : public executor<thread_pool<FuncWrapperT, FuncWrapperAllocatorT>>
+template <
+  typename FuncWrapperT = std::function<void()>,
+  typename FuncWrapperAllocatorT = std::allocator<FuncWrapperT>,
+  typename QueuePolicyT = locked_queue_policy<>>
+class thread_pool final : public executor<thread_pool<FuncWrapperT, FuncWrapperAllocatorT, QueuePolicyT>>
 {
   using base = executor<thread_pool>;
   friend base;
 
+  using queue_type = typename QueuePolicyT::template queue_type<FuncWrapperT, FuncWrapperAllocatorT>;
+
   /**
    * @brief <code>std::thread</code> wrapper with deferred startup and join on destroy
    */
@@ -41,18 +60,29 @@ class thread_pool final : public executor<thread_pool<FuncWrapperT, FuncWrapperA
   };
 
 public:
+  /// Handle type passed to work dispatched on this pool
+  using handle_type = thread_pool_handle;
+
   /**
    * @brief Creates thread_pool with a fixed number of worker threads
    *
    * @param worker_count  number of worker threads; by default, set to the number of hardware cores
    */
   explicit thread_pool(std::size_t worker_count = std::thread::hardware_concurrency()) :
-      is_working_{true}, worker_count_{worker_count}, workers_{std::make_unique<deferred_thread_type[]>(worker_count_)}
+      work_queue_{worker_count},
+      worker_count_{worker_count},
+      worker_storage_{std::make_unique<worker_storage[]>(worker_count_)},
+      worker_counters_{std::make_unique<worker_counters[]>(worker_count_)},
+      workers_{std::make_unique<deferred_thread_type[]>(worker_count_)}
   {
     // Start thread workloops
     for (std::size_t i = 0; i < worker_count_; ++i)
     {
-      workers_[i].start([this] { work_loop(); });
+      workers_[i].start([this, i] {
+        worker_storage::set_current(&worker_storage_[i]);
+        work_queue_.attach(i);
+        work_loop(worker_counters_[i]);
+      });
     }
   }
 
@@ -61,10 +91,11 @@ public:
    */
   ~thread_pool()
   {
+    // Stop reporting before workers, so that reports never see a stopped pool
+    reporter_.reset();
+
     // Stop workers
-    std::lock_guard lock{work_queue_mtx_};
-    is_working_ = false;
-    work_queue_cv_.notify_all();
+    work_queue_.stop();
   }
 
   /**
@@ -72,64 +103,115 @@ public:
    */
   [[nodiscard]] constexpr std::size_t workers() const { return worker_count_; }
 
+  /**
+   * @brief Returns histogram of how long work waited in queue before it started running
+   */
+  [[nodiscard]] const histogram& queue_age() const { return work_queue_.age(); }
+
+  /**
+   * @brief Sets how long work may wait before it is served ahead of all newer work; only locked queues whose policy
+   *        enables the bound, as it does by default, except with queue_order::lifo_local_fifo_global
+   */
+  void set_max_queue_wait(std::chrono::nanoseconds max_wait) { work_queue_.set_max_wait(max_wait); }
+
+  /**
+   * @brief Sets weight and concurrency cap of a tenant; fair queues only
+   */
+  void configure_tenant(std::size_t id, const tenant_config& config) { work_queue_.configure(id, config); }
+
+  /**
+   * @brief Returns live queue depth, concurrency and latency counters of a tenant; fair queues only
+   */
+  [[nodiscard]] const tenant_stats& tenant(std::size_t id) { return work_queue_.stats(id); }
+
+  /**
+   * @brief Returns a snapshot of queue depth, throughput, latency, contention and per-worker utilization
+   *
+   * Reading metrics never blocks workers; only queue depth is read under the queue lock, where there is one.
+   */
+  [[nodiscard]] pool_metrics metrics() const
+  {
+    pool_metrics m;
+    m.depth = work_queue_.depth();
+    m.submitted = work_queue_.counters().submitted.load(std::memory_order_relaxed);
+    m.contended = work_queue_.counters().contended.load(std::memory_order_relaxed);
+    m.wait = work_queue_.age().summary();
+
+    histogram run;
+    m.workers.reserve(worker_count_);
+    for (std::size_t i = 0; i < worker_count_; ++i)
+    {
+      const worker_counters& c = worker_counters_[i];
+      worker_metrics& w = m.workers.emplace_back();
+      w.completed = c.completed.load(std::memory_order_relaxed);
+      w.busy = std::chrono::nanoseconds{c.busy_ns.load(std::memory_order_relaxed)};
+      w.idle = std::chrono::nanoseconds{c.idle_ns.load(std::memory_order_relaxed)};
+      w.contended = c.contended.load(std::memory_order_relaxed);
+      w.steals = c.steals.load(std::memory_order_relaxed);
+      run.merge(c.run);
+
+      m.completed += w.completed;
+      m.contended += w.contended;
+      m.steals += w.steals;
+    }
+    m.run = run.summary();
+    return m;
+  }
+
+  /**
+   * @brief Calls <code>callback(metrics())</code> every <code>period</code>, on a thread of its own, until the pool
+   *        is destroyed or this is called again
+   */
+  void on_metrics(std::chrono::nanoseconds period, std::function<void(const pool_metrics&)> callback)
+  {
+    reporter_.reset();
+    reporter_.emplace(period, [this] { return metrics(); }, std::move(callback));
+  }
+
 private:
   /**
    * @brief Work-enqueue implementation
    */
-  template <typename FnT> constexpr void execute_impl(FnT&& fn)
-  {
-    std::lock_guard lock{work_queue_mtx_};
-    work_queue_.emplace_back(std::forward<FnT>(fn));
-    work_queue_cv_.notify_one();
-  };
+  template <typename FnT> constexpr void execute_impl(FnT&& fn) { work_queue_.push(std::forward<FnT>(fn)); };
+
+  /**
+   * @brief Bulk work-enqueue implementation; the locked queue enqueues all work under a single lock
+   */
+  template <typename FnT> void bulk_execute_impl(std::size_t n, FnT& fn) { work_queue_.push_bulk(n, fn); }
+
+  /**
+   * @brief Intrusive work-enqueue implementation; links the chain of nodes <code>[first, last]</code> into the work
+   *        queue, without allocating or copying
+   */
+  void execute_intrusive_impl(task_node& first, task_node& last) { work_queue_.push_intrusive(first, last); }
 
   /**
    * @brief Executes any new work
    */
-  void work_loop()
+  void work_loop(worker_counters& counters)
   {
-    std::unique_lock lock{work_queue_mtx_};
-    while (is_working_)
+    while (work_queue_.run_next(counters))
     {
-      if (work_queue_.empty())
-      {
-        work_queue_cv_.wait(lock);
-      }
-      else
-      {
-        // Grab next work under lock and remove from queue
-        auto work = std::move(work_queue_.back());
-        work_queue_.pop_back();
-
-        // Unlock before executing work to allow new work to be
-        // enqueue during work execution
-        lock.unlock();
-        {
-          // Do the work
-          work();
-        }
-        lock.lock();
-      }
     }
   }
 
-  /// Mutex which synchronizes work_queue_ and is_working_ between threads of execution
-  std::mutex work_queue_mtx_;
-
   /// Queue of work to execute
-  std::vector<FuncWrapperT, FuncWrapperAllocatorT> work_queue_;
-
-  /// Conditional variable used to notify about new work
-  std::condition_variable work_queue_cv_;
-
-  /// Flag used to indicate that pool is still active
-  bool is_working_;
+  queue_type work_queue_;
 
   /// Number of active workers
   std::size_t worker_count_;
 
+  /// Storage local to each worker; outlives worker threads
+  std::unique_ptr<worker_storage[]> worker_storage_;
+
+  /// Counters written by each worker; outlive worker threads
+  std::unique_ptr<worker_counters[]> worker_counters_;
+
   /// Worker threads
   std::unique_ptr<deferred_thread_type[]> workers_;
+
+  /// Thread which reports metrics periodically, if any
+  std::optional<metrics_reporter> reporter_;
 };
 
 /**
@@ -0,0 +1,100 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace zen::exec
+{
+
+/**
+ * @brief Storage of objects which persist across work run on the same worker thread
+ *
+ * Holds at most one object of each type, default-constructed the first time it is requested. Each thread uses its own
+ * storage, so objects are never shared between concurrently running work.
+ */
+class worker_storage
+{
+public:
+  worker_storage() = default;
+
+  worker_storage(const worker_storage&) = delete;
+  worker_storage& operator=(const worker_storage&) = delete;
+
+  /**
+   * @brief Returns object of type <code>T</code>, creating it if it does not exist
+   */
+  template <typename T> T& get()
+  {
+    const std::size_t index = slot_index<T>();
+    if (index >= slots_.size())
+    {
+      slots_.resize(index + 1);
+    }
+
+    auto& slot = slots_[index];
+    if (slot == nullptr)
+    {
+      slot = slot_type{new T{}, slot_deleter{[](void* ptr) { delete static_cast<T*>(ptr); }}};
+    }
+    return *static_cast<T*>(slot.get());
+  }
+
+  /**
+   * @brief Returns storage of the calling thread
+   *
+   * This is the storage of a thread_pool worker, when called from one; otherwise, storage owned by the calling thread.
+   */
+  [[nodiscard]] static worker_storage& current()
+  {
+    if (worker_storage* const storage = current_ptr(); storage != nullptr)
+    {
+      return *storage;
+    }
+    static thread_local worker_storage fallback;
+    return fallback;
+  }
+
+  /**
+   * @brief Makes <code>storage</code> the storage of the calling thread; used by executors which own worker threads
+   */
+  static void set_current(worker_storage* storage) { current_ptr() = storage; }
+
+private:
+  /**
+   * @brief Destroys an object whose type has been erased
+   */
+  struct slot_deleter
+  {
+    void (*destroy)(void*) = nullptr;
+
+    void operator()(void* ptr) const { destroy(ptr); }
+  };
+
+  using slot_type = std::unique_ptr<void, slot_deleter>;
+
+  template <typename T> static std::size_t slot_index()
+  {
+    static const std::size_t index = next_slot_index().fetch_add(1, std::memory_order_relaxed);
+    return index;
+  }
+
+  static std::atomic<std::size_t>& next_slot_index()
+  {
+    static std::atomic<std::size_t> next{0};
+    return next;
+  }
+
+  static worker_storage*& current_ptr()
+  {
+    static thread_local worker_storage* current = nullptr;
+    return current;
+  }
+
+  /// Objects, indexed by type
+  std::vector<slot_type> slots_;
+};
+
+}  // namespace zen::exec
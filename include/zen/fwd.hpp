@@ -1,6 +1,7 @@
 #pragma once
 
 // C++ Standard Library
+#include <cstddef>
 #include <utility>
 
 namespace zen
@@ -9,6 +10,7 @@ namespace zen
 template <typename T> class result;
 template <typename... Ts> class any_dispatch;
 template <typename... Ts> class all_dispatch;
+template <std::size_t I> struct move_into_t;
 
 }  // namespace zen
 
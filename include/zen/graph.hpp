@@ -0,0 +1,4 @@
+#pragma once
+
+// Zen
+#include <zen/graph/graph.hpp>
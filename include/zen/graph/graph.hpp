@@ -0,0 +1,405 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/executor/executor.hpp>
+#include <zen/result.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Typed handle to a node in a <code>graph</code>, used to declare edges and to read node results
+ *
+ * @tparam T  value type of the result<T> produced by the node
+ */
+template <typename T> class graph_node
+{
+public:
+  using value_type = T;
+
+  /**
+   * @brief Returns index of the node within its graph
+   */
+  [[nodiscard]] constexpr std::size_t id() const { return id_; }
+
+private:
+  friend class graph;
+
+  explicit constexpr graph_node(std::size_t id) : id_{id} {}
+
+  std::size_t id_;
+};
+
+/**
+ * @brief Directed acyclic graph of invocables which return a result<T>, with edges carrying valid values
+ *
+ * Nodes are scheduled onto an executor as soon as all of their inputs are valid. When a node produces an invalid
+ * result, its downstream subgraph is pruned: those nodes are never invoked, and hold the invalid status which pruned
+ * them. Independent branches keep running.
+ * \n
+ * Node results, scheduling state and the task nodes which submit them are held in nodes which are allocated once, when
+ * the graph is built. Running a built graph again does not allocate on executors with an intrusive queue, such as
+ * exec::thread_pool. A graph may not be run concurrently with itself.
+@verbatim
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](int a) -> result<int> { return a + 1; }, a);
+  const auto c = g.add([](int a) -> result<int> { return a * 2; }, a);
+  const auto d = g.add([](int b, int c) -> result<int> { return b + c; }, b, c);
+
+  if (g.run(tp).valid())
+  {
+    std::cout << *g.get(d) << std::endl;  // 4
+  }
+@endverbatim
+ */
+class graph
+{
+public:
+  /// Sentinel id used to indicate "no node"
+  static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+  graph() = default;
+  graph(const graph&) = delete;
+  graph& operator=(const graph&) = delete;
+
+  /**
+   * @brief Adds a node which invokes <code>fn</code> with the values of <code>inputs...</code>
+   *
+   * @param fn  invocable, called with <code>const</code> references to input values
+   * @param inputs  upstream nodes; must already be part of this graph
+   *
+   * @return handle to the new node
+   */
+  template <typename InvocableT, typename... InputTs>
+  decltype(auto) add(InvocableT&& fn, const graph_node<InputTs>&... inputs)
+  {
+    using invocable_type = std::decay_t<InvocableT>;
+    using result_type = to_result_t<std::decay_t<std::invoke_result_t<invocable_type&, const InputTs&...>>>;
+    using node_type = node_impl<invocable_type, result_type, InputTs...>;
+    using value_type = std::remove_reference_t<decltype(*std::declval<const result_type&>())>;
+
+    const std::size_t id = nodes_.size();
+    nodes_.emplace_back(std::make_unique<node_type>(std::forward<InvocableT>(fn), std::make_tuple(&get(inputs)...)));
+    nodes_.back()->task.run = &run_task;
+    nodes_.back()->task.owner = this;
+    nodes_.back()->task.id = id;
+
+    // Connect edges
+    [[maybe_unused]] const auto unused = ((connect(inputs.id(), id), true) && ...);
+
+    return graph_node<value_type>{id};
+  }
+
+  /**
+   * @brief Runs all nodes on executor <code>e</code> and blocks until every node has completed or been pruned
+   *
+   * @return <code>Valid</code> status if all nodes produced valid results; otherwise, status of the first node which
+   *         failed
+   */
+  template <typename ExecutorT> result_status run(exec::executor<ExecutorT>& e)
+  {
+    // Reset scheduling state from previous runs
+    remaining_.store(nodes_.size(), std::memory_order_relaxed);
+    first_failure_.store(npos, std::memory_order_relaxed);
+    done_ = nodes_.empty();
+    for (auto& n : nodes_)
+    {
+      n->pending.store(n->dependencies.size(), std::memory_order_relaxed);
+      n->pruned.store(false, std::memory_order_relaxed);
+    }
+
+    executor_ = std::addressof(e);
+    execute_from_ = [](graph& g, std::size_t id) {
+      g.execute_from(*static_cast<exec::executor<ExecutorT>*>(g.executor_), id);
+    };
+
+    start_ = clock_type::now();
+
+    // Start from nodes which have no inputs, submitted together as one chain
+    node_task* first = nullptr;
+    node_task* last = nullptr;
+    for (auto& n : nodes_)
+    {
+      if (n->dependencies.empty())
+      {
+        if (last == nullptr)
+        {
+          first = &n->task;
+        }
+        else
+        {
+          last->next = &n->task;
+        }
+        last = &n->task;
+      }
+    }
+    if (first != nullptr)
+    {
+      e.execute_intrusive(*first, *last);
+    }
+
+    {
+      std::unique_lock lock{done_mtx_};
+      done_cv_.wait(lock, [this] { return done_; });
+    }
+
+    const std::size_t failed = first_failure_.load(std::memory_order_relaxed);
+    return (failed == npos) ? result_status{Valid} : nodes_[failed]->status();
+  }
+
+  /**
+   * @brief Returns result produced by <code>node</code> during the last run
+   */
+  template <typename T> [[nodiscard]] const result<T>& get(const graph_node<T>& node) const
+  {
+    return static_cast<const node_impl_output<result<T>>&>(*nodes_[node.id()]).output;
+  }
+
+  /**
+   * @brief Returns the number of nodes in the graph
+   */
+  [[nodiscard]] std::size_t size() const { return nodes_.size(); }
+
+  /**
+   * @brief Returns time spent invoking a node during the last run; zero if it was pruned
+   */
+  [[nodiscard]] std::chrono::nanoseconds duration(std::size_t id) const
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(nodes_[id]->stop - nodes_[id]->start);
+  }
+
+  /**
+   * @brief Returns ids of the nodes on the critical path of the last run, from source to sink
+   *
+   * The critical path ends at the node which finished last and follows, at each node, the input which finished last;
+   * that is, the chain of nodes which determined how long the run took.
+   */
+  [[nodiscard]] std::vector<std::size_t> critical_path() const
+  {
+    std::vector<std::size_t> path;
+    std::size_t id = latest(0, nodes_.size(), [](std::size_t i) { return i; });
+    while (id != npos)
+    {
+      path.push_back(id);
+      const auto& deps = nodes_[id]->dependencies;
+      id = latest(0, deps.size(), [&deps](std::size_t i) { return deps[i]; });
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+  }
+
+private:
+  using clock_type = std::chrono::steady_clock;
+
+  /**
+   * @brief Task node which executes a graph node, and continues with its dependents
+   */
+  struct node_task : exec::task_node
+  {
+    graph* owner = nullptr;
+    std::size_t id = npos;
+  };
+
+  /**
+   * @brief Type-erased node scheduling state
+   */
+  struct node_base
+  {
+    virtual ~node_base() = default;
+
+    /// Invokes node with values of its inputs
+    virtual void invoke() = 0;
+
+    /// Marks output invalid with <code>status</code>, without invoking node
+    virtual void prune(result_status status) = 0;
+
+    /// Returns status of node output
+    [[nodiscard]] virtual result_status status() const = 0;
+
+    /// Nodes which consume this node's output
+    std::vector<std::size_t> dependents;
+
+    /// Nodes whose output this node consumes
+    std::vector<std::size_t> dependencies;
+
+    /// Number of inputs which have not completed during the current run
+    std::atomic<std::size_t> pending{0};
+
+    /// Set when an upstream node has failed during the current run
+    std::atomic<bool> pruned{false};
+
+    /// Upstream failure which caused this node to be pruned
+    std::size_t pruned_by = npos;
+
+    /// Invocation timing during last run
+    clock_type::time_point start, stop;
+
+    /// Submitted once per run, when the node becomes ready; owned by the node, so that submitting does not allocate
+    node_task task;
+  };
+
+  /**
+   * @brief Node output storage, readable without knowing the node's invocable and input types
+   */
+  template <typename ResultT> struct node_impl_output : node_base
+  {
+    ResultT output;
+  };
+
+  template <typename InvocableT, typename ResultT, typename... InputTs>
+  struct node_impl final : node_impl_output<ResultT>
+  {
+    template <typename FnT>
+    node_impl(FnT&& _fn, std::tuple<const result<InputTs>*...> _inputs) :
+        fn{std::forward<FnT>(_fn)}, inputs{_inputs}
+    {}
+
+    void invoke() override
+    {
+      this->output = std::apply([this](const auto*... in) { return ResultT{fn(**in...)}; }, inputs);
+    }
+
+    void prune(result_status status) override { this->output = ResultT{std::move(status)}; }
+
+    [[nodiscard]] result_status status() const override { return this->output.status(); }
+
+    InvocableT fn;
+    std::tuple<const result<InputTs>*...> inputs;
+  };
+
+  void connect(std::size_t from, std::size_t to)
+  {
+    nodes_[from]->dependents.push_back(to);
+    nodes_[to]->dependencies.push_back(from);
+  }
+
+  /**
+   * @brief Executes node <code>id</code>, then continues with the first dependent which became ready on this
+   *        thread, enqueuing all other ready dependents
+   */
+  template <typename ExecutorT> void execute_from(exec::executor<ExecutorT>& e, std::size_t id)
+  {
+    while (id != npos)
+    {
+      auto& n = *nodes_[id];
+
+      bool valid = false;
+      if (n.pruned.load(std::memory_order_relaxed))
+      {
+        n.prune(nodes_[n.pruned_by]->status());
+        n.start = n.stop = start_;
+      }
+      else
+      {
+        n.start = clock_type::now();
+        n.invoke();
+        n.stop = clock_type::now();
+        valid = n.status().valid();
+        if (!valid)
+        {
+          std::size_t expected = npos;
+          first_failure_.compare_exchange_strong(expected, id, std::memory_order_relaxed);
+        }
+      }
+
+      std::size_t next = npos;
+      for (const std::size_t d : n.dependents)
+      {
+        auto& dependent = *nodes_[d];
+        if (!valid && !dependent.pruned.exchange(true, std::memory_order_relaxed))
+        {
+          dependent.pruned_by = n.pruned.load(std::memory_order_relaxed) ? n.pruned_by : id;
+        }
+
+        if (dependent.pending.fetch_sub(1, std::memory_order_acq_rel) > 1)
+        {
+          continue;
+        }
+        else if (next == npos)
+        {
+          next = d;
+        }
+        else
+        {
+          e.execute_intrusive(dependent.task, dependent.task);
+        }
+      }
+
+      // Completion is only published under the lock, so that run() can not return, and the graph can not be
+      // destroyed, before this thread is done with the lock and condition variable
+      if (remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+      {
+        std::lock_guard lock{done_mtx_};
+        done_ = true;
+        done_cv_.notify_all();
+      }
+
+      id = next;
+    }
+  }
+
+  /**
+   * @brief Runs the node of task node <code>t</code>, on the executor of the current run
+   */
+  static void run_task(exec::task_node& t)
+  {
+    auto& task = static_cast<node_task&>(t);
+    task.owner->execute_from_(*task.owner, task.id);
+  }
+
+  /**
+   * @brief Returns the id, among <code>to_id(first) ... to_id(last - 1)</code>, of the node which stopped last
+   */
+  template <typename ToIdT> std::size_t latest(std::size_t first, std::size_t last, ToIdT to_id) const
+  {
+    std::size_t selected = npos;
+    for (std::size_t i = first; i < last; ++i)
+    {
+      const std::size_t id = to_id(i);
+      if (selected == npos || nodes_[id]->stop > nodes_[selected]->stop)
+      {
+        selected = id;
+      }
+    }
+    return selected;
+  }
+
+  /// All nodes, in the order which they were added
+  std::vector<std::unique_ptr<node_base>> nodes_;
+
+  /// Number of nodes which have not completed during the current run
+  std::atomic<std::size_t> remaining_{0};
+
+  /// First node which produced an invalid result during the current run
+  std::atomic<std::size_t> first_failure_{npos};
+
+  /// Start time of the current run
+  clock_type::time_point start_;
+
+  /// Executor of the current run, type-erased, and the execute_from() instance which runs nodes on it
+  void* executor_ = nullptr;
+  void (*execute_from_)(graph&, std::size_t) = nullptr;
+
+  /// Synchronizes run completion
+  std::mutex done_mtx_;
+  std::condition_variable done_cv_;
+
+  /// Set, under done_mtx_, once every node has completed during the current run
+  bool done_ = false;
+};
+
+}  // namespace zen
@@ -2,6 +2,7 @@
 
 // Zen
 #include <zen/meta/append.hpp>
+#include <zen/meta/arguments.hpp>
 #include <zen/meta/first.hpp>
 #include <zen/meta/invocable.hpp>
 #include <zen/meta/is_specialization.hpp>
@@ -0,0 +1,65 @@
+#pragma once
+
+// C++ Standard Library
+#include <tuple>
+#include <type_traits>
+
+namespace zen::meta
+{
+
+/**
+ * @brief Isolates argument types of a function, or of an invocable with a single, non-template call operator, as a
+ *        <code>std::tuple</code>
+ *
+ * Has no <code>type</code> for generic or overloaded invocables, whose arguments can not be known up front.
+ */
+template <typename Fn, typename = void> struct arguments_of
+{};
+
+template <typename R, typename... ArgTs> struct arguments_of<R(ArgTs...)>
+{
+  using type = std::tuple<ArgTs...>;
+};
+
+template <typename R, typename... ArgTs> struct arguments_of<R(ArgTs...) noexcept> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename... ArgTs> struct arguments_of<R (*)(ArgTs...)> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename... ArgTs> struct arguments_of<R (*)(ArgTs...) noexcept> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename C, typename... ArgTs> struct arguments_of<R (C::*)(ArgTs...)> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename C, typename... ArgTs>
+struct arguments_of<R (C::*)(ArgTs...) const> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename C, typename... ArgTs>
+struct arguments_of<R (C::*)(ArgTs...) noexcept> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename R, typename C, typename... ArgTs>
+struct arguments_of<R (C::*)(ArgTs...) const noexcept> : arguments_of<R(ArgTs...)>
+{};
+
+template <typename Fn>
+struct arguments_of<Fn, std::void_t<decltype(&Fn::operator())>> : arguments_of<decltype(&Fn::operator())>
+{};
+
+template <typename Fn> using arguments_of_t = typename arguments_of<Fn>::type;
+
+/**
+ * @brief Checks if argument types of \c Fn are known; see arguments_of
+ */
+template <typename Fn, typename = void> struct has_arguments : std::false_type
+{};
+
+template <typename Fn> struct has_arguments<Fn, std::void_t<arguments_of_t<Fn>>> : std::true_type
+{};
+
+template <typename Fn> static constexpr bool has_arguments_v = has_arguments<Fn>::value;
+
+}  // namespace zen::meta
@@ -1,7 +1,8 @@
 #pragma once
 
 // C++ Standard Library
-#include <cstring>
+#include <array>
+#include <cstddef>
 #include <string_view>
 
 namespace zen::meta
@@ -9,6 +10,8 @@ namespace zen::meta
 
 /**
  * @brief Returns the full-qualified name of a type as a C-style string
+ *
+ * The name is copied out of the function signature at compile time, so this is safe to call from any thread.
  */
 template <typename T> const char* type_to_string()
 {
@@ -16,14 +19,16 @@ template <typename T> const char* type_to_string()
   static constexpr std::string_view SIGNATURE{__PRETTY_FUNCTION__};
   static constexpr std::string_view TOKEN{"T = "};
   static constexpr std::size_t OFFSET = SIGNATURE.find(TOKEN);
-  static char type_to_string_storage[SIGNATURE.size() - TOKEN.size() - OFFSET] = {'\0'};
-  if (type_to_string_storage[0] == '\0')
-  {
-    std::memcpy(
-      type_to_string_storage, SIGNATURE.data() + TOKEN.size() + OFFSET, SIGNATURE.size() - TOKEN.size() - OFFSET);
-    type_to_string_storage[SIGNATURE.size() - TOKEN.size() - OFFSET - 1] = '\0';
-  }
-  return type_to_string_storage;
+  static constexpr std::size_t SIZE = SIGNATURE.size() - TOKEN.size() - OFFSET;
+  static constexpr auto type_to_string_storage = [] {
+    std::array<char, SIZE> storage{};
+    for (std::size_t i = 0; i + 1 < SIZE; ++i)
+    {
+      storage[i] = SIGNATURE[TOKEN.size() + OFFSET + i];
+    }
+    return storage;
+  }();
+  return type_to_string_storage.data();
 #else  // __PRETTY_FUNCTION__
   return "type_to_string<T> unsupported";
 #endif  // __PRETTY_FUNCTION__
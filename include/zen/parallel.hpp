@@ -1,4 +1,6 @@
 #pragma once
 
 // Zen
-#include <zen/parallel/thread_pool_dispatch.hpp>
+#include <zen/parallel/executor_dispatch.hpp>
+#include <zen/parallel/hedge_dispatch.hpp>
+#include <zen/parallel/quorum_dispatch.hpp>
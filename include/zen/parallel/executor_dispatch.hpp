@@ -0,0 +1,435 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <future>
+#include <memory>
+#include <memory_resource>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor/executor.hpp>
+#include <zen/meta/type_to_string.hpp>
+#include <zen/utility/trace.hpp>
+
+namespace zen
+{
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Invokes <code>fn</code> with <code>values...</code>, passing <code>handle</code> first if <code>fn</code>
+ *        accepts it
+ */
+template <typename InvocableT, typename HandleT, typename... ValueTs>
+decltype(auto) dispatch_invoke(InvocableT& fn, HandleT& handle, ValueTs&&... values)
+{
+  ZEN_TRACE_SPAN([] { return meta::type_to_string<std::remove_cv_t<InvocableT>>(); }, "branch");
+  if constexpr (std::is_invocable_v<InvocableT&, HandleT&, ValueTs&&...>)
+  {
+    return fn(handle, std::forward<ValueTs>(values)...);
+  }
+  else
+  {
+    return fn(std::forward<ValueTs>(values)...);
+  }
+}
+
+/**
+ * @brief Result type of dispatching <code>InvocableT</code> with <code>ValueTs...</code>
+ */
+template <typename InvocableT, typename HandleT, typename... ValueTs>
+using dispatch_result_t = to_result_t<std::decay_t<decltype(
+  dispatch_invoke(std::declval<InvocableT&>(), std::declval<HandleT&>(), std::declval<ValueTs&&>()...))>>;
+
+/**
+ * @brief Returns <code>value</code> as passed to a parallel invocable: forwarded if the invocable owns the values,
+ *        otherwise as an immutable view shared with other invocables
+ */
+template <bool kOwns, typename ValueT> constexpr decltype(auto) branch_value(std::remove_reference_t<ValueT>& value)
+{
+  if constexpr (kOwns)
+  {
+    return std::forward<ValueT>(value);
+  }
+  else
+  {
+    return std::as_const(value);
+  }
+}
+
+/**
+ * @brief Type of a value of type <code>ValueT</code> as passed to a parallel invocable
+ */
+template <bool kOwns, typename ValueT>
+using branch_value_t = std::conditional_t<kOwns, ValueT&&, const std::remove_reference_t<ValueT>&>;
+
+/**
+ * @brief Result type of dispatching <code>InvocableT</code> with <code>ValueTs...</code>, as passed by branch_value
+ */
+template <bool kOwns, typename InvocableT, typename HandleT, typename... ValueTs>
+using branch_result_t = dispatch_result_t<InvocableT, HandleT, branch_value_t<kOwns, ValueTs>...>;
+
+/**
+ * @brief Selects handle for a dispatch on an executor with handle type <code>HandleT</code>
+ *
+ * When a dispatch is nested in another dispatch on the same kind of executor, it receives the outer dispatch's
+ * handle as its first value, and shares it. Otherwise, <code>fn</code> is called with a new handle.
+ */
+template <typename HandleT, typename FnT, typename FirstT, typename... ValueTs>
+decltype(auto) with_dispatch_handle(FnT&& fn, FirstT&& first, ValueTs&&... values)
+{
+  using first_type = std::decay_t<FirstT>;
+  if constexpr (std::is_same_v<first_type, HandleT>)
+  {
+    return fn(const_cast<HandleT&>(static_cast<const HandleT&>(first)), std::forward<ValueTs>(values)...);
+  }
+  else if constexpr (exec::is_executor_handle_v<first_type>)
+  {
+    HandleT handle;
+    return fn(handle, std::forward<ValueTs>(values)...);
+  }
+  else
+  {
+    HandleT handle;
+    return fn(handle, std::forward<FirstT>(first), std::forward<ValueTs>(values)...);
+  }
+}
+
+template <typename HandleT, typename FnT> decltype(auto) with_dispatch_handle(FnT&& fn)
+{
+  HandleT handle;
+  return fn(handle);
+}
+
+/**
+ * @brief Creates promise whose shared state is allocated from the resource of <code>handle</code>
+ */
+template <typename T, typename HandleT> std::promise<T> make_dispatch_promise(const HandleT& handle)
+{
+  return std::promise<T>{std::allocator_arg, std::pmr::polymorphic_allocator<std::byte>{handle.resource()}};
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Runs invocables in parallel on an executor, returning the first valid result, in order of invocables
+ *
+ * Invocables which accept the executor's <code>handle_type</code> as their first argument receive a handle which
+ * they may poll for cancellation. All invocables receive immutable views of the same values.
+ *
+ * @tparam ExecutorT  executor implementation type
+ */
+template <typename ExecutorT, typename... InvocableTs> class any_dispatch<exec::executor<ExecutorT>, InvocableTs...>
+{
+public:
+  /// Handle type passed to invocables which accept one
+  using handle_type = exec::handle_type_t<ExecutorT>;
+
+  explicit constexpr any_dispatch(exec::executor<ExecutorT>& exec, InvocableTs&&... fs) :
+      e_{exec}, invocables_{std::forward<InvocableTs>(fs)...}
+  {
+    static_assert(sizeof...(InvocableTs) > 0, "At least one invocable must be specified");
+  };
+
+  template <typename... ValueTs> decltype(auto) operator()(ValueTs&&... values) const
+  {
+    return detail::with_dispatch_handle<handle_type>(
+      [this](handle_type& handle, auto&&... vs) -> decltype(auto) {
+        return exec_impl(std::make_index_sequence<sizeof...(InvocableTs)>{}, handle, std::forward<decltype(vs)>(vs)...);
+      },
+      std::forward<ValueTs>(values)...);
+  }
+
+  /**
+   * @brief Returns executor which invocables are dispatched to
+   */
+  [[nodiscard]] constexpr exec::executor<ExecutorT>& executor() const { return e_; }
+
+  /**
+   * @brief Returns dispatched invocables
+   */
+  [[nodiscard]] constexpr const std::tuple<InvocableTs&&...>& invocables() const { return invocables_; }
+
+private:
+  template <typename... ValueTs, std::size_t... Is>
+  decltype(auto) exec_impl(std::index_sequence<Is...> _, handle_type& handle, ValueTs&&... values) const
+  {
+    ZEN_TRACE_SPAN("any", "dispatch");
+
+    // clang-format off
+    using result_type =
+      detail::dispatch_result_t<meta::first_t<InvocableTs...>, handle_type, detail::branch_value_t<false, ValueTs>...>;
+
+    static_assert(
+      (std::is_same_v<
+         result_type,
+         detail::dispatch_result_t<InvocableTs, handle_type, detail::branch_value_t<false, ValueTs>...>> &&
+       ...),
+      "'InvocableTs' executed under [any_dispatch] must all have the same return type");
+
+    static constexpr std::size_t N = sizeof...(Is);
+    std::promise<result_type> promises[N] = {
+      ((void)Is, detail::make_dispatch_promise<result_type>(handle))...};
+    std::future<result_type> results[N] = {promises[Is].get_future()...};
+
+    // Queue up all work to run simultaneously
+    auto work = [&](const std::size_t i)
+    {
+      const arena_scope scope{handle.arena()};
+      [[maybe_unused]] const bool launched = ((i == Is && (promises[Is].set_value(
+        result_type{detail::dispatch_invoke(std::get<Is>(this->invocables_), handle, std::as_const(values)...)}),
+        true)) || ...);
+    };
+    exec::task_batch<N, decltype(work)> batch{work};
+    e_.bulk_execute(batch);
+
+    // Get result
+    result_type r;
+    {
+      [[maybe_unused]] const auto unused = ((r = results[Is].get(), (r.valid() || (handle.cancel(), false))) || ...);
+    }
+
+    // Block on any remaining work
+    {
+      [[maybe_unused]] const auto unused = ((!results[Is].valid() || (results[Is].wait(), true)) && ...);
+    }
+
+    if (!r.valid())
+    {
+      message_registry::instance().propagated(r.status().message());
+    }
+
+    // clang-format on
+    return r;
+  }
+
+  exec::executor<ExecutorT>& e_;
+  std::tuple<InvocableTs&&...> invocables_;
+};
+
+/**
+ * @brief Tag which hands ownership of the values passed to a parallel <code>all</code> to its <code>I</code>-th
+ *        invocable
+ */
+template <std::size_t I> struct move_into_t
+{
+  explicit constexpr move_into_t() = default;
+};
+
+/**
+ * @brief Hands ownership of the values passed to a parallel <code>all</code> to its <code>I</code>-th invocable
+ *
+ * The owning invocable receives values as they were passed, so it may move from them; other invocables receive
+ * immutable views of the same values, as usual.
+ * \n
+ * The owner is serialized after all other invocables: it runs on the calling thread, once they have all returned, and
+ * never overlaps with them, so the dispatch takes as long as the slowest other invocable and the owner together. Give
+ * ownership to a cheap invocable where possible. If another invocable fails, or the dispatch is cancelled, the owner
+ * is not run at all, so its side effects never happen for a dispatch which has already failed; its result takes the
+ * status of the failure, or Cancelled.
+ *
+@verbatim
+  auto r = pass(std::move(records))
+         | all(tp, move_into<1>, summarize, [](std::vector<record>&& rs) { return archive(std::move(rs)); });
+@endverbatim
+ */
+template <std::size_t I> inline constexpr move_into_t<I> move_into{};
+
+/**
+ * @brief Runs invocables in parallel on an executor, combining their results
+ *
+ * Invocables which accept the executor's <code>handle_type</code> as their first argument receive a handle which
+ * they may poll for cancellation; it is cancelled once any invocable produces an invalid result.
+ *
+ * All invocables receive immutable views of the same values, so values are shared without copies, and are never
+ * moved from by one invocable while others read them. See move_into for handing values to one invocable.
+ *
+ * @tparam ExecutorT  executor implementation type
+ */
+template <typename ExecutorT, typename... InvocableTs> class all_dispatch<exec::executor<ExecutorT>, InvocableTs...>
+{
+public:
+  /// Handle type passed to invocables which accept one
+  using handle_type = exec::handle_type_t<ExecutorT>;
+
+  explicit constexpr all_dispatch(exec::executor<ExecutorT>& exec, InvocableTs&&... fs) :
+      e_{exec}, invocables_{std::forward<InvocableTs>(fs)...}
+  {
+    static_assert(sizeof...(InvocableTs) > 0, "At least one invocable must be specified");
+  };
+
+  template <typename... ValueTs> decltype(auto) operator()(ValueTs&&... values) const
+  {
+    return dispatch<sizeof...(InvocableTs)>(std::forward<ValueTs>(values)...);
+  }
+
+  /**
+   * @brief Returns executor which invocables are dispatched to
+   */
+  [[nodiscard]] constexpr exec::executor<ExecutorT>& executor() const { return e_; }
+
+  /**
+   * @brief Returns dispatched invocables
+   */
+  [[nodiscard]] constexpr const std::tuple<InvocableTs&&...>& invocables() const { return invocables_; }
+
+protected:
+  /**
+   * @brief Runs invocables with <code>values</code>, handing ownership of them to invocable <code>kOwner</code>,
+   *        if there is one
+   */
+  template <std::size_t kOwner, typename... ValueTs> decltype(auto) dispatch(ValueTs&&... values) const
+  {
+    return detail::with_dispatch_handle<handle_type>(
+      [this](handle_type& handle, auto&&... vs) -> decltype(auto) {
+        return exec_impl<kOwner>(
+          std::make_index_sequence<sizeof...(InvocableTs)>{}, handle, std::forward<decltype(vs)>(vs)...);
+      },
+      std::forward<ValueTs>(values)...);
+  }
+
+private:
+  template <std::size_t kOwner, typename... ValueTs, std::size_t... Is>
+  decltype(auto) exec_impl(std::index_sequence<Is...> _, handle_type& handle, ValueTs&&... values) const
+  {
+    ZEN_TRACE_SPAN("all", "dispatch");
+
+    // clang-format off
+
+    // Create promises
+    auto ps = std::make_tuple(
+      detail::make_dispatch_promise<
+        detail::branch_result_t<
+          Is == kOwner,
+          std::tuple_element_t<Is, std::tuple<InvocableTs...>>,
+          handle_type,
+          ValueTs...
+        >
+      >(handle)...);
+
+    // Gather futures from promises
+    auto fs = std::make_tuple(std::get<Is>(ps).get_future()...);
+
+    // First failure of an invocable other than the owner; written once, before its promise is set
+    std::atomic<bool> failed{false};
+    result_status failure;
+
+    // Runs invocable I, passing values as it should receive them
+    const auto run = [&](auto index)
+    {
+      constexpr std::size_t I = decltype(index)::value;
+      const arena_scope scope{handle.arena()};
+      if constexpr (kOwner < sizeof...(Is) && I != kOwner)
+      {
+        using branch_result_type =
+          detail::branch_result_t<false, std::tuple_element_t<I, std::tuple<InvocableTs...>>, handle_type, ValueTs...>;
+        branch_result_type r{detail::dispatch_invoke(
+          std::get<I>(invocables_), handle, detail::branch_value<false, ValueTs>(values)...)};
+        if (!r.valid() && !failed.exchange(true, std::memory_order_relaxed))
+        {
+          failure = r.status();
+          handle.cancel();
+        }
+        std::get<I>(ps).set_value(std::move(r));
+      }
+      else
+      {
+        std::get<I>(ps).set_value(detail::dispatch_invoke(
+          std::get<I>(invocables_), handle, detail::branch_value<I == kOwner, ValueTs>(values)...));
+      }
+    };
+
+    // Start work, in which invocable i runs for each task i, skipping the owner
+    auto work = [&](const std::size_t task)
+    {
+      const std::size_t i = (task < kOwner) ? task : task + 1;
+      [[maybe_unused]] const bool launched =
+        ((i == Is && (run(std::integral_constant<std::size_t, Is>{}), true)) || ...);
+    };
+    exec::task_batch<sizeof...(Is) - ((kOwner < sizeof...(Is)) ? 1 : 0), decltype(work)> batch{work};
+    e_.bulk_execute(batch);
+
+    // Run the owner once no other invocable reads values, unless the dispatch has already failed; waiting on the
+    // futures of other invocables orders their writes to failure before the read below
+    if constexpr (kOwner < sizeof...(Is))
+    {
+      [[maybe_unused]] const auto unused = (((Is == kOwner) || (std::get<Is>(fs).wait(), true)) && ...);
+
+      using owner_result_type = detail::branch_result_t<
+        true, std::tuple_element_t<kOwner, std::tuple<InvocableTs...>>, handle_type, ValueTs...>;
+      if (failed.load(std::memory_order_relaxed))
+      {
+        std::get<kOwner>(ps).set_value(owner_result_type{std::move(failure)});
+      }
+      else if (handle.is_cancelled())
+      {
+        std::get<kOwner>(ps).set_value(owner_result_type{result_status{Cancelled}});
+      }
+      else
+      {
+        run(std::integral_constant<std::size_t, kOwner>{});
+      }
+    }
+
+    // Create result from async functions
+    auto r = create(
+      make_deferred_result([&handle, &f=std::get<Is>(fs)]() mutable
+      {
+        auto r = f.get();
+
+        if (!r.valid())
+        {
+          handle.cancel();
+        }
+        return r;
+      })...
+    );
+
+    // Block on any remaining work
+    {
+      [[maybe_unused]] const auto unused = ((!std::get<Is>(fs).valid() || (std::get<Is>(fs).wait(), true)) && ...);
+    }
+
+    return r;
+    // clang-format on
+  }
+
+  exec::executor<ExecutorT>& e_;
+  std::tuple<InvocableTs&&...> invocables_;
+};
+
+/**
+ * @brief Runs invocables in parallel on an executor, combining their results, and hands ownership of values to
+ *        invocable <code>I</code>
+ *
+ * @see move_into
+ *
+ * @tparam ExecutorT  executor implementation type
+ * @tparam I  index of invocable which owns values
+ */
+template <typename ExecutorT, std::size_t I, typename... InvocableTs>
+class all_dispatch<exec::executor<ExecutorT>, move_into_t<I>, InvocableTs...>
+    : public all_dispatch<exec::executor<ExecutorT>, InvocableTs...>
+{
+public:
+  explicit constexpr all_dispatch(exec::executor<ExecutorT>& exec, move_into_t<I>, InvocableTs&&... fs) :
+      all_dispatch<exec::executor<ExecutorT>, InvocableTs...>{exec, std::forward<InvocableTs>(fs)...}
+  {
+    static_assert(sizeof...(InvocableTs) > 1, "Values are handed to one of several invocables");
+    static_assert(I < sizeof...(InvocableTs), "Owning invocable index is out of range");
+  };
+
+  template <typename... ValueTs> decltype(auto) operator()(ValueTs&&... values) const
+  {
+    return this->template dispatch<I>(std::forward<ValueTs>(values)...);
+  }
+};
+
+}  // namespace zen
@@ -0,0 +1,370 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor/thread_pool.hpp>
+#include <zen/meta/invocable.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Decides when hedged alternatives are launched and keeps track of how often they fire
+ *
+ * A fixed policy always waits <code>delay</code> before launching the next alternative. An adaptive policy
+ * tracks recent latencies of the primary invocable and waits for the configured latency percentile instead,
+ * falling back to <code>delay</code> until enough samples have been recorded.
+ */
+class hedge_policy
+{
+public:
+  /**
+   * @brief Creates a fixed-delay policy
+   *
+   * @param delay  time waited before each successive alternative is launched
+   */
+  explicit hedge_policy(std::chrono::nanoseconds delay) : delay_{delay}, percentile_{0.0} {}
+
+  /**
+   * @brief Creates an adaptive-delay policy
+   *
+   * @param initial_delay  delay used until enough latency samples have been recorded
+   * @param percentile  tracked latency percentile, in <code>(0, 1]</code>
+   */
+  hedge_policy(std::chrono::nanoseconds initial_delay, double percentile) :
+      delay_{initial_delay}, percentile_{percentile}
+  {}
+
+  /**
+   * @brief Returns the delay to wait before launching the next alternative
+   */
+  [[nodiscard]] std::chrono::nanoseconds delay() const
+  {
+    if (percentile_ <= 0.0)
+    {
+      return delay_;
+    }
+
+    std::array<std::chrono::nanoseconds::rep, kWindowSize> samples;
+    std::size_t count;
+    {
+      std::lock_guard lock{samples_mtx_};
+      count = std::min(sample_count_, kWindowSize);
+      std::copy(samples_.begin(), samples_.begin() + count, samples.begin());
+    }
+
+    if (count < kMinSamples)
+    {
+      return delay_;
+    }
+
+    const auto nth = samples.begin() + std::min(count - 1, static_cast<std::size_t>(percentile_ * count));
+    std::nth_element(samples.begin(), nth, samples.begin() + count);
+    return std::chrono::nanoseconds{*nth};
+  }
+
+  /**
+   * @brief Records latency of a primary invocable
+   *
+   * @note primary invocables which were still running when the request completed are recorded with their elapsed
+   *       time at completion, which is a lower bound on their true latency
+   */
+  void record(std::chrono::nanoseconds latency)
+  {
+    std::lock_guard lock{samples_mtx_};
+    samples_[sample_count_++ % kWindowSize] = latency.count();
+  }
+
+  /**
+   * @brief Returns the number of hedged requests dispatched with this policy
+   */
+  [[nodiscard]] std::size_t requests() const { return requests_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the number of alternatives (hedges) launched in addition to primary invocables
+   */
+  [[nodiscard]] std::size_t hedges() const { return hedges_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the number of requests whose valid result came from a hedge rather than the primary
+   */
+  [[nodiscard]] std::size_t wins() const { return wins_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the average number of hedges fired per request
+   */
+  [[nodiscard]] double hedge_rate() const
+  {
+    const auto n = requests();
+    return n == 0 ? 0.0 : static_cast<double>(hedges()) / static_cast<double>(n);
+  }
+
+private:
+  template <typename ExecutorT, typename... InvocableTs> friend class hedge_dispatch;
+
+  /// Number of recent primary latencies tracked by adaptive policies
+  static constexpr std::size_t kWindowSize = 64;
+
+  /// Number of samples needed before adaptive delay replaces the initial delay
+  static constexpr std::size_t kMinSamples = 8;
+
+  /// Fixed (or initial) hedge delay
+  std::chrono::nanoseconds delay_;
+
+  /// Tracked latency percentile; non-positive for fixed policies
+  double percentile_;
+
+  /// Mutex which synchronizes latency samples
+  mutable std::mutex samples_mtx_;
+
+  /// Ring of recent primary latencies, in nanoseconds
+  std::array<std::chrono::nanoseconds::rep, kWindowSize> samples_ = {};
+
+  /// Total number of samples recorded
+  std::size_t sample_count_ = 0;
+
+  /// Counters reported by requests(), hedges() and wins()
+  std::atomic<std::size_t> requests_{0}, hedges_{0}, wins_{0};
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief State shared between a hedged request and its in-flight alternatives
+ *
+ * Owns copies of arguments and invocables so that alternatives which are still running once the request has
+ * completed remain valid until they observe cancellation and return.
+ */
+template <typename ResultT, typename ArgTupleT, typename InvocableTupleT> struct hedge_state
+{
+  using result_type = ResultT;
+
+  static constexpr std::size_t N = std::tuple_size_v<InvocableTupleT>;
+
+  hedge_state(ArgTupleT&& _args, InvocableTupleT&& _invocables) :
+      args{std::move(_args)}, invocables{std::move(_invocables)}
+  {}
+
+  ArgTupleT args;
+  InvocableTupleT invocables;
+  exec::thread_pool_handle handle;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::size_t finished = 0;
+  std::size_t winner = N;
+  ResultT r;
+  std::array<std::chrono::steady_clock::time_point, N> launched_at = {};
+  std::array<std::chrono::steady_clock::duration, N> elapsed = {};
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Implements invocable dispatch behavior for free-function <code>hedge</code>
+ *
+ * Launches the first (primary) invocable immediately. Each further alternative <code>k</code> is launched only if
+ * no valid result has arrived after <code>k</code> hedge delays, or as soon as every launched alternative has
+ * failed. Returns the first valid result and cancels remaining alternatives; otherwise returns result with the last
+ * invalid status.
+ */
+template <typename ExecutorT, typename... InvocableTs> class hedge_dispatch;
+
+template <typename F, typename A, typename Q, typename... InvocableTs>
+class hedge_dispatch<exec::thread_pool<F, A, Q>, InvocableTs...>
+{
+public:
+  explicit constexpr hedge_dispatch(
+    exec::thread_pool<F, A, Q>& exec,
+    std::chrono::nanoseconds delay,
+    hedge_policy* policy,
+    InvocableTs&&... fs) :
+      e_{exec}, delay_{delay}, policy_{policy}, invocables_{std::forward<InvocableTs>(fs)...}
+  {
+    static_assert(sizeof...(InvocableTs) > 0, "At least one invocable must be specified");
+  };
+
+  template <typename... ValueTs> decltype(auto) operator()(ValueTs&&... values) const
+  {
+    using first_value_type = std::remove_cv_t<std::remove_reference_t<meta::first_t<ValueTs..., void>>>;
+    if constexpr (exec::is_executor_handle_v<first_value_type>)
+    {
+      return exec_ignore_handle(std::forward<ValueTs>(values)...);
+    }
+    else
+    {
+      return exec_impl(std::make_index_sequence<sizeof...(InvocableTs)>{}, std::forward<ValueTs>(values)...);
+    }
+  }
+
+private:
+  template <typename Ignore, typename... ValueTs> decltype(auto) exec_ignore_handle(Ignore&&, ValueTs&&... values) const
+  {
+    return exec_impl(std::make_index_sequence<sizeof...(InvocableTs)>{}, std::forward<ValueTs>(values)...);
+  }
+
+  template <std::size_t I, typename StateT> static void launch(exec::thread_pool<F, A, Q>& e, std::shared_ptr<StateT> s)
+  {
+    s->launched_at[I] = std::chrono::steady_clock::now();
+    e.execute([s = std::move(s)] {
+      typename StateT::result_type r{exec::apply_with_handle(std::get<I>(s->invocables), s->handle, s->args)};
+
+      std::lock_guard lock{s->mtx};
+      s->elapsed[I] = std::chrono::steady_clock::now() - s->launched_at[I];
+      ++s->finished;
+      if (s->winner == StateT::N)
+      {
+        // Keep the first valid result, or the latest invalid one until a valid result arrives
+        s->winner = r.valid() ? I : s->winner;
+        s->r = std::move(r);
+      }
+      s->cv.notify_all();
+    });
+  }
+
+  template <typename StateT, std::size_t... Is>
+  static void
+  launch_nth(std::size_t n, exec::thread_pool<F, A, Q>& e, const std::shared_ptr<StateT>& s, std::index_sequence<Is...>)
+  {
+    [[maybe_unused]] const bool unused = ((n == Is && (launch<Is>(e, s), true)) || ...);
+  }
+
+  template <typename... ValueTs, std::size_t... Is>
+  auto exec_impl(std::index_sequence<Is...> _, ValueTs&&... values) const
+  {
+    // clang-format off
+    using args_type = std::tuple<std::decay_t<ValueTs>...>;
+    using invocables_type = std::tuple<std::decay_t<InvocableTs>...>;
+    using result_type = to_result_t<
+      std::remove_cv_t<std::remove_reference_t<
+        decltype(exec::apply_with_handle(
+          std::declval<meta::first_t<std::decay_t<InvocableTs>...>&>(),
+          std::declval<exec::thread_pool_handle&>(),
+          std::declval<args_type&>()))
+      >>
+    >;
+    // clang-format on
+
+    using state_type = detail::hedge_state<result_type, args_type, invocables_type>;
+
+    static constexpr std::size_t N = sizeof...(Is);
+
+    const auto delay = (policy_ == nullptr) ? delay_ : policy_->delay();
+    const auto start = std::chrono::steady_clock::now();
+
+    auto s = std::make_shared<state_type>(
+      args_type{std::forward<ValueTs>(values)...}, invocables_type{std::get<Is>(invocables_)...});
+
+    std::size_t launched = 1;
+    launch<0>(e_, s);
+
+    std::unique_lock lock{s->mtx};
+    while (s->winner == N && s->finished < N)
+    {
+      if (launched == N)
+      {
+        s->cv.wait(lock);
+      }
+      else if (
+        s->finished == launched ||
+        (s->cv.wait_until(lock, start + delay * launched) == std::cv_status::timeout && s->winner == N))
+      {
+        // Launch next alternative when hedge delay has elapsed, or when all launched alternatives have failed
+        lock.unlock();
+        launch_nth(launched++, e_, s, _);
+        lock.lock();
+      }
+    }
+
+    // Stop any alternatives which are still in flight
+    s->handle.cancel();
+
+    if (policy_ != nullptr)
+    {
+      policy_->requests_.fetch_add(1, std::memory_order_relaxed);
+      policy_->hedges_.fetch_add(launched - 1, std::memory_order_relaxed);
+      if (s->winner != N && s->winner != 0)
+      {
+        policy_->wins_.fetch_add(1, std::memory_order_relaxed);
+      }
+      policy_->record(
+        (s->elapsed[0] != std::chrono::steady_clock::duration::zero())
+          ? std::chrono::duration_cast<std::chrono::nanoseconds>(s->elapsed[0])
+          : std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start));
+    }
+
+    return std::move(s->r);
+  }
+
+  exec::thread_pool<F, A, Q>& e_;
+  std::chrono::nanoseconds delay_;
+  hedge_policy* policy_;
+  std::tuple<InvocableTs&&...> invocables_;
+};
+
+/**
+ * @brief Executes a primary invocable, launching each backup invocable only if no valid result has arrived after
+ * a growing multiple of <code>delay</code>. Returns the first valid result<T> and cancels remaining invocables.
+ *
+ * Otherwise, returns result<T> with the last invalid status. All invocables must have the same return type.
+ * Arguments and invocables are copied so that slow alternatives may outlive the request; invocables which accept
+ * an executor handle should poll <code>handle.is_cancelled()</code> to stop early.
+@verbatim
+  auto r = pass(key)
+         | hedge(
+            tp,
+            std::chrono::milliseconds{5},
+            [](int key) -> result<int> { return read_from_replica(0, key); },
+            [](int key) -> result<int> { return read_from_replica(1, key); }
+          );
+@endverbatim
+ */
+template <typename F, typename A, typename Q, typename Rep, typename Period, typename... InvocableTs>
+constexpr decltype(auto)
+hedge(exec::thread_pool<F, A, Q>& tp, std::chrono::duration<Rep, Period> delay, InvocableTs&&... t)
+{
+  return hedge_dispatch<exec::thread_pool<F, A, Q>, InvocableTs...>{
+    tp,
+    std::chrono::duration_cast<std::chrono::nanoseconds>(delay),
+    nullptr,
+    std::forward<InvocableTs>(t)...};
+}
+
+/**
+ * @brief Executes a primary invocable and hedges with backup invocables using the delay provided by a
+ * <code>hedge_policy</code>
+ *
+ * The policy is updated with primary latencies and hedge counters on each invocation, and must outlive the returned
+ * dispatcher.
+@verbatim
+  hedge_policy policy{std::chrono::milliseconds{5}, 0.95};
+
+  auto r = pass(key) | hedge(tp, policy, read_primary, read_backup);
+
+  std::cout << policy.hedge_rate() << std::endl;
+@endverbatim
+ */
+template <typename F, typename A, typename Q, typename... InvocableTs>
+constexpr decltype(auto) hedge(exec::thread_pool<F, A, Q>& tp, hedge_policy& policy, InvocableTs&&... t)
+{
+  return hedge_dispatch<exec::thread_pool<F, A, Q>, InvocableTs...>{
+    tp, std::chrono::nanoseconds::zero(), &policy, std::forward<InvocableTs>(t)...};
+}
+
+}  // namespace zen
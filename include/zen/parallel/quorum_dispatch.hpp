@@ -0,0 +1,257 @@
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <condition_variable>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor/thread_pool.hpp>
+#include <zen/meta/first.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Quorum size used to select a quorum which is specified at runtime
+ */
+static constexpr std::size_t dynamic_quorum = std::numeric_limits<std::size_t>::max();
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief State shared between a quorum request and its in-flight invocables
+ *
+ * Owns copies of arguments and invocables so that invocables which are still running once the quorum has been
+ * decided remain valid until they observe cancellation and return.
+ */
+template <typename ResultT, typename ArgTupleT, typename InvocableTupleT> struct quorum_state
+{
+  using result_type = ResultT;
+  using value_type = std::remove_reference_t<decltype(*std::declval<ResultT&>())>;
+
+  quorum_state(std::size_t _k, ArgTupleT&& _args, InvocableTupleT&& _invocables) :
+      k{_k}, args{std::move(_args)}, invocables{std::move(_invocables)}
+  {
+    values.reserve(k);
+  }
+
+  /// Returns true once enough valid results have arrived, or once too many invocables have failed
+  [[nodiscard]] bool decided() const
+  {
+    return values.size() >= k || failures > (std::tuple_size_v<InvocableTupleT> - k);
+  }
+
+  std::size_t k;
+  ArgTupleT args;
+  InvocableTupleT invocables;
+  exec::thread_pool_handle handle;
+
+  std::mutex mtx;
+  std::condition_variable cv;
+  std::size_t failures = 0;
+  result_status last_failure;
+  std::vector<value_type> values;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Implements invocable dispatch behavior for free-function <code>quorum</code>
+ *
+ * Launches all invocables simultaneously. Returns as soon as <code>K</code> of them have returned a valid result,
+ * with their values in completion order, and cancels the remaining invocables. Returns a result holding the last
+ * invalid status as soon as <code>K</code> valid results are no longer possible.
+ */
+template <std::size_t K, typename ExecutorT, typename... InvocableTs> class quorum_dispatch;
+
+template <std::size_t K, typename F, typename A, typename Q, typename... InvocableTs>
+class quorum_dispatch<K, exec::thread_pool<F, A, Q>, InvocableTs...>
+{
+public:
+  explicit constexpr quorum_dispatch(exec::thread_pool<F, A, Q>& exec, std::size_t k, InvocableTs&&... fs) :
+      e_{exec}, k_{k}, invocables_{std::forward<InvocableTs>(fs)...}
+  {
+    static_assert(sizeof...(InvocableTs) > 0, "At least one invocable must be specified");
+    static_assert(
+      K == dynamic_quorum || (K > 0 && K <= sizeof...(InvocableTs)),
+      "Quorum must be between 1 and the number of invocables");
+  };
+
+  template <typename... ValueTs> decltype(auto) operator()(ValueTs&&... values) const
+  {
+    using first_value_type = std::remove_cv_t<std::remove_reference_t<meta::first_t<ValueTs..., void>>>;
+    if constexpr (exec::is_executor_handle_v<first_value_type>)
+    {
+      return exec_ignore_handle(std::forward<ValueTs>(values)...);
+    }
+    else
+    {
+      return exec_impl(std::make_index_sequence<sizeof...(InvocableTs)>{}, std::forward<ValueTs>(values)...);
+    }
+  }
+
+private:
+  template <typename Ignore, typename... ValueTs> decltype(auto) exec_ignore_handle(Ignore&&, ValueTs&&... values) const
+  {
+    return exec_impl(std::make_index_sequence<sizeof...(InvocableTs)>{}, std::forward<ValueTs>(values)...);
+  }
+
+  template <std::size_t I, typename StateT> static void launch(exec::thread_pool<F, A, Q>& e, std::shared_ptr<StateT> s)
+  {
+    e.execute([s = std::move(s)] {
+      if (s->handle.is_cancelled())
+      {
+        return;
+      }
+
+      typename StateT::result_type r{exec::apply_with_handle(std::get<I>(s->invocables), s->handle, s->args)};
+
+      std::lock_guard lock{s->mtx};
+      if (s->decided())
+      {
+        return;
+      }
+      else if (r.valid())
+      {
+        s->values.emplace_back(std::move(*r));
+      }
+      else
+      {
+        ++s->failures;
+        s->last_failure = r.status();
+      }
+      s->cv.notify_all();
+    });
+  }
+
+  template <typename T, std::size_t... Is>
+  static std::array<T, sizeof...(Is)> to_array(std::vector<T>&& values, std::index_sequence<Is...>)
+  {
+    return {std::move(values[Is])...};
+  }
+
+  template <typename... ValueTs, std::size_t... Is>
+  auto exec_impl(std::index_sequence<Is...> _, ValueTs&&... values) const
+  {
+    // clang-format off
+    using args_type = std::tuple<std::decay_t<ValueTs>...>;
+    using invocables_type = std::tuple<std::decay_t<InvocableTs>...>;
+    using invocable_result_type = to_result_t<
+      std::remove_cv_t<std::remove_reference_t<
+        decltype(exec::apply_with_handle(
+          std::declval<meta::first_t<std::decay_t<InvocableTs>...>&>(),
+          std::declval<exec::thread_pool_handle&>(),
+          std::declval<args_type&>()))
+      >>
+    >;
+
+    static_assert(
+      (std::is_same_v<
+        invocable_result_type,
+        to_result_t<
+          std::remove_cv_t<std::remove_reference_t<
+            decltype(exec::apply_with_handle(
+              std::declval<std::decay_t<InvocableTs>&>(),
+              std::declval<exec::thread_pool_handle&>(),
+              std::declval<args_type&>()))
+          >>
+        >> && ...),
+      "'InvocableTs' executed under [quorum_dispatch] must all have the same return type");
+    // clang-format on
+
+    using state_type = detail::quorum_state<invocable_result_type, args_type, invocables_type>;
+    using value_type = typename state_type::value_type;
+    using result_type =
+      std::conditional_t<K == dynamic_quorum, result<std::vector<value_type>>, result<std::array<value_type, K>>>;
+
+    if constexpr (K == dynamic_quorum)
+    {
+      if (k_ == 0 || k_ > sizeof...(InvocableTs))
+      {
+        return result_type{"quorum must be between 1 and the number of invocables"_msg};
+      }
+    }
+
+    auto s = std::make_shared<state_type>(
+      k_, args_type{std::forward<ValueTs>(values)...}, invocables_type{std::get<Is>(invocables_)...});
+
+    // Queue up all work to run simultaneously
+    {
+      [[maybe_unused]] const auto unused = ((launch<Is>(e_, s), true) && ...);
+    }
+
+    std::unique_lock lock{s->mtx};
+    s->cv.wait(lock, [&s] { return s->decided(); });
+
+    // Stop any invocables which are still in flight
+    s->handle.cancel();
+
+    if (s->values.size() < s->k)
+    {
+      return result_type{std::move(s->last_failure)};
+    }
+    else if constexpr (K == dynamic_quorum)
+    {
+      return result_type{std::move(s->values)};
+    }
+    else
+    {
+      return result_type{to_array(std::move(s->values), std::make_index_sequence<K>{})};
+    }
+  }
+
+  exec::thread_pool<F, A, Q>& e_;
+  std::size_t k_;
+  std::tuple<InvocableTs&&...> invocables_;
+};
+
+/**
+ * @brief Executes invocables simultaneously until <code>K</code> of them return a valid result<T>, then cancels the
+ * rest, returning a result holding a <code>std::array</code> of their values in completion order.
+ *
+ * Otherwise, returns a result with the last invalid status as soon as <code>K</code> valid results can no longer be
+ * collected. All invocables must have the same return type. Arguments and invocables are copied so that invocables
+ * which are still running once the quorum is decided may outlive the request.
+@verbatim
+  auto r = pass(key, value)
+         | quorum<2>(
+            tp,
+            [](int key, int value) -> result<int> { return write_to_replica(0, key, value); },
+            [](int key, int value) -> result<int> { return write_to_replica(1, key, value); },
+            [](int key, int value) -> result<int> { return write_to_replica(2, key, value); }
+          );
+@endverbatim
+ */
+template <std::size_t K, typename F, typename A, typename Q, typename... InvocableTs>
+constexpr decltype(auto) quorum(exec::thread_pool<F, A, Q>& tp, InvocableTs&&... t)
+{
+  return quorum_dispatch<K, exec::thread_pool<F, A, Q>, InvocableTs...>{
+    tp, K, std::forward<InvocableTs>(t)...};
+}
+
+/**
+ * @brief Executes invocables simultaneously until <code>k</code> of them return a valid result<T>
+ *
+ * Same as <code>quorum<K></code>, but with a quorum size chosen at runtime. Returns a result holding a
+ * <code>std::vector</code> of values in completion order.
+ */
+template <typename F, typename A, typename Q, typename... InvocableTs>
+constexpr decltype(auto) quorum(exec::thread_pool<F, A, Q>& tp, std::size_t k, InvocableTs&&... t)
+{
+  return quorum_dispatch<dynamic_quorum, exec::thread_pool<F, A, Q>, InvocableTs...>{
+    tp, k, std::forward<InvocableTs>(t)...};
+}
+
+}  // namespace zen
@@ -3,6 +3,8 @@
 // C++ Standard Library
 #include <exception>
 #include <iosfwd>
+#include <new>
+#include <type_traits>
 #include <utility>
 
 // Zen
@@ -10,6 +12,7 @@
 #include <zen/meta/is_specialization.hpp>
 #include <zen/meta/type_to_string.hpp>
 #include <zen/result/deferred_result.hpp>
+#include <zen/result/registry.hpp>
 #include <zen/result/status.hpp>
 #include <zen/result/to_result.hpp>
 #include <zen/utility/value_mem.hpp>
@@ -64,11 +67,50 @@ public:
    */
   constexpr result(T&& value);
 
+  /**
+   * @brief Creates a valid result with a value payload constructed in place
+   *
+   * @param args  arguments forwarded to the constructor of the value payload
+   */
+  template <typename... ArgTs> constexpr explicit result(std::in_place_t, ArgTs&&... args);
+
   /**
    * @brief Default initializes result to invalid (Unknown) state
    */
   constexpr result() = default;
 
+  /**
+   * @brief Copies status and, if <code>other.valid() == true</code>, the value payload
+   */
+  result(const result& other) noexcept(std::is_nothrow_copy_constructible_v<T>);
+
+  /**
+   * @brief Moves status and, if <code>other.valid() == true</code>, the value payload
+   *
+   * @note <code>other</code> keeps its status; its payload is left in a moved-from state
+   */
+  result(result&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+
+  /**
+   * @brief Copies status and, if <code>other.valid() == true</code>, the value payload
+   *
+   * Like <code>std::optional</code>, the payload is assigned if both results are valid, copy constructed if only
+   * <code>other</code> is, and destroyed if only this result is. If copying the payload throws, this result is left
+   * invalid if it was invalid; otherwise it is left valid, holding a payload in whatever state its assignment left it.
+   * Payloads which can not be assigned are destroyed, and copy constructed in place, leaving this result invalid if
+   * that throws.
+   */
+  result& operator=(const result& other) noexcept(kNothrowCopy);
+
+  /**
+   * @brief Moves status and, if <code>other.valid() == true</code>, the value payload
+   *
+   * Exception guarantees are those of operator=(const result&).
+   *
+   * @note <code>other</code> keeps its status; its payload is left in a moved-from state
+   */
+  result& operator=(result&& other) noexcept(kNothrowMove);
+
   /**
    * @brief Destroys result value, if <code>valid() == true</code>
    */
@@ -115,6 +157,19 @@ public:
   using value_mem<T>::operator->;
 
 private:
+  /// <code>true</code> if copy assignment does not throw
+  static constexpr bool kNothrowCopy = std::is_nothrow_copy_constructible_v<T> &&
+    (std::is_nothrow_copy_assignable_v<T> || !std::is_copy_assignable_v<T>);
+
+  /// <code>true</code> if move assignment does not throw
+  static constexpr bool kNothrowMove = std::is_nothrow_move_constructible_v<T> &&
+    (std::is_nothrow_move_assignable_v<T> || !std::is_move_assignable_v<T>);
+
+  /**
+   * @brief Assigns status and payload of <code>other</code>, forwarding its payload
+   */
+  template <typename ResultT> void assign_from(ResultT&& other);
+
   result_status status_;
 };
 
@@ -125,6 +180,7 @@ constexpr result<T>::result(message<Elements...>&& error_message) : value_mem<T>
   static_assert(
     !are_messages_equal<message<Elements...>, decltype(Valid)>(),
     "To set a valid result, assign a value, not an error message");
+  message_registry::instance().created(message<Elements...>::id());
 }
 
 template <typename T> constexpr result<T>::result(result_status&& status) : value_mem<T>{}, status_{std::move(status)}
@@ -134,6 +190,80 @@ template <typename T> constexpr result<T>::result(const T& value) : value_mem<T>
 
 template <typename T> constexpr result<T>::result(T&& value) : value_mem<T>{std::move(value)}, status_{Valid} {}
 
+template <typename T>
+template <typename... ArgTs>
+constexpr result<T>::result(std::in_place_t, ArgTs&&... args) :
+    value_mem<T>{std::forward<ArgTs>(args)...}, status_{Valid}
+{}
+
+template <typename T>
+result<T>::result(const result& other) noexcept(std::is_nothrow_copy_constructible_v<T>) :
+    value_mem<T>{}, status_{other.status_}
+{
+  if (status_.valid())
+  {
+    result::emplace(*other);
+  }
+}
+
+template <typename T>
+result<T>::result(result&& other) noexcept(std::is_nothrow_move_constructible_v<T>) :
+    value_mem<T>{}, status_{other.status_}
+{
+  if (status_.valid())
+  {
+    result::emplace(std::move(*other));
+  }
+}
+
+template <typename T> result<T>& result<T>::operator=(const result& other) noexcept(kNothrowCopy)
+{
+  if (this != &other)
+  {
+    assign_from(other);
+  }
+  return *this;
+}
+
+template <typename T> result<T>& result<T>::operator=(result&& other) noexcept(kNothrowMove)
+{
+  if (this != &other)
+  {
+    assign_from(std::move(other));
+  }
+  return *this;
+}
+
+template <typename T> template <typename ResultT> void result<T>::assign_from(ResultT&& other)
+{
+  // Payload of other, copied from if it is an lvalue, and moved from otherwise
+  using payload_type = std::conditional_t<std::is_lvalue_reference_v<ResultT>, const T&, T&&>;
+
+  if (status_.valid() && other.status_.valid())
+  {
+    if constexpr (std::is_assignable_v<T&, payload_type>)
+    {
+      result::assign(static_cast<payload_type>(*other));
+    }
+    else
+    {
+      // Payload is gone until it is constructed again, so this result is invalid if that throws
+      status_ = Unknown;
+      result::destroy();
+      result::emplace(static_cast<payload_type>(*other));
+    }
+  }
+  else if (other.status_.valid())
+  {
+    result::emplace(static_cast<payload_type>(*other));
+  }
+  else if (status_.valid())
+  {
+    result::destroy();
+  }
+  status_ = other.status_;
+}
+
 template <typename T> result<T>::~result()
 {
   if (status_.valid())
@@ -1,12 +1,18 @@
 #pragma once
 
 // C++ Standard Library
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 // Zen
 #include <zen/fwd.hpp>
 #include <zen/meta/invocable.hpp>
 #include <zen/meta/transform.hpp>
+#include <zen/result/registry.hpp>
+#include <zen/result/status.hpp>
 #include <zen/result/to_result.hpp>
 
 namespace zen
@@ -16,29 +22,101 @@ namespace zen
 namespace detail
 {
 
-template <typename ResultTupleT, typename DeferredTupleT, std::size_t... Is>
-decltype(auto) create(ResultTupleT&& result_tuple, DeferredTupleT&& deferred_result_tuple, std::index_sequence<Is...> _)
+/**
+ * @brief Strips references and qualifiers from aggregated value types, so that aggregates may be moved from
+ */
+template <typename T> struct aggregate_value
 {
-  using concat_result_tuple_type =
-    decltype(std::tuple_cat(as_tuple(std::get<Is>(std::forward<ResultTupleT>(result_tuple)))...));
-  using result_type = result<meta::transform_t<concat_result_tuple_type, std::remove_reference>>;
-
-  result_type r;
-  if (((std::get<Is>(std::forward<ResultTupleT>(result_tuple)) =
-          std::get<Is>(std::forward<DeferredTupleT>(deferred_result_tuple))(),
-        std::get<Is>(std::forward<ResultTupleT>(result_tuple)).valid()) &&
-       ...))
+  using type = std::remove_cv_t<std::remove_reference_t<T>>;
+};
+
+/**
+ * @brief Storage for the result of a deferred invocable, which is constructed in place if the invocable is called
+ */
+template <typename ResultT> class deferred_result_slot
+{
+public:
+  deferred_result_slot() = default;
+
+  deferred_result_slot(const deferred_result_slot&) = delete;
+
+  ~deferred_result_slot()
   {
-    r = result_type{std::tuple_cat(as_tuple(std::get<Is>(std::forward<ResultTupleT>(result_tuple)))...)};
+    if (filled_)
+    {
+      get().~ResultT();
+    }
   }
-  else
+
+  /**
+   * @brief Constructs result returned by <code>dr</code> directly in this slot
+   *
+   * @return <code>true</code> if the result is valid
+   */
+  template <typename DeferredT> bool fill(DeferredT&& dr)
+  {
+    new (&buffer_) ResultT{dr()};
+    filled_ = true;
+    return get().valid();
+  }
+
+  /**
+   * @brief Returns result held in this slot
+   *
+   * @warning behavior undefined if <code>fill</code> has not been called
+   */
+  ResultT& get() { return *reinterpret_cast<ResultT*>(&buffer_); }
+
+private:
+  /// Held-result buffer
+  alignas(ResultT) std::byte buffer_[sizeof(ResultT)];
+
+  /// Set once a result has been constructed in buffer_
+  bool filled_ = false;
+};
+
+/**
+ * @brief Returns a <code>std::tuple</code> of rvalue references to the value of <code>r</code>
+ */
+template <typename T> decltype(auto) forward_values(result<T>& r) { return std::forward_as_tuple(std::move(*r)); }
+
+/**
+ * @brief Returns a <code>std::tuple</code> of rvalue references to each value in the tuple held by <code>r</code>
+ */
+template <typename... Ts> decltype(auto) forward_values(result<std::tuple<Ts...>>& r)
+{
+  return std::apply([](auto&... values) { return std::forward_as_tuple(std::move(values)...); }, *r);
+}
+
+/**
+ * @brief Creates a result from each result returned by deferred invocables
+ *
+ * Each invocable returns its result directly into a slot of its own, and stops the others from being called if it
+ * is invalid. Values of valid results are then moved, once, into the value of the aggregate result, which is
+ * constructed in place.
+ */
+template <typename... ResultTs, typename DeferredTupleT, std::size_t... Is>
+decltype(auto) create(DeferredTupleT&& deferred_result_tuple, std::index_sequence<Is...> _)
+{
+  using concat_result_tuple_type = decltype(std::tuple_cat(as_tuple(std::declval<ResultTs&>())...));
+  using result_type = result<meta::transform_t<concat_result_tuple_type, aggregate_value>>;
+
+  std::tuple<deferred_result_slot<ResultTs>...> slots;
+  if ((std::get<Is>(slots).fill(std::get<Is>(std::forward<DeferredTupleT>(deferred_result_tuple))) && ...))
+  {
+    return std::apply(
+      [](auto&&... values) { return result_type{std::in_place, std::forward<decltype(values)>(values)...}; },
+      std::tuple_cat(forward_values(std::get<Is>(slots).get())...));
+  }
+
+  // Only results up to the first invalid one were created
+  result_status status;
   {
     [[maybe_unused]] const auto _ =
-      ((std::get<Is>(std::forward<ResultTupleT>(result_tuple)).valid() ||
-        (r = result_type{std::get<Is>(std::forward<ResultTupleT>(result_tuple)).status()}, false)) &&
-       ...);
+      ((std::get<Is>(slots).get().valid() || (status = std::get<Is>(slots).get().status(), false)) && ...);
   }
-  return r;
+  message_registry::instance().propagated(status.message());
+  return result_type{std::move(status)};
 }
 
 }  // namespace detail
@@ -103,7 +181,7 @@ template <typename D> using deferred_result_of_t = typename deferred_result_of<s
  */
 template <typename InvocableT> decltype(auto) make_deferred_result(InvocableT&& invocable)
 {
-  return deferred_result<std::remove_reference_t<InvocableT>, void>{std::forward<InvocableT>(invocable)};
+  return deferred_result<InvocableT, void>{std::forward<InvocableT>(invocable)};
 }
 
 /**
@@ -112,7 +190,7 @@ template <typename InvocableT> decltype(auto) make_deferred_result(InvocableT&&
 template <typename InvocableT, typename ArgTupleT>
 decltype(auto) make_deferred_result(InvocableT&& invocable, ArgTupleT&& arg)
 {
-  return deferred_result<std::remove_reference_t<InvocableT>, std::remove_reference_t<ArgTupleT>>{
+  return deferred_result<InvocableT, std::remove_reference_t<ArgTupleT>>{
     std::forward<InvocableT>(invocable), std::forward<ArgTupleT>(arg)};
 }
 
@@ -135,11 +213,10 @@ template <typename DeferredT> decltype(auto) create(DeferredT&& dr) { return dr(
 template <typename DeferredT1, typename DeferredT2, typename... OtherDeferredTs>
 decltype(auto) create(DeferredT1&& d1, DeferredT2&& d2, OtherDeferredTs&&... dn)
 {
-  std::
-    tuple<deferred_result_of_t<DeferredT1>, deferred_result_of_t<DeferredT2>, deferred_result_of_t<OtherDeferredTs>...>
-      results;
-  return detail::create(
-    results,
+  return detail::create<
+    deferred_result_of_t<DeferredT1>,
+    deferred_result_of_t<DeferredT2>,
+    deferred_result_of_t<OtherDeferredTs>...>(
     std::forward_as_tuple(
       std::forward<DeferredT1>(d1), std::forward<DeferredT2>(d2), std::forward<OtherDeferredTs>(dn)...),
     std::make_index_sequence<sizeof...(OtherDeferredTs) + 2>{});
@@ -5,6 +5,9 @@
 #include <string_view>
 #include <utility>
 
+// Zen
+#include <zen/result/registry.hpp>
+
 namespace zen
 {
 namespace detail
@@ -65,6 +68,15 @@ public:
    */
   static constexpr std::string_view sv() { return std::string_view{message::c_str()}; }
 
+  /**
+   * @brief Returns identifier of this message in the message_registry, interning it on first use
+   */
+  static message_id id()
+  {
+    static const message_id id_storage = message_registry::instance().intern(sv());
+    return id_storage;
+  }
+
 private:
   /// Compile-time hashing result storage
   static constexpr std::size_t hash_storage = detail::hash_sequence<char, Elements...>();
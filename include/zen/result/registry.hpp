@@ -0,0 +1,232 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <thread>
+
+namespace zen
+{
+
+/**
+ * @brief Small integer which identifies a message for the lifetime of a process
+ */
+using message_id = std::uint32_t;
+
+/// Identifier of messages which could not be interned because the registry was full
+static constexpr message_id kNoMessageId = std::numeric_limits<message_id>::max();
+
+/**
+ * @brief Failure counts of an interned message, at some point in time
+ */
+struct message_counts
+{
+  /// Identifier of the message
+  message_id id = kNoMessageId;
+
+  /// Message text
+  std::string_view message;
+
+  /// Invalid results created with this message
+  std::uint64_t created = 0;
+
+  /// Invalid results passed on with this message by <code>operator|</code>, all() or any()
+  std::uint64_t propagated = 0;
+};
+
+/**
+ * @brief Process-wide registry which interns messages, and counts failures by message
+ *
+ * Every message type has its own string storage, so messages are interned by the address of their text. The first
+ * message interned gets identifier 0, the next 1, and so on. Interning and counting never lock; interning a message
+ * which has already been interned, and counting, take a handful of atomic operations.
+ */
+class message_registry
+{
+public:
+  /// Maximum number of distinct messages which may be interned
+  static constexpr std::size_t kCapacity = 1 << 10;
+
+  /**
+   * @brief Returns the registry of this process
+   */
+  static message_registry& instance()
+  {
+    static message_registry registry;
+    return registry;
+  }
+
+  message_registry(const message_registry&) = delete;
+  message_registry& operator=(const message_registry&) = delete;
+
+  /**
+   * @brief Returns identifier of <code>message</code>, interning it if it is new
+   *
+   * @param message  text of a message; only its address is compared, so it must come from a zen::message
+   *
+   * @return identifier, or kNoMessageId if the registry is full
+   */
+  message_id intern(std::string_view message)
+  {
+    entry* const e = find_or_add(message);
+    return (e == nullptr) ? kNoMessageId : e->id;
+  }
+
+  /**
+   * @brief Counts an invalid result created with message <code>id</code>
+   */
+  void created(message_id id)
+  {
+    if (id < kCapacity)
+    {
+      entries_[id].created.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Counts an invalid result passed on with <code>message</code>
+   */
+  void propagated(std::string_view message)
+  {
+    if (entry* const e = find_or_add(message); e != nullptr)
+    {
+      e->propagated.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Returns failure counts of <code>message</code>, interning it if it is new
+   */
+  [[nodiscard]] message_counts counts(std::string_view message)
+  {
+    const entry* const e = find_or_add(message);
+    return (e == nullptr) ? message_counts{kNoMessageId, message} : e->counts();
+  }
+
+  /**
+   * @brief Calls <code>fn(message_counts)</code> for each interned message, in order of identifier
+   */
+  template <typename FnT> void for_each(FnT&& fn) const
+  {
+    const std::size_t n = std::min(size_.load(std::memory_order_acquire), kCapacity);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+      // Skip messages which are being interned by other threads
+      if (entries_[i].ready.load(std::memory_order_acquire))
+      {
+        fn(entries_[i].counts());
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the number of interned messages
+   */
+  [[nodiscard]] std::size_t size() const { return std::min(size_.load(std::memory_order_acquire), kCapacity); }
+
+  /**
+   * @brief Zeroes all counters; identifiers are kept
+   */
+  void reset()
+  {
+    for (auto& e : entries_)
+    {
+      e.created.store(0, std::memory_order_relaxed);
+      e.propagated.store(0, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  message_registry() = default;
+
+  /**
+   * @brief Interned message, and its counters
+   */
+  struct entry
+  {
+    message_id id = kNoMessageId;
+    std::string_view message;
+    std::atomic<bool> ready{false};
+    std::atomic<std::uint64_t> created{0};
+    std::atomic<std::uint64_t> propagated{0};
+
+    [[nodiscard]] message_counts counts() const
+    {
+      return message_counts{
+        id, message, created.load(std::memory_order_relaxed), propagated.load(std::memory_order_relaxed)};
+    }
+  };
+
+  /**
+   * @brief Slot of the open-addressed table which maps message text addresses to entries
+   */
+  struct slot
+  {
+    std::atomic<const char*> key{nullptr};
+    std::atomic<entry*> value{nullptr};
+  };
+
+  static constexpr std::size_t kSlots = kCapacity * 2;
+  static constexpr std::size_t kMask = kSlots - 1;
+
+  /**
+   * @brief Returns entry of <code>message</code>, adding one if it is new, or <code>nullptr</code> if the registry is
+   *        full
+   */
+  entry* find_or_add(std::string_view message)
+  {
+    const char* const key = message.data();
+    const auto h = reinterpret_cast<std::uintptr_t>(key) * static_cast<std::uintptr_t>(0x9E3779B97F4A7C15ULL);
+    const auto first = static_cast<std::size_t>(h >> (std::numeric_limits<std::uintptr_t>::digits / 2));
+    for (std::size_t i = first & kMask, probes = 0; probes < kSlots; i = (i + 1) & kMask, ++probes)
+    {
+      slot& s = slots_[i];
+      const char* k = s.key.load(std::memory_order_acquire);
+      if (k == nullptr && s.key.compare_exchange_strong(k, key, std::memory_order_acq_rel))
+      {
+        // Claimed slot; publish a new entry, or mark the message as not interned
+        const std::size_t id = size_.fetch_add(1, std::memory_order_acq_rel);
+        entry* e = nullptr;
+        if (id < kCapacity)
+        {
+          e = &entries_[id];
+          e->id = static_cast<message_id>(id);
+          e->message = message;
+          e->ready.store(true, std::memory_order_release);
+        }
+        s.value.store((e == nullptr) ? &full_ : e, std::memory_order_release);
+        return e;
+      }
+      if (k == key)
+      {
+        // Wait for the thread which claimed the slot to publish its entry
+        entry* e = s.value.load(std::memory_order_acquire);
+        while (e == nullptr)
+        {
+          std::this_thread::yield();
+          e = s.value.load(std::memory_order_acquire);
+        }
+        return (e == &full_) ? nullptr : e;
+      }
+    }
+    return nullptr;
+  }
+
+  /// Entries, indexed by identifier
+  entry entries_[kCapacity];
+
+  /// Number of identifiers handed out; may exceed kCapacity once full
+  std::atomic<std::size_t> size_{0};
+
+  /// Address of message text to entry
+  slot slots_[kSlots];
+
+  /// Marks slots of messages which were not interned because the registry was full
+  entry full_;
+};
+
+}  // namespace zen
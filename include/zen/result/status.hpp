@@ -31,6 +31,11 @@ static constexpr auto Invalid = "invalid"_msg;
  */
 static constexpr auto Unknown = "unknown"_msg;
 
+/**
+ * @brief Standard message used to indicate that work was not run, because work it belongs to was cancelled
+ */
+static constexpr auto Cancelled = "cancelled"_msg;
+
 /**
  * @brief Indicates valid/invalid state with an associated message payload
  */
@@ -0,0 +1,6 @@
+#pragma once
+
+// Zen
+#include <zen/stage/coalesce.hpp>
+#include <zen/stage/memoize.hpp>
+#include <zen/stage/timed.hpp>
@@ -0,0 +1,39 @@
+#pragma once
+
+// C++ Standard Library
+#include <tuple>
+
+// Zen
+#include <zen/meta/arguments.hpp>
+
+namespace zen
+{
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Isolates argument types of a stage as a <code>std::tuple</code>: <code>ArgTs...</code>, if any were named,
+ *        or else those of <code>InvocableT</code>
+ */
+template <typename InvocableT, typename... ArgTs> struct stage_arguments
+{
+  using type = std::tuple<ArgTs...>;
+};
+
+template <typename InvocableT> struct stage_arguments<InvocableT>
+{
+  static_assert(
+    meta::has_arguments_v<InvocableT>,
+    "Argument types of a generic or overloaded invocable can not be deduced; name them as template arguments");
+
+  using type = meta::arguments_of_t<InvocableT>;
+};
+
+template <typename InvocableT, typename... ArgTs>
+using stage_arguments_t = typename stage_arguments<InvocableT, ArgTs...>::type;
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+}  // namespace zen
@@ -0,0 +1,203 @@
+#pragma once
+
+// C++ Standard Library
+#include <array>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// Zen
+#include <zen/result.hpp>
+#include <zen/stage/arguments.hpp>
+
+namespace zen
+{
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Table of in-flight executions, sharded by key hash
+ *
+ * Each shard is only locked to look up, insert or erase an in-flight entry; waiting on an in-flight execution
+ * happens outside of the shard lock.
+ */
+template <typename KeyT, typename ResultT> class coalesce_table
+{
+public:
+  template <typename FnT> ResultT run(const KeyT& key, FnT&& fn)
+  {
+    auto& shard = shards_[std::hash<KeyT>{}(key) % kShardCount];
+
+    std::shared_future<ResultT> flight;
+    std::optional<std::promise<ResultT>> leader;
+    {
+      std::lock_guard lock{shard.mtx};
+      if (const auto itr = shard.in_flight.find(key); itr != shard.in_flight.end())
+      {
+        flight = itr->second;
+      }
+      else
+      {
+        shard.in_flight.emplace(key, leader.emplace().get_future().share());
+      }
+    }
+
+    if (flight.valid())
+    {
+      coalesced_.fetch_add(1, std::memory_order_relaxed);
+      return flight.get();
+    }
+
+    executions_.fetch_add(1, std::memory_order_relaxed);
+    try
+    {
+      ResultT r{std::forward<FnT>(fn)()};
+      leader->set_value(r);
+      erase(shard, key);
+      return r;
+    }
+    catch (...)
+    {
+      leader->set_exception(std::current_exception());
+      erase(shard, key);
+      throw;
+    }
+  }
+
+  [[nodiscard]] std::size_t executions() const { return executions_.load(std::memory_order_relaxed); }
+
+  [[nodiscard]] std::size_t coalesced() const { return coalesced_.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::size_t kShardCount = 64;
+
+  struct alignas(64) shard_type
+  {
+    std::mutex mtx;
+    std::unordered_map<KeyT, std::shared_future<ResultT>> in_flight;
+  };
+
+  static void erase(shard_type& shard, const KeyT& key)
+  {
+    std::lock_guard lock{shard.mtx};
+    shard.in_flight.erase(key);
+  }
+
+  std::array<shard_type, kShardCount> shards_;
+  std::atomic<std::size_t> executions_{0};
+  std::atomic<std::size_t> coalesced_{0};
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Stage which shares one in-flight execution of an invocable between concurrent callers with equal keys
+ *
+ * Copies of a stage share the same in-flight table, so a stage may be created once and passed by value. The table
+ * is typed by the key and result types of the stage, so invoking a stage with arguments which map to other key or
+ * result types does not compile.
+ *
+ * @tparam InvocableT  invocable executed by the stage
+ * @tparam KeyInvocableT  invocable which maps stage arguments to a hashable, equality-comparable key
+ * @tparam KeyT  key type returned by <code>KeyInvocableT</code>
+ * @tparam ResultT  result type returned by the stage
+ */
+template <typename InvocableT, typename KeyInvocableT, typename KeyT, typename ResultT> class coalesce_stage
+{
+public:
+  constexpr coalesce_stage(InvocableT fn, KeyInvocableT key_fn) :
+      fn_{std::move(fn)}, key_fn_{std::move(key_fn)}, table_{std::make_shared<detail::coalesce_table<KeyT, ResultT>>()}
+  {}
+
+  /**
+   * @brief Invokes held invocable with <code>values</code>, or waits on an in-flight invocation with an equal key
+   *
+   * @return result, shared between all callers of the same in-flight invocation
+   */
+  template <
+    typename... ValueTs,
+    typename ValueKeyT = std::decay_t<std::invoke_result_t<const KeyInvocableT&, const ValueTs&...>>,
+    typename ValueResultT = to_result_t<std::decay_t<std::invoke_result_t<const InvocableT&, ValueTs&&...>>>>
+  ResultT operator()(ValueTs&&... values) const
+  {
+    static_assert(std::is_same_v<ValueKeyT, KeyT>, "Stage invoked with arguments which map to another key type");
+    static_assert(std::is_same_v<ValueResultT, ResultT>, "Stage invoked with arguments which return another type");
+    return table_->run(key_fn_(std::as_const(values)...), [&] { return fn_(std::forward<ValueTs>(values)...); });
+  }
+
+  /**
+   * @brief Returns the number of times the held invocable has been executed
+   */
+  [[nodiscard]] std::size_t executions() const { return table_->executions(); }
+
+  /**
+   * @brief Returns the number of invocations which were served by another caller's in-flight execution
+   */
+  [[nodiscard]] std::size_t coalesced() const { return table_->coalesced(); }
+
+private:
+  InvocableT fn_;
+  KeyInvocableT key_fn_;
+  std::shared_ptr<detail::coalesce_table<KeyT, ResultT>> table_;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Selects the coalesce_stage type of invocables which take arguments <code>ArgumentTupleT</code>
+ */
+template <typename InvocableT, typename KeyInvocableT, typename ArgumentTupleT> struct coalesce_stage_for;
+
+template <typename InvocableT, typename KeyInvocableT, typename... ArgTs>
+struct coalesce_stage_for<InvocableT, KeyInvocableT, std::tuple<ArgTs...>>
+{
+  using type = coalesce_stage<
+    InvocableT,
+    KeyInvocableT,
+    std::decay_t<std::invoke_result_t<const KeyInvocableT&, const ArgTs&...>>,
+    to_result_t<std::decay_t<std::invoke_result_t<const InvocableT&, ArgTs&&...>>>>;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Creates a stage where concurrent invocations with equal keys share one in-flight execution of
+ * <code>fn</code>, and every waiter receives the same result<T>, valid or not
+ *
+ * Key and result types of the stage are fixed by the arguments of <code>fn</code>; name argument types
+ * <code>ArgTs...</code> if <code>fn</code> is generic, e.g. <code>coalesce<int>(fn, key_fn)</code>.
+ *
+@verbatim
+  const auto load = coalesce(
+    [](int key) -> result<std::string> { return load_from_database(key); },
+    [](int key) { return key; });
+
+  // Concurrent callers with the same key only hit the database once
+  auto r = pass(key) | load | parse;
+@endverbatim
+ */
+template <typename... ArgTs, typename InvocableT, typename KeyInvocableT>
+constexpr decltype(auto) coalesce(InvocableT&& fn, KeyInvocableT&& key_fn)
+{
+  using stage_type = typename detail::coalesce_stage_for<
+    std::decay_t<InvocableT>,
+    std::decay_t<KeyInvocableT>,
+    detail::stage_arguments_t<std::decay_t<InvocableT>, ArgTs...>>::type;
+  return stage_type{std::forward<InvocableT>(fn), std::forward<KeyInvocableT>(key_fn)};
+}
+
+}  // namespace zen
@@ -0,0 +1,354 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+// Zen
+#include <zen/result.hpp>
+#include <zen/stage/arguments.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Entry eviction strategies available to memoizing stages
+ */
+enum class memoize_eviction
+{
+  /// Evicts least-recently used entries; cache hits take an exclusive shard lock to update recency
+  lru,
+  /// Evicts entries with a CLOCK (second-chance) sweep; cache hits only take a shared shard lock
+  clock
+};
+
+/**
+ * @brief Configures a memoizing stage
+ */
+struct memoize_policy
+{
+  /// Entry eviction strategy
+  memoize_eviction eviction = memoize_eviction::lru;
+
+  /// Time after which cached entries expire; zero disables expiry
+  std::chrono::nanoseconds ttl = std::chrono::nanoseconds::zero();
+
+  /// Caches invalid results as well as valid ones (negative caching)
+  bool cache_invalid = false;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Hashes a tuple of stage arguments by combining <code>std::hash</code> of each element
+ */
+struct tuple_hash
+{
+  template <typename... Ts> std::size_t operator()(const std::tuple<Ts...>& t) const
+  {
+    return std::apply(
+      [](const auto&... elements) {
+        std::size_t h = 0;
+        ((h ^= std::hash<std::decay_t<decltype(elements)>>{}(elements) + 0x9e3779b97f4a7c15UL + (h << 6) + (h >> 2)),
+         ...);
+        return h;
+      },
+      t);
+  }
+};
+
+/**
+ * @brief Bounded cache of stage results, sharded by argument hash
+ */
+template <typename KeyT, typename ResultT> class memoize_cache
+{
+public:
+  memoize_cache(std::size_t capacity, const memoize_policy& policy) :
+      policy_{policy},
+      shard_count_{std::clamp<std::size_t>(capacity, 1, kMaxShardCount)},
+      shards_{std::make_unique<shard_type[]>(shard_count_)}
+  {
+    // Distribute capacity across shards such that total capacity is exact
+    for (std::size_t i = 0; i < shard_count_; ++i)
+    {
+      shards_[i].capacity = capacity / shard_count_ + (i < (capacity % shard_count_));
+    }
+  }
+
+  template <typename FnT> ResultT get_or_compute(KeyT&& key, FnT&& fn)
+  {
+    const std::size_t index = tuple_hash{}(key) % shard_count_;
+    auto& shard = shards_[index];
+    auto& counters = counters_[index];
+
+    const auto now = clock_type::now();
+    if (policy_.eviction == memoize_eviction::clock)
+    {
+      std::shared_lock lock{shard.mtx};
+      if (const auto itr = shard.index.find(key); itr != shard.index.end() && !expired(*itr->second, now))
+      {
+        itr->second->referenced.store(true, std::memory_order_relaxed);
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return itr->second->value;
+      }
+    }
+    else
+    {
+      std::lock_guard lock{shard.mtx};
+      if (const auto itr = shard.index.find(key); itr != shard.index.end() && !expired(*itr->second, now))
+      {
+        shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+        counters.hits.fetch_add(1, std::memory_order_relaxed);
+        return itr->second->value;
+      }
+    }
+
+    counters.misses.fetch_add(1, std::memory_order_relaxed);
+
+    ResultT r{std::forward<FnT>(fn)()};
+    if (shard.capacity > 0 && (r.valid() || policy_.cache_invalid))
+    {
+      std::lock_guard lock{shard.mtx};
+      insert(shard, counters, std::move(key), r, now);
+    }
+    return r;
+  }
+
+  [[nodiscard]] std::size_t hits() const { return sum(&counters_type::hits); }
+
+  [[nodiscard]] std::size_t misses() const { return sum(&counters_type::misses); }
+
+  [[nodiscard]] std::size_t evictions() const { return sum(&counters_type::evictions); }
+
+private:
+  using clock_type = std::chrono::steady_clock;
+
+  static constexpr std::size_t kMaxShardCount = 16;
+
+  /**
+   * @brief Counters of a shard, on their own cache line
+   */
+  struct alignas(64) counters_type
+  {
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> evictions{0};
+  };
+
+  struct entry_type
+  {
+    entry_type(const KeyT& _key, const ResultT& _value, clock_type::time_point _expires) :
+        key{_key}, value{_value}, expires{_expires}
+    {}
+
+    KeyT key;
+    ResultT value;
+    clock_type::time_point expires;
+    std::atomic<bool> referenced{false};
+  };
+
+  using entry_list_type = std::list<entry_type>;
+
+  struct shard_type
+  {
+    std::shared_mutex mtx;
+    std::size_t capacity = 0;
+    entry_list_type entries;
+    std::unordered_map<KeyT, typename entry_list_type::iterator, tuple_hash> index;
+    typename entry_list_type::iterator hand = entries.end();
+  };
+
+  bool expired(const entry_type& entry, clock_type::time_point now) const
+  {
+    return policy_.ttl != std::chrono::nanoseconds::zero() && entry.expires <= now;
+  }
+
+  void insert(shard_type& shard, counters_type& counters, KeyT&& key, const ResultT& r, clock_type::time_point now)
+  {
+    const auto expires = now + policy_.ttl;
+
+    // Refresh entry which was inserted concurrently, or which has expired
+    if (const auto itr = shard.index.find(key); itr != shard.index.end())
+    {
+      itr->second->value = r;
+      itr->second->expires = expires;
+      return;
+    }
+
+    if (shard.entries.size() >= shard.capacity)
+    {
+      evict(shard);
+      counters.evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (policy_.eviction == memoize_eviction::clock)
+    {
+      // New entries are placed just behind the hand, so they are swept last
+      const auto itr = shard.entries.emplace(shard.hand, key, r, expires);
+      shard.index.emplace(std::move(key), itr);
+    }
+    else
+    {
+      shard.entries.emplace_front(key, r, expires);
+      shard.index.emplace(std::move(key), shard.entries.begin());
+    }
+  }
+
+  void evict(shard_type& shard)
+  {
+    auto victim = std::prev(shard.entries.end());
+    if (policy_.eviction == memoize_eviction::clock)
+    {
+      // Give referenced entries a second chance
+      for (;; ++shard.hand)
+      {
+        if (shard.hand == shard.entries.end())
+        {
+          shard.hand = shard.entries.begin();
+        }
+        if (!shard.hand->referenced.exchange(false, std::memory_order_relaxed))
+        {
+          break;
+        }
+      }
+      victim = shard.hand++;
+    }
+    shard.index.erase(victim->key);
+    shard.entries.erase(victim);
+  }
+
+  std::size_t sum(std::atomic<std::size_t> counters_type::*counter) const
+  {
+    std::size_t total = 0;
+    for (const auto& c : counters_)
+    {
+      total += (c.*counter).load(std::memory_order_relaxed);
+    }
+    return total;
+  }
+
+  memoize_policy policy_;
+  std::size_t shard_count_;
+  std::unique_ptr<shard_type[]> shards_;
+
+  /// Counters of each shard, summed on read
+  std::array<counters_type, kMaxShardCount> counters_;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Stage which returns cached results for repeated arguments
+ *
+ * Copies of a stage share the same cache, so a stage may be created once and passed by value. The cache is typed by
+ * the argument and result types of the stage, so invoking a stage with arguments which map to another result type
+ * does not compile.
+ *
+ * @tparam InvocableT  invocable executed by the stage on cache misses; should be a pure function of its arguments
+ * @tparam KeyT  <code>std::tuple</code> of argument types of the stage, by which results are cached
+ * @tparam ResultT  result type returned by the stage
+ */
+template <typename InvocableT, typename KeyT, typename ResultT> class memoize_stage
+{
+public:
+  memoize_stage(InvocableT fn, std::size_t capacity, const memoize_policy& policy) :
+      fn_{std::move(fn)}, cache_{std::make_shared<detail::memoize_cache<KeyT, ResultT>>(capacity, policy)}
+  {}
+
+  /**
+   * @brief Returns cached result for <code>values</code>, or invokes held invocable and caches its result
+   *
+   * Arguments must be copyable, hashable with <code>std::hash</code> and equality comparable.
+   */
+  template <
+    typename... ValueTs,
+    typename ValueResultT = to_result_t<std::decay_t<std::invoke_result_t<const InvocableT&, ValueTs&&...>>>>
+  ResultT operator()(ValueTs&&... values) const
+  {
+    static_assert(std::is_same_v<ValueResultT, ResultT>, "Stage invoked with arguments which return another type");
+    return cache_->get_or_compute(KeyT{values...}, [&] { return fn_(std::forward<ValueTs>(values)...); });
+  }
+
+  /**
+   * @brief Returns the number of invocations served from the cache
+   */
+  [[nodiscard]] std::size_t hits() const { return cache_->hits(); }
+
+  /**
+   * @brief Returns the number of invocations which executed the held invocable
+   */
+  [[nodiscard]] std::size_t misses() const { return cache_->misses(); }
+
+  /**
+   * @brief Returns the number of entries evicted to make room for new ones
+   */
+  [[nodiscard]] std::size_t evictions() const { return cache_->evictions(); }
+
+private:
+  InvocableT fn_;
+  std::shared_ptr<detail::memoize_cache<KeyT, ResultT>> cache_;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Selects the memoize_stage type of an invocable which takes arguments <code>ArgumentTupleT</code>
+ */
+template <typename InvocableT, typename ArgumentTupleT> struct memoize_stage_for;
+
+template <typename InvocableT, typename... ArgTs> struct memoize_stage_for<InvocableT, std::tuple<ArgTs...>>
+{
+  using type = memoize_stage<
+    InvocableT,
+    std::tuple<std::decay_t<ArgTs>...>,
+    to_result_t<std::decay_t<std::invoke_result_t<const InvocableT&, ArgTs&&...>>>>;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Creates a stage which caches up to <code>capacity</code> results of <code>fn</code>, keyed by its arguments
+ *
+ * Key and result types of the stage are fixed by the arguments of <code>fn</code>; name argument types
+ * <code>ArgTs...</code> if <code>fn</code> is generic, e.g. <code>memoize<int>(fn, 1024)</code>.
+ *
+@verbatim
+  const auto lookup = memoize(
+    [](int key) -> result<float> { return expensive_pure_function(key); },
+    1024,
+    memoize_policy{memoize_eviction::clock, std::chrono::seconds{10}});
+
+  auto r = pass(key) | lookup | [](float value) -> result<float> { return 2.f * value; };
+
+  std::cout << lookup.hits() << '/' << (lookup.hits() + lookup.misses()) << std::endl;
+@endverbatim
+ */
+template <typename... ArgTs, typename InvocableT>
+decltype(auto) memoize(InvocableT&& fn, std::size_t capacity, const memoize_policy& policy = memoize_policy{})
+{
+  using stage_type = typename detail::memoize_stage_for<
+    std::decay_t<InvocableT>,
+    detail::stage_arguments_t<std::decay_t<InvocableT>, ArgTs...>>::type;
+  return stage_type{std::forward<InvocableT>(fn), capacity, policy};
+}
+
+}  // namespace zen
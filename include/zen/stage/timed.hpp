@@ -0,0 +1,253 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Zen
+#include <zen/meta/is_specialization.hpp>
+#include <zen/result.hpp>
+#include <zen/utility/hdr_histogram.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Latency of a timed stage, split by outcome, at some point in time
+ */
+struct stage_latency
+{
+  /// Name of the stage
+  std::string_view name;
+
+  /// Time taken by invocations which returned a valid result
+  hdr_histogram valid;
+
+  /// Time taken by invocations which returned an invalid result
+  hdr_histogram invalid;
+};
+
+/**
+ * @brief <code>std::ostream</code> overload for stage_latency
+ */
+inline std::ostream& operator<<(std::ostream& os, const stage_latency& l)
+{
+  const auto write = [&os](const char* outcome, const hdr_histogram& h) {
+    os << ' ' << outcome << ": count=" << h.count() << " p50=" << h.percentile(0.50).count()
+       << "ns p99=" << h.percentile(0.99).count() << "ns p999=" << h.percentile(0.999).count()
+       << "ns max=" << h.max().count() << "ns";
+  };
+  os << l.name;
+  write("valid", l.valid);
+  write("invalid", l.invalid);
+  return os;
+}
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Hands out small indices to threads; indices of exited threads are handed out again
+ */
+class thread_slots
+{
+public:
+  static thread_slots& instance()
+  {
+    static thread_slots slots;
+    return slots;
+  }
+
+  std::size_t acquire()
+  {
+    std::lock_guard lock{mtx_};
+    if (free_.empty())
+    {
+      return next_++;
+    }
+    const std::size_t slot = free_.back();
+    free_.pop_back();
+    return slot;
+  }
+
+  void release(std::size_t slot)
+  {
+    std::lock_guard lock{mtx_};
+    free_.push_back(slot);
+  }
+
+private:
+  std::mutex mtx_;
+  std::vector<std::size_t> free_;
+  std::size_t next_ = 0;
+};
+
+/**
+ * @brief Returns index of the calling thread, which no other live thread has
+ */
+inline std::size_t thread_slot()
+{
+  struct owner
+  {
+    const std::size_t slot = thread_slots::instance().acquire();
+    ~owner() { thread_slots::instance().release(slot); }
+  };
+  static thread_local const owner local;
+  return local.slot;
+}
+
+/**
+ * @brief Latency histograms of a timed stage; each thread records into histograms of its own
+ */
+class timed_state
+{
+public:
+  /// Number of threads which record without locking; others share histograms under a lock
+  static constexpr std::size_t kSlots = 256;
+
+  void record(std::chrono::nanoseconds elapsed, bool valid)
+  {
+    const std::size_t slot = thread_slot();
+    if (slot < kSlots)
+    {
+      recorder* r = slots_[slot].load(std::memory_order_acquire);
+      if (r == nullptr)
+      {
+        r = add(slot);
+      }
+      (valid ? r->valid : r->invalid).record(elapsed);
+    }
+    else
+    {
+      std::lock_guard lock{mtx_};
+      (valid ? shared_.valid : shared_.invalid).record(elapsed);
+    }
+  }
+
+  stage_latency merge(std::string_view name) const
+  {
+    stage_latency l{name};
+    std::lock_guard lock{mtx_};
+    for (const auto& r : recorders_)
+    {
+      l.valid.merge(r->valid);
+      l.invalid.merge(r->invalid);
+    }
+    l.valid.merge(shared_.valid);
+    l.invalid.merge(shared_.invalid);
+    return l;
+  }
+
+private:
+  struct recorder
+  {
+    hdr_histogram valid;
+    hdr_histogram invalid;
+  };
+
+  recorder* add(std::size_t slot)
+  {
+    std::lock_guard lock{mtx_};
+    recorder* const r = recorders_.emplace_back(std::make_unique<recorder>()).get();
+    slots_[slot].store(r, std::memory_order_release);
+    return r;
+  }
+
+  /// Histograms of each thread, by thread slot; kept when threads exit, and reused by threads given the same slot
+  std::atomic<recorder*> slots_[kSlots] = {};
+
+  /// Guards recorders_ and shared_
+  mutable std::mutex mtx_;
+
+  /// Owns histograms of each thread
+  std::vector<std::unique_ptr<recorder>> recorders_;
+
+  /// Histograms shared by threads without a slot of their own
+  recorder shared_;
+};
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Stage which records how long its invocable takes, split by whether it returned a valid result
+ *
+ * Copies of a stage share the same histograms, so a stage may be created once and passed by value.
+ *
+ * @tparam MessageT  message type which names the stage
+ * @tparam InvocableT  invocable executed by the stage
+ */
+template <typename MessageT, typename InvocableT> class timed_stage
+{
+public:
+  explicit timed_stage(InvocableT fn) : fn_{std::move(fn)}, state_{std::make_shared<detail::timed_state>()} {}
+
+  /**
+   * @brief Invokes held invocable with <code>values</code>, and records how long it took
+   *
+   * Only takes part in overload resolution when the held invocable does, so that dispatches pass handles to timed
+   * branches exactly when they would to the branch itself.
+   */
+  template <typename... ValueTs>
+  auto operator()(ValueTs&&... values) const -> std::decay_t<std::invoke_result_t<const InvocableT&, ValueTs&&...>>
+  {
+    const auto start = std::chrono::steady_clock::now();
+    auto r = fn_(std::forward<ValueTs>(values)...);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    if constexpr (meta::is_specialization_v<decltype(r), result>)
+    {
+      state_->record(elapsed, r.valid());
+    }
+    else
+    {
+      state_->record(elapsed, true);
+    }
+    return r;
+  }
+
+  /**
+   * @brief Returns name of the stage
+   */
+  [[nodiscard]] static constexpr std::string_view name() { return MessageT::sv(); }
+
+  /**
+   * @brief Returns latency histograms recorded by all threads so far, merged
+   */
+  [[nodiscard]] stage_latency latency() const { return state_->merge(name()); }
+
+private:
+  InvocableT fn_;
+  std::shared_ptr<detail::timed_state> state_;
+};
+
+/**
+ * @brief Creates a stage which records latency of <code>fn</code>, named by a message
+ *
+ * Works as a stage of <code>operator|</code>, and as a branch of <code>all</code> and <code>any</code>. Recording
+ * reads the clock twice, and updates histograms local to the calling thread; no strings are touched.
+ *
+@verbatim
+  const auto parse = timed("parse"_msg, [](const std::string& s) -> result<int> { return std::stoi(s); });
+
+  auto r = pass(line) | parse | [](int value) -> result<int> { return 2 * value; };
+
+  const auto l = parse.latency();
+  std::cout << l.name << " p999: " << l.valid.percentile(0.999).count() << "ns" << std::endl;
+@endverbatim
+ */
+template <char... C, typename InvocableT> decltype(auto) timed(message<C...>, InvocableT&& fn)
+{
+  return timed_stage<message<C...>, std::decay_t<InvocableT>>{std::forward<InvocableT>(fn)};
+}
+
+}  // namespace zen
@@ -0,0 +1,9 @@
+#pragma once
+
+// Zen
+#include <zen/stream/buffered_writer.hpp>
+#include <zen/stream/line_source.hpp>
+#include <zen/stream/mapped_file.hpp>
+#include <zen/stream/pump.hpp>
+#include <zen/stream/read_ahead.hpp>
+#include <zen/stream/source.hpp>
@@ -0,0 +1,120 @@
+#pragma once
+
+// C++ Standard Library
+#include <cerrno>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// POSIX
+#include <unistd.h>
+
+namespace zen
+{
+
+/**
+ * @brief Writes to a file descriptor in batches, through a buffer
+ *
+ * Writes are appended to the buffer, which is written out with a single system call once the next write would not
+ * fit; writes which could not fit into an empty buffer go straight to the file descriptor. The buffer is flushed
+ * when the writer is destroyed. The file descriptor is not owned.
+ */
+class buffered_writer
+{
+public:
+  /// Default buffer size, in bytes
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+
+  explicit buffered_writer(int fd, std::size_t capacity = kDefaultCapacity) : fd_{fd}, capacity_{capacity}
+  {
+    buffer_.reserve(capacity_);
+  }
+
+  buffered_writer(const buffered_writer&) = delete;
+  buffered_writer& operator=(const buffered_writer&) = delete;
+
+  ~buffered_writer() { flush(); }
+
+  /**
+   * @brief Writes <code>data</code>
+   *
+   * @return <code>false</code> if this, or any earlier write, failed
+   */
+  bool write(std::string_view data)
+  {
+    if (buffer_.size() + data.size() > capacity_)
+    {
+      flush();
+      if (data.size() >= capacity_)
+      {
+        return write_all(data.data(), data.size());
+      }
+    }
+    buffer_.insert(buffer_.end(), data.begin(), data.end());
+    return !failed_;
+  }
+
+  /**
+   * @brief Writes <code>line</code>, followed by <code>delimiter</code>
+   *
+   * @return <code>false</code> if this, or any earlier write, failed
+   */
+  bool write_line(std::string_view line, char delimiter = '\n')
+  {
+    write(line);
+    return write(std::string_view{&delimiter, 1});
+  }
+
+  /**
+   * @brief Writes out everything buffered
+   *
+   * @return <code>false</code> if this, or any earlier write, failed
+   */
+  bool flush()
+  {
+    if (!buffer_.empty())
+    {
+      write_all(buffer_.data(), buffer_.size());
+      buffer_.clear();
+    }
+    return !failed_;
+  }
+
+  /**
+   * @brief Returns <code>true</code> if any write to the file descriptor failed
+   */
+  [[nodiscard]] bool failed() const { return failed_; }
+
+  /**
+   * @brief Returns number of system calls made to write to the file descriptor
+   */
+  [[nodiscard]] std::size_t system_calls() const { return system_calls_; }
+
+private:
+  bool write_all(const char* data, std::size_t size)
+  {
+    while (size > 0 && !failed_)
+    {
+      ++system_calls_;
+      const ::ssize_t n = ::write(fd_, data, size);
+      if (n >= 0)
+      {
+        data += n;
+        size -= static_cast<std::size_t>(n);
+      }
+      else if (errno != EINTR)
+      {
+        failed_ = true;
+      }
+    }
+    return !failed_;
+  }
+
+  int fd_;
+  std::size_t capacity_;
+  std::vector<char> buffer_;
+  std::size_t system_calls_ = 0;
+  bool failed_ = false;
+};
+
+}  // namespace zen
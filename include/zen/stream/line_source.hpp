@@ -0,0 +1,133 @@
+#pragma once
+
+// C++ Standard Library
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <vector>
+
+// POSIX
+#include <unistd.h>
+
+namespace zen
+{
+
+/**
+ * @brief Source which reads lines from a file descriptor, through a buffer
+ *
+ * Reads fill the buffer as far as they can, so that many lines are read per system call; the buffer grows to fit
+ * lines longer than it. A final line need not be followed by a delimiter. The file descriptor is not owned.
+ */
+class line_source
+{
+public:
+  using item_type = std::string;
+
+  /// Default buffer size, in bytes
+  static constexpr std::size_t kDefaultCapacity = 64 * 1024;
+
+  explicit line_source(int fd, std::size_t capacity = kDefaultCapacity, char delimiter = '\n') :
+      fd_{fd}, buffer_(capacity == 0 ? 1 : capacity), delimiter_{delimiter}
+  {}
+
+  /**
+   * @brief Returns next line, without its delimiter, or nothing once the file descriptor has no more to read
+   */
+  [[nodiscard]] std::optional<std::string> next()
+  {
+    while (true)
+    {
+      // Only look through bytes which were not looked through already, so that long lines are scanned once
+      const char* const first = buffer_.data() + begin_;
+      const auto* const last =
+        static_cast<const char*>(std::memchr(buffer_.data() + scanned_, delimiter_, end_ - scanned_));
+      if (last != nullptr)
+      {
+        std::string line{first, last};
+        begin_ = scanned_ = static_cast<std::size_t>(last - buffer_.data()) + 1;
+        return line;
+      }
+      scanned_ = end_;
+
+      if (eof_)
+      {
+        if (begin_ == end_)
+        {
+          return std::nullopt;
+        }
+        std::string line{first, end_ - begin_};
+        begin_ = scanned_ = end_;
+        return line;
+      }
+
+      fill();
+    }
+  }
+
+  /**
+   * @brief Returns <code>true</code> if reading stopped because of an error, rather than the end of the file
+   */
+  [[nodiscard]] bool failed() const { return failed_; }
+
+private:
+  /**
+   * @brief Reads as much as fits into the buffer, after moving unread bytes to its front
+   */
+  void fill()
+  {
+    if (begin_ > 0)
+    {
+      std::memmove(buffer_.data(), buffer_.data() + begin_, end_ - begin_);
+      end_ -= begin_;
+      scanned_ -= begin_;
+      begin_ = 0;
+    }
+
+    if (end_ == buffer_.size())
+    {
+      buffer_.resize(2 * buffer_.size());
+    }
+
+    const ::ssize_t n = ::read(fd_, buffer_.data() + end_, buffer_.size() - end_);
+    if (n > 0)
+    {
+      end_ += static_cast<std::size_t>(n);
+    }
+    else if (n == 0)
+    {
+      eof_ = true;
+    }
+    else if (errno != EINTR)
+    {
+      eof_ = failed_ = true;
+    }
+  }
+
+  int fd_;
+  std::vector<char> buffer_;
+  char delimiter_;
+
+  /// Start of unread bytes
+  std::size_t begin_ = 0;
+
+  /// End of unread bytes which were already searched for a delimiter
+  std::size_t scanned_ = 0;
+
+  /// End of bytes read
+  std::size_t end_ = 0;
+
+  bool eof_ = false;
+  bool failed_ = false;
+};
+
+/**
+ * @brief Creates a source of lines read from <code>fd</code>, which must outlive the source
+ */
+inline line_source lines(int fd, std::size_t capacity = line_source::kDefaultCapacity, char delimiter = '\n')
+{
+  return line_source{fd, capacity, delimiter};
+}
+
+}  // namespace zen
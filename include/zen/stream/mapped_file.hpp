@@ -0,0 +1,165 @@
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+// POSIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Zen
+#include <zen/result.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Copies share the same mapping, which is unmapped along with the last of them; views of its contents remain valid
+ * until then.
+ */
+class mapped_file
+{
+public:
+  /**
+   * @brief Maps the file at <code>path</code>
+   *
+   * @return mapped file, or an invalid result if the file could not be opened or mapped
+   */
+  [[nodiscard]] static result<mapped_file> open(const char* path)
+  {
+    const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+      return "failed to open file"_msg;
+    }
+
+    struct ::stat info;
+    if (::fstat(fd, &info) != 0)
+    {
+      ::close(fd);
+      return "failed to stat file"_msg;
+    }
+
+    // Empty files can not be mapped, and have no records anyway
+    const auto size = static_cast<std::size_t>(info.st_size);
+    if (size == 0)
+    {
+      ::close(fd);
+      return mapped_file{std::make_shared<const mapping>(nullptr, 0)};
+    }
+
+    void* const addr = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED)
+    {
+      return "failed to map file"_msg;
+    }
+
+    // Records are read front to back, so let the kernel read ahead aggressively
+    ::madvise(addr, size, MADV_SEQUENTIAL);
+    return mapped_file{std::make_shared<const mapping>(addr, size)};
+  }
+
+  /**
+   * @brief Returns contents of the file
+   */
+  [[nodiscard]] std::string_view data() const
+  {
+    return std::string_view{static_cast<const char*>(mapping_->addr), mapping_->size};
+  }
+
+  /**
+   * @brief Returns size of the file, in bytes
+   */
+  [[nodiscard]] std::size_t size() const { return mapping_->size; }
+
+private:
+  struct mapping
+  {
+    mapping(void* a, std::size_t s) : addr{a}, size{s} {}
+
+    ~mapping()
+    {
+      if (addr != nullptr)
+      {
+        ::munmap(addr, size);
+      }
+    }
+
+    void* addr;
+    std::size_t size;
+  };
+
+  explicit mapped_file(std::shared_ptr<const mapping> m) : mapping_{std::move(m)} {}
+
+  std::shared_ptr<const mapping> mapping_;
+};
+
+/**
+ * @brief Source which splits a mapped file into records, separated by a delimiter
+ *
+ * Records are views into the mapping, which the source keeps alive; nothing is copied. A final record need not be
+ * followed by a delimiter.
+ */
+class record_source
+{
+public:
+  using item_type = std::string_view;
+
+  record_source(mapped_file file, char delimiter) : file_{std::move(file)}, delimiter_{delimiter} {}
+
+  /**
+   * @brief Returns next record, without its delimiter, or nothing past the end of the file
+   */
+  [[nodiscard]] std::optional<std::string_view> next()
+  {
+    const std::string_view data = file_.data();
+    if (position_ >= data.size())
+    {
+      return std::nullopt;
+    }
+
+    const char* const first = data.data() + position_;
+    const auto* const last =
+      static_cast<const char*>(std::memchr(first, delimiter_, data.size() - position_));
+    const std::size_t length = (last == nullptr) ? (data.size() - position_) : static_cast<std::size_t>(last - first);
+    position_ += length + 1;
+    return std::string_view{first, length};
+  }
+
+  /**
+   * @brief Returns mapped file which records are read from
+   */
+  [[nodiscard]] const mapped_file& file() const { return file_; }
+
+private:
+  mapped_file file_;
+  char delimiter_;
+  std::size_t position_ = 0;
+};
+
+/**
+ * @brief Creates a source of records of <code>file</code>, separated by <code>delimiter</code>
+ *
+@verbatim
+  auto file = mapped_file::open("/tmp/values.txt");
+  if (file.valid())
+  {
+    auto source = records(*file);
+  }
+@endverbatim
+ */
+inline record_source records(mapped_file file, char delimiter = '\n')
+{
+  return record_source{std::move(file), delimiter};
+}
+
+}  // namespace zen
@@ -0,0 +1,119 @@
+#pragma once
+
+// C++ Standard Library
+#include <cstddef>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/result.hpp>
+#include <zen/stream/buffered_writer.hpp>
+#include <zen/stream/source.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Numbers of items pumped from a source, split by outcome
+ */
+struct pump_counts
+{
+  /// Items pulled from the source
+  std::size_t items = 0;
+
+  /// Items for which the pipeline returned a valid result, which was passed to the sink
+  std::size_t valid = 0;
+
+  /// Items for which the pipeline returned an invalid result, whose status was passed to the status sink
+  std::size_t invalid = 0;
+};
+
+/**
+ * @brief <code>std::ostream</code> overload for pump_counts
+ */
+inline std::ostream& operator<<(std::ostream& os, const pump_counts& c)
+{
+  return os << "{items=" << c.items << " valid=" << c.valid << " invalid=" << c.invalid << '}';
+}
+
+/**
+ * @brief Pulls every item of <code>source</code>, and runs it through <code>pipeline</code>
+ *
+ * Values of valid results are moved into <code>sink</code>; statuses of invalid results are passed to
+ * <code>status_sink</code>. Items are pumped one at a time, on the calling thread; wrap the source with read_ahead to
+ * read items while others are running through the pipeline.
+ *
+@verbatim
+  std::vector<int> values;
+  const auto counts = pump(
+    read_ahead(tp, lines(fd), 256),
+    [](std::string&& line) { return pass(std::move(line)) | parse | validate; },
+    collect(values),
+    [](const result_status& s) { std::cerr << s << std::endl; });
+@endverbatim
+ *
+ * @param source  source of items
+ * @param pipeline  invocable which takes an item, and returns a result; typically an <code>operator|</code> chain
+ *                  which starts with <code>pass(item)</code>
+ * @param sink  invocable which takes values of valid results
+ * @param status_sink  invocable which takes statuses of invalid results
+ *
+ * @return numbers of items pumped, split by outcome
+ */
+template <typename SourceT, typename PipelineT, typename SinkT, typename StatusSinkT>
+pump_counts pump(SourceT&& source, PipelineT&& pipeline, SinkT&& sink, StatusSinkT&& status_sink)
+{
+  using result_type = to_result_t<std::decay_t<std::invoke_result_t<PipelineT&, source_item_t<SourceT>&&>>>;
+
+  pump_counts counts;
+  while (auto item = source.next())
+  {
+    ++counts.items;
+    result_type r = pipeline(std::move(*item));
+    if (r.valid())
+    {
+      ++counts.valid;
+      sink(std::move(*r));
+    }
+    else
+    {
+      ++counts.invalid;
+      status_sink(r.status());
+    }
+  }
+  return counts;
+}
+
+/**
+ * @copydoc pump
+ *
+ * Invalid results are only counted.
+ */
+template <typename SourceT, typename PipelineT, typename SinkT>
+pump_counts pump(SourceT&& source, PipelineT&& pipeline, SinkT&& sink)
+{
+  const auto ignore = [](const result_status&) {};
+  return pump(std::forward<SourceT>(source), std::forward<PipelineT>(pipeline), std::forward<SinkT>(sink), ignore);
+}
+
+/**
+ * @brief Creates a sink which appends values to <code>container</code>
+ */
+template <typename ContainerT> auto collect(ContainerT& container)
+{
+  return [&container](auto&& value) { container.push_back(std::forward<decltype(value)>(value)); };
+}
+
+/**
+ * @brief Creates a sink which writes values, as lines, with <code>writer</code>
+ *
+ * Values must be convertible to <code>std::string_view</code>.
+ */
+inline auto write_lines(buffered_writer& writer, char delimiter = '\n')
+{
+  return [&writer, delimiter](std::string_view line) { writer.write_line(line, delimiter); };
+}
+
+}  // namespace zen
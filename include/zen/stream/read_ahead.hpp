@@ -0,0 +1,208 @@
+#pragma once
+
+// C++ Standard Library
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+// Zen
+#include <zen/executor/executor.hpp>
+#include <zen/stream/source.hpp>
+
+namespace zen
+{
+
+/**
+ * @brief Source which pulls items from another source on an executor, ahead of when they are asked for
+ *
+ * Once no more than half of <code>depth</code> items are buffered, work is submitted which pulls items until
+ * <code>depth</code> are buffered, or the source is exhausted; items are handed over as they are pulled. Pulls from
+ * the wrapped source happen in one piece of work at a time, so the source needs no synchronization of its own.
+ * \n
+ * Reads thereby overlap with whatever the caller does with items, e.g. running them through a pipeline, without
+ * holding on to a worker between reads.
+ * \n
+ * If the wrapped source throws, reading stops, and next() rethrows the exception once items read before it are
+ * handed over.
+ *
+ * @tparam SourceT  wrapped source type
+ * @tparam ExecutorT  executor implementation type
+ */
+template <typename SourceT, typename ExecutorT> class read_ahead_source
+{
+public:
+  using item_type = source_item_t<SourceT>;
+
+  read_ahead_source(exec::executor<ExecutorT>& e, SourceT source, std::size_t depth) :
+      e_{std::addressof(e)}, state_{std::make_shared<state>(std::move(source), (depth == 0) ? 1 : depth)}
+  {}
+
+  read_ahead_source(read_ahead_source&&) = default;
+  read_ahead_source& operator=(read_ahead_source&&) = default;
+
+  /**
+   * @brief Stops reading ahead, and waits for read work which was already submitted to stop, after its next item
+   *
+   * The wrapped source is no longer touched once this returns, so resources it reads from may be released.
+   */
+  ~read_ahead_source()
+  {
+    if (state_ != nullptr)
+    {
+      auto& s = *state_;
+      std::unique_lock lock{s.mtx};
+      s.stopped = true;
+      s.ready.wait(lock, [&s] { return !s.reading; });
+    }
+  }
+
+  /**
+   * @brief Returns next item of the wrapped source, waiting for it to be read if it has not been yet, or nothing
+   *        once the source is exhausted
+   *
+   * @throws  exception thrown by the wrapped source, once; nothing is returned from then on
+   */
+  [[nodiscard]] std::optional<item_type> next()
+  {
+    auto& s = *state_;
+    std::unique_lock lock{s.mtx};
+    if (!s.reading && !s.exhausted && (s.items.size() <= s.depth / 2))
+    {
+      s.reading = true;
+
+      // Submitted without holding the lock, in case the executor runs work inline
+      lock.unlock();
+      try
+      {
+        e_->execute([s = state_] { read(*s); });
+      }
+      catch (...)
+      {
+        lock.lock();
+        s.reading = false;
+        s.ready.notify_all();
+        throw;
+      }
+      lock.lock();
+    }
+
+    s.ready.wait(lock, [&s] { return !s.items.empty() || s.exhausted; });
+    if (s.items.empty())
+    {
+      if (s.error != nullptr)
+      {
+        std::rethrow_exception(std::exchange(s.error, nullptr));
+      }
+      return std::nullopt;
+    }
+
+    std::optional<item_type> item{std::move(s.items.front())};
+    s.items.pop_front();
+    return item;
+  }
+
+private:
+  struct state
+  {
+    state(SourceT&& src, std::size_t d) : source{std::move(src)}, depth{d} {}
+
+    /// Wrapped source; only touched by read work, one piece at a time
+    SourceT source;
+
+    /// Number of items to read ahead
+    std::size_t depth;
+
+    /// Guards all members below
+    std::mutex mtx;
+
+    /// Signaled when an item is buffered, the source is exhausted, or read work stops
+    std::condition_variable ready;
+
+    /// Items read ahead, oldest first
+    std::deque<item_type> items;
+
+    /// Set while read work is submitted or running
+    bool reading = false;
+
+    /// Exception thrown by the source, until it is rethrown by next()
+    std::exception_ptr error;
+
+    /// Set once the source has no more items, or has thrown
+    bool exhausted = false;
+
+    /// Set once the reading source is being destroyed
+    bool stopped = false;
+  };
+
+  /**
+   * @brief Pulls items from the wrapped source until <code>depth</code> are buffered, or the source is exhausted
+   *
+   * An exception thrown by the wrapped source is kept for next(), and exhausts the source, so that neither next() nor
+   * the destructor wait for read work which will never come.
+   */
+  static void read(state& s)
+  {
+    while (true)
+    {
+      std::exception_ptr error;
+      auto item = [&s, &error]() -> std::optional<item_type> {
+        try
+        {
+          return s.source.next();
+        }
+        catch (...)
+        {
+          error = std::current_exception();
+          return std::nullopt;
+        }
+      }();
+
+      std::lock_guard lock{s.mtx};
+      if (!item.has_value())
+      {
+        s.error = std::move(error);
+        s.exhausted = true;
+        s.reading = false;
+        s.ready.notify_all();
+        return;
+      }
+
+      s.items.push_back(std::move(*item));
+      if (s.stopped || (s.items.size() >= s.depth))
+      {
+        s.reading = false;
+        s.ready.notify_all();
+        return;
+      }
+      s.ready.notify_one();
+    }
+  }
+
+  exec::executor<ExecutorT>* e_;
+  std::shared_ptr<state> state_;
+};
+
+/**
+ * @brief Creates a source which reads up to <code>depth</code> items of <code>source</code> ahead, on <code>e</code>
+ *
+@verbatim
+  exec::thread_pool tp{2};
+
+  const int fd = ::open("/tmp/values.txt", O_RDONLY);
+  auto source = read_ahead(tp, lines(fd), 256);
+@endverbatim
+ */
+template <typename ExecutorT, typename SourceT>
+read_ahead_source<std::decay_t<SourceT>, ExecutorT>
+read_ahead(exec::executor<ExecutorT>& e, SourceT&& source, std::size_t depth)
+{
+  return read_ahead_source<std::decay_t<SourceT>, ExecutorT>{e, std::forward<SourceT>(source), depth};
+}
+
+}  // namespace zen
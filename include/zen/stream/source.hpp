@@ -0,0 +1,120 @@
+#pragma once
+
+// C++ Standard Library
+#include <iterator>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zen
+{
+
+/**
+ * @brief Type of items pulled from a source
+ *
+ * Sources are objects with a <code>std::optional<T> next()</code> member, which returns the next item, or nothing
+ * once the source is exhausted.
+ *
+ * @tparam SourceT  source type
+ */
+template <typename SourceT>
+using source_item_t = typename std::decay_t<decltype(std::declval<std::decay_t<SourceT>&>().next())>::value_type;
+
+/**
+ * @brief Source which pulls items from a generator
+ *
+ * @tparam GeneratorT  invocable which returns a <code>std::optional</code> item, or nothing once exhausted
+ */
+template <typename GeneratorT> class generator_source
+{
+public:
+  using item_type = typename std::decay_t<std::invoke_result_t<GeneratorT&>>::value_type;
+
+  explicit generator_source(GeneratorT generator) : generator_{std::move(generator)} {}
+
+  /**
+   * @brief Returns next item of the generator, or nothing once it is exhausted
+   */
+  [[nodiscard]] std::optional<item_type> next() { return generator_(); }
+
+private:
+  GeneratorT generator_;
+};
+
+/**
+ * @brief Creates a source which pulls items from <code>generator</code>
+ *
+@verbatim
+  auto source = from_generator([n = 0]() mutable -> std::optional<int> {
+    if (n == 10) { return std::nullopt; }
+    return n++;
+  });
+@endverbatim
+ */
+template <typename GeneratorT> generator_source<std::decay_t<GeneratorT>> from_generator(GeneratorT&& generator)
+{
+  return generator_source<std::decay_t<GeneratorT>>{std::forward<GeneratorT>(generator)};
+}
+
+/**
+ * @brief Source which pulls items from a range, in order
+ *
+ * Items of a range held by reference are copied; items of a range held by value, which the source owns, are moved.
+ *
+ * @tparam RangeT  range type; an lvalue reference type if the range is held by reference
+ *
+ * @warning the source must not be moved once items have been pulled from it
+ */
+template <typename RangeT> class range_source
+{
+public:
+  using item_type = std::remove_cv_t<std::remove_reference_t<decltype(*std::begin(std::declval<RangeT&>()))>>;
+
+  explicit range_source(RangeT&& range) : range_{std::forward<RangeT>(range)} {}
+
+  /**
+   * @brief Returns next item of the range, or nothing past its end
+   */
+  [[nodiscard]] std::optional<item_type> next()
+  {
+    if (!current_.has_value())
+    {
+      current_.emplace(std::begin(range_));
+    }
+
+    auto& itr = *current_;
+    if (itr == std::end(range_))
+    {
+      return std::nullopt;
+    }
+
+    if constexpr (std::is_reference_v<RangeT>)
+    {
+      return std::optional<item_type>{*(itr++)};
+    }
+    else
+    {
+      return std::optional<item_type>{std::move(*(itr++))};
+    }
+  }
+
+private:
+  using iterator = decltype(std::begin(std::declval<RangeT&>()));
+
+  RangeT range_;
+
+  /// Position of the next item; set when the first item is pulled, so that an owned range may be moved until then
+  std::optional<iterator> current_;
+};
+
+/**
+ * @brief Creates a source which pulls items from <code>range</code>
+ *
+ * An lvalue range is held by reference, and must outlive the source; an rvalue range is moved into the source.
+ */
+template <typename RangeT> range_source<RangeT> from_range(RangeT&& range)
+{
+  return range_source<RangeT>{std::forward<RangeT>(range)};
+}
+
+}  // namespace zen
@@ -0,0 +1,246 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <ostream>
+#include <type_traits>
+
+namespace zen::accounting
+{
+
+/**
+ * @brief Counts of payload lifetime events and heap allocations
+ */
+struct counts
+{
+  /// Payloads constructed in a result from anything other than another payload
+  std::uint64_t constructions = 0;
+
+  /// Payloads copied into a result
+  std::uint64_t copies = 0;
+
+  /// Payloads moved into a result
+  std::uint64_t moves = 0;
+
+  /// Payloads destroyed by a result
+  std::uint64_t destructions = 0;
+
+  /// Heap allocations; only counted when allocation hooks are installed (see ZEN_ACCOUNTING_DEFINE_ALLOCATION_HOOKS)
+  std::uint64_t allocations = 0;
+};
+
+/// Budget which allows any number of every event; copy it, and lower the limits to check
+static constexpr counts kUnlimited{
+  std::numeric_limits<std::uint64_t>::max(),
+  std::numeric_limits<std::uint64_t>::max(),
+  std::numeric_limits<std::uint64_t>::max(),
+  std::numeric_limits<std::uint64_t>::max(),
+  std::numeric_limits<std::uint64_t>::max()};
+
+/**
+ * @brief Returns <code>true</code> if accounting was compiled in, by defining ZEN_ENABLE_ACCOUNTING
+ */
+[[nodiscard]] constexpr bool enabled()
+{
+#if defined(ZEN_ENABLE_ACCOUNTING)
+  return true;
+#else  // ZEN_ENABLE_ACCOUNTING
+  return false;
+#endif  // ZEN_ENABLE_ACCOUNTING
+}
+
+/**
+ * @brief Returns counts of <code>lhs</code> less counts of <code>rhs</code>
+ */
+[[nodiscard]] constexpr counts operator-(const counts& lhs, const counts& rhs)
+{
+  return counts{
+    lhs.constructions - rhs.constructions,
+    lhs.copies - rhs.copies,
+    lhs.moves - rhs.moves,
+    lhs.destructions - rhs.destructions,
+    lhs.allocations - rhs.allocations};
+}
+
+/**
+ * @brief Returns <code>true</code> if no count of <code>actual</code> exceeds its limit in <code>budget</code>
+ *
+ * Meant as a test assertion predicate, which prints both arguments on failure:
+@verbatim
+  auto budget = accounting::kUnlimited;
+  budget.copies = 0;
+  EXPECT_PRED2(accounting::within, scope.counts(), budget);
+@endverbatim
+ */
+[[nodiscard]] constexpr bool within(const counts& actual, const counts& budget)
+{
+  return actual.constructions <= budget.constructions && actual.copies <= budget.copies &&
+    actual.moves <= budget.moves && actual.destructions <= budget.destructions &&
+    actual.allocations <= budget.allocations;
+}
+
+/**
+ * @brief <code>std::ostream</code> overload for counts
+ */
+inline std::ostream& operator<<(std::ostream& os, const counts& c)
+{
+  const auto write = [&os](const char* name, std::uint64_t n) {
+    os << name << '=';
+    if (n == std::numeric_limits<std::uint64_t>::max())
+    {
+      os << "any";
+    }
+    else
+    {
+      os << n;
+    }
+  };
+  os << '{';
+  write("constructions", c.constructions);
+  write(" copies", c.copies);
+  write(" moves", c.moves);
+  write(" destructions", c.destructions);
+  write(" allocations", c.allocations);
+  return os << '}';
+}
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Process-wide event counters
+ */
+struct counters
+{
+  std::atomic<std::uint64_t> constructions{0};
+  std::atomic<std::uint64_t> copies{0};
+  std::atomic<std::uint64_t> moves{0};
+  std::atomic<std::uint64_t> destructions{0};
+  std::atomic<std::uint64_t> allocations{0};
+};
+
+inline counters& get_counters()
+{
+  static counters c;
+  return c;
+}
+
+/**
+ * @brief Counts construction of a <code>T</code> from forwarded <code>ArgTs</code>, as a copy, a move, or neither
+ */
+template <typename T, typename... ArgTs> void constructed()
+{
+  auto& c = get_counters();
+  if constexpr (sizeof...(ArgTs) == 1 && (std::is_same_v<std::remove_cv_t<std::remove_reference_t<ArgTs>>, T> && ...))
+  {
+    // Arguments are forwarded, so an rvalue argument has a non-reference type
+    if constexpr (((!std::is_lvalue_reference_v<ArgTs> && !std::is_const_v<std::remove_reference_t<ArgTs>>) && ...))
+    {
+      c.moves.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+      c.copies.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+  else
+  {
+    c.constructions.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+inline void destroyed() { get_counters().destructions.fetch_add(1, std::memory_order_relaxed); }
+
+/**
+ * @brief Counts and makes a heap allocation, for replacement <code>operator new</code>
+ */
+inline void* allocate(std::size_t size)
+{
+  get_counters().allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* const p = std::malloc(size == 0 ? 1 : size))
+  {
+    return p;
+  }
+  throw std::bad_alloc{};
+}
+
+/**
+ * @brief Frees a heap allocation, for replacement <code>operator delete</code>
+ *
+ * Kept out of line, so that compilers do not mistake memory from <code>operator new</code> being passed to
+ * <code>std::free</code> for a mismatched deallocation.
+ */
+[[gnu::noinline]] inline void deallocate(void* p) noexcept { std::free(p); }
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Returns counts of all events so far, in all threads
+ */
+[[nodiscard]] inline counts snapshot()
+{
+  const auto& c = detail::get_counters();
+  return counts{
+    c.constructions.load(std::memory_order_relaxed),
+    c.copies.load(std::memory_order_relaxed),
+    c.moves.load(std::memory_order_relaxed),
+    c.destructions.load(std::memory_order_relaxed),
+    c.allocations.load(std::memory_order_relaxed)};
+}
+
+/**
+ * @brief Counts events from its construction on, e.g. over a single pipeline invocation
+ *
+ * Counters are process-wide, so that work which a pipeline dispatches to other threads is counted; events of
+ * unrelated work which runs at the same time are counted as well.
+ */
+class scope
+{
+public:
+  scope() : start_{snapshot()} {}
+
+  /**
+   * @brief Returns counts of events since this scope was created
+   */
+  [[nodiscard]] accounting::counts counts() const { return snapshot() - start_; }
+
+private:
+  accounting::counts start_;
+};
+
+}  // namespace zen::accounting
+
+/**
+ * @brief Accounting hooks used by zen payload storage; compiled out unless ZEN_ENABLE_ACCOUNTING is defined for the
+ *        whole program
+ */
+#if defined(ZEN_ENABLE_ACCOUNTING)
+#define ZEN_ACCOUNT_CONSTRUCTED(T, ...) ::zen::accounting::detail::constructed<T, __VA_ARGS__>()
+#define ZEN_ACCOUNT_DESTROYED() ::zen::accounting::detail::destroyed()
+#else  // ZEN_ENABLE_ACCOUNTING
+#define ZEN_ACCOUNT_CONSTRUCTED(T, ...) static_cast<void>(0)
+#define ZEN_ACCOUNT_DESTROYED() static_cast<void>(0)
+#endif  // ZEN_ENABLE_ACCOUNTING
+
+/**
+ * @brief Replaces global <code>operator new</code> and <code>operator delete</code> with versions which count heap
+ *        allocations; expand once, at namespace scope, in one translation unit of a program built with
+ *        ZEN_ENABLE_ACCOUNTING
+ *
+ * Every allocation is counted, so a scope around a pipeline invocation counts allocations of its stages too.
+ */
+#define ZEN_ACCOUNTING_DEFINE_ALLOCATION_HOOKS()                                                                       \
+  void* operator new(std::size_t size) { return ::zen::accounting::detail::allocate(size); }                           \
+  void* operator new[](std::size_t size) { return ::zen::accounting::detail::allocate(size); }                         \
+  void operator delete(void* p) noexcept { ::zen::accounting::detail::deallocate(p); }                                 \
+  void operator delete[](void* p) noexcept { ::zen::accounting::detail::deallocate(p); }                               \
+  void operator delete(void* p, std::size_t) noexcept { ::zen::accounting::detail::deallocate(p); }                    \
+  void operator delete[](void* p, std::size_t) noexcept { ::zen::accounting::detail::deallocate(p); }
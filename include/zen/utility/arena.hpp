@@ -0,0 +1,209 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+namespace zen
+{
+
+/**
+ * @brief Monotonic memory resource for allocations which all end with a single pipeline invocation
+ *
+ * Allocations are carved from one block by bumping an offset, and may be made from several threads at once.
+ * Deallocation does nothing; all memory is released at once with reset(). Allocations which do not fit in the block
+ * are served by an upstream resource, and are also released by reset().
+ *
+@verbatim
+  arena a{64 * 1024};
+  {
+    const arena_scope scope{a};
+    auto r = pass(request) | all(tp, decode, lookup);
+  }
+  a.reset();
+@endverbatim
+ */
+class arena final : public std::pmr::memory_resource
+{
+public:
+  /**
+   * @brief Creates arena with a block of <code>capacity</code> bytes
+   *
+   * @param capacity  size of the block which allocations are carved from
+   * @param upstream  resource which provides the block, and allocations which do not fit in it
+   */
+  explicit arena(
+    std::size_t capacity = 16 * 1024,
+    std::pmr::memory_resource* upstream = std::pmr::new_delete_resource()) :
+      upstream_{upstream},
+      capacity_{capacity},
+      block_{static_cast<std::byte*>(upstream_->allocate(capacity_, alignof(std::max_align_t)))}
+  {}
+
+  ~arena() override
+  {
+    reset();
+    upstream_->deallocate(block_, capacity_, alignof(std::max_align_t));
+  }
+
+  arena(const arena&) = delete;
+  arena& operator=(const arena&) = delete;
+
+  /**
+   * @brief Releases all allocations
+   *
+   * @warning must not be called while memory from this arena is in use, or being allocated
+   */
+  void reset()
+  {
+    for (const auto& [ptr, bytes, alignment] : overflow_)
+    {
+      upstream_->deallocate(ptr, bytes, alignment);
+    }
+    overflow_.clear();
+    offset_.store(0, std::memory_order_relaxed);
+    allocations_.store(0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of allocations made since the last reset()
+   */
+  [[nodiscard]] std::size_t allocations() const { return allocations_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the number of bytes of the block in use
+   */
+  [[nodiscard]] std::size_t used() const { return std::min(offset_.load(std::memory_order_relaxed), capacity_); }
+
+  /**
+   * @brief Returns the size of the block, in bytes
+   */
+  [[nodiscard]] constexpr std::size_t capacity() const { return capacity_; }
+
+private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override
+  {
+    allocations_.fetch_add(1, std::memory_order_relaxed);
+
+    const auto base = reinterpret_cast<std::uintptr_t>(block_);
+    std::size_t offset = offset_.load(std::memory_order_relaxed);
+    std::size_t start, end;
+    do
+    {
+      start = ((base + offset + alignment - 1) & ~(alignment - 1)) - base;
+      end = start + bytes;
+      if (end > capacity_)
+      {
+        return overflow(bytes, alignment);
+      }
+    } while (!offset_.compare_exchange_weak(offset, end, std::memory_order_relaxed));
+
+    return block_ + start;
+  }
+
+  void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+  /**
+   * @brief Serves an allocation which does not fit in the block from the upstream resource
+   */
+  void* overflow(std::size_t bytes, std::size_t alignment)
+  {
+    std::lock_guard lock{overflow_mtx_};
+    void* const ptr = upstream_->allocate(bytes, alignment);
+    overflow_.emplace_back(ptr, bytes, alignment);
+    return ptr;
+  }
+
+  /// Resource which provides the block, and allocations which do not fit in it
+  std::pmr::memory_resource* upstream_;
+
+  /// Size of the block
+  std::size_t capacity_;
+
+  /// Block which allocations are carved from
+  std::byte* block_;
+
+  /// Offset of the first free byte of the block
+  std::atomic<std::size_t> offset_{0};
+
+  /// Number of allocations since the last reset
+  std::atomic<std::size_t> allocations_{0};
+
+  /// Mutex which synchronizes overflow_ between threads
+  std::mutex overflow_mtx_;
+
+  /// Allocations served by the upstream resource
+  std::vector<std::tuple<void*, std::size_t, std::size_t>> overflow_;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+inline arena*& current_arena() noexcept
+{
+  static thread_local arena* current = nullptr;
+  return current;
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Returns arena of the pipeline invocation running on this thread, or <code>nullptr</code> if there is none
+ */
+[[nodiscard]] inline arena* current_arena() noexcept { return detail::current_arena(); }
+
+/**
+ * @brief Returns resource for allocations which end with the pipeline invocation running on this thread
+ *
+ * This is the current arena, if there is one; otherwise, the default resource.
+ */
+[[nodiscard]] inline std::pmr::memory_resource* current_resource() noexcept
+{
+  arena* const a = current_arena();
+  return (a == nullptr) ? std::pmr::get_default_resource() : a;
+}
+
+/**
+ * @brief Makes an arena current on this thread, until destroyed
+ *
+ * Parallel dispatches started while an arena is current allocate their internal state from it, pass it to their
+ * invocables through the executor handle, and make it current on the threads which run those invocables.
+ */
+class arena_scope
+{
+public:
+  /**
+   * @param a  arena to make current; if <code>nullptr</code>, this scope has no effect
+   */
+  explicit arena_scope(arena* a) noexcept : previous_{detail::current_arena()}
+  {
+    if (a != nullptr)
+    {
+      detail::current_arena() = a;
+    }
+  }
+
+  explicit arena_scope(arena& a) noexcept : arena_scope{&a} {}
+
+  ~arena_scope() { detail::current_arena() = previous_; }
+
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+
+private:
+  /// Arena which was current before this scope
+  arena* previous_;
+};
+
+}  // namespace zen
@@ -0,0 +1,200 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace zen
+{
+
+/**
+ * @brief High-dynamic-range histogram of durations, with log-linear buckets
+ *
+ * Each power of two nanoseconds is split into kSubBuckets linear buckets, so recorded durations, and percentiles,
+ * are accurate to within about 3%, which is enough to report p999. Durations under kSubBuckets nanoseconds are exact;
+ * durations over about 18 minutes share the last bucket, although max() stays exact.
+ *
+ * Recording is meant for a single thread at a time, and costs a few relaxed loads and stores. Reading may happen
+ * from other threads while durations are recorded; histograms recorded by several threads are merged on read.
+ */
+class hdr_histogram
+{
+public:
+  /// Bits of a duration, below its leading one, which select its linear bucket
+  static constexpr std::size_t kSubBucketBits = 5;
+
+  /// Number of linear buckets in each power of two
+  static constexpr std::size_t kSubBuckets = std::size_t{1} << kSubBucketBits;
+
+  /// Largest power of two with buckets of its own
+  static constexpr std::size_t kMaxExponent = 40;
+
+  /// Total number of buckets
+  static constexpr std::size_t kBuckets = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+
+  hdr_histogram() = default;
+
+  /**
+   * @brief Copies recorded durations
+   */
+  hdr_histogram(const hdr_histogram& other) { merge(other); }
+
+  /**
+   * @copydoc hdr_histogram(const hdr_histogram&)
+   */
+  hdr_histogram& operator=(const hdr_histogram& other)
+  {
+    if (this != &other)
+    {
+      reset();
+      merge(other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Adds a duration; called by one thread at a time
+   */
+  void record(std::chrono::nanoseconds duration)
+  {
+    const auto ns = static_cast<std::uint64_t>(std::max<std::int64_t>(0, duration.count()));
+    add(buckets_[bucket(ns)], 1);
+    add(count_, 1);
+    if (ns > max_ns_.load(std::memory_order_relaxed))
+    {
+      max_ns_.store(ns, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Adds all durations recorded by <code>other</code>; called by one thread at a time
+   */
+  void merge(const hdr_histogram& other)
+  {
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+      add(buckets_[b], other.buckets_[b].load(std::memory_order_relaxed));
+    }
+    add(count_, other.count());
+    const std::uint64_t ns = other.max_ns_.load(std::memory_order_relaxed);
+    if (ns > max_ns_.load(std::memory_order_relaxed))
+    {
+      max_ns_.store(ns, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Returns the number of recorded durations
+   */
+  [[nodiscard]] std::size_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the longest recorded duration
+   */
+  [[nodiscard]] std::chrono::nanoseconds max() const
+  {
+    return std::chrono::nanoseconds{static_cast<std::int64_t>(max_ns_.load(std::memory_order_relaxed))};
+  }
+
+  /**
+   * @brief Returns an upper bound on the <code>q</code>-th quantile of recorded durations
+   *
+   * @param q  quantile, in <code>[0, 1]</code>; e.g. <code>0.999</code> for p999
+   */
+  [[nodiscard]] std::chrono::nanoseconds percentile(double q) const
+  {
+    const std::size_t n = count();
+    if (n == 0)
+    {
+      return std::chrono::nanoseconds::zero();
+    }
+
+    const auto rank = static_cast<std::size_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(n - 1)) + 1;
+    std::size_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+      seen += buckets_[b].load(std::memory_order_relaxed);
+      if (seen >= rank)
+      {
+        return std::min(std::chrono::nanoseconds{static_cast<std::int64_t>(upper_bound(b))}, max());
+      }
+    }
+    return max();
+  }
+
+  /**
+   * @brief Clears all recorded durations
+   */
+  void reset()
+  {
+    for (auto& b : buckets_)
+    {
+      b.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  /**
+   * @brief Adds to a counter which only the calling thread writes
+   */
+  static void add(std::atomic<std::uint64_t>& counter, std::uint64_t n)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the bucket of a duration of <code>ns</code> nanoseconds
+   */
+  static constexpr std::size_t bucket(std::uint64_t ns)
+  {
+    if (ns < kSubBuckets)
+    {
+      return static_cast<std::size_t>(ns);
+    }
+
+    std::size_t exponent = kSubBucketBits;
+    while (exponent < 63 && (ns >> (exponent + 1)) != 0)
+    {
+      ++exponent;
+    }
+    if (exponent > kMaxExponent)
+    {
+      return kBuckets - 1;
+    }
+
+    // Top kSubBucketBits bits below the leading one select the linear bucket
+    const auto sub = static_cast<std::size_t>(ns >> (exponent - kSubBucketBits)) - kSubBuckets;
+    return (exponent - kSubBucketBits + 1) * kSubBuckets + sub;
+  }
+
+  /**
+   * @brief Returns the longest duration, in nanoseconds, which falls into bucket <code>b</code>
+   */
+  static constexpr std::uint64_t upper_bound(std::size_t b)
+  {
+    if (b < kSubBuckets)
+    {
+      return b;
+    }
+    const std::size_t exponent = b / kSubBuckets + kSubBucketBits - 1;
+    const std::uint64_t lower = static_cast<std::uint64_t>(kSubBuckets + b % kSubBuckets)
+                                << (exponent - kSubBucketBits);
+    return lower + (std::uint64_t{1} << (exponent - kSubBucketBits)) - 1;
+  }
+
+  /// Number of durations in each bucket
+  std::atomic<std::uint64_t> buckets_[kBuckets] = {};
+
+  /// Total number of recorded durations
+  std::atomic<std::uint64_t> count_{0};
+
+  /// Longest recorded duration, in nanoseconds
+  std::atomic<std::uint64_t> max_ns_{0};
+};
+
+}  // namespace zen
@@ -0,0 +1,169 @@
+#pragma once
+
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+namespace zen
+{
+
+/**
+ * @brief Percentiles of a histogram at some point in time
+ */
+struct histogram_summary
+{
+  /// Number of recorded durations
+  std::size_t count = 0;
+
+  /// Upper bounds on the 50th, 90th and 99th percentiles
+  std::chrono::nanoseconds p50{0}, p90{0}, p99{0};
+
+  /// Longest recorded duration
+  std::chrono::nanoseconds max{0};
+};
+
+/**
+ * @brief <code>std::ostream</code> overload for histogram_summary
+ */
+inline std::ostream& operator<<(std::ostream& os, const histogram_summary& s)
+{
+  return os << "count=" << s.count << " p50=" << s.p50.count() << "ns p90=" << s.p90.count()
+            << "ns p99=" << s.p99.count() << "ns max=" << s.max.count() << "ns";
+}
+
+/**
+ * @brief Histogram of durations, with one bucket per power of two nanoseconds
+ *
+ * Recording is wait-free, and may be done from several threads at once. Percentiles are accurate to within a factor
+ * of two, which is enough to tell tail latencies apart.
+ */
+class histogram
+{
+public:
+  /// Number of buckets; bucket <code>b > 0</code> counts durations in <code>[2^(b-1), 2^b)</code> nanoseconds
+  static constexpr std::size_t kBuckets = 64;
+
+  histogram() = default;
+
+  histogram(const histogram&) = delete;
+  histogram& operator=(const histogram&) = delete;
+
+  /**
+   * @brief Adds a duration
+   */
+  void record(std::chrono::nanoseconds duration)
+  {
+    const auto ns = std::max<std::int64_t>(0, duration.count());
+    buckets_[bucket(static_cast<std::uint64_t>(ns))].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    std::int64_t prev = max_ns_.load(std::memory_order_relaxed);
+    while (prev < ns && !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+    {}
+  }
+
+  /**
+   * @brief Returns the number of recorded durations
+   */
+  [[nodiscard]] std::size_t count() const { return count_.load(std::memory_order_relaxed); }
+
+  /**
+   * @brief Returns the longest recorded duration
+   */
+  [[nodiscard]] std::chrono::nanoseconds max() const
+  {
+    return std::chrono::nanoseconds{max_ns_.load(std::memory_order_relaxed)};
+  }
+
+  /**
+   * @brief Returns an upper bound on the <code>q</code>-th quantile of recorded durations
+   *
+   * @param q  quantile in <code>[0, 1]</code>; for example, <code>0.99</code> for the 99th percentile
+   */
+  [[nodiscard]] std::chrono::nanoseconds percentile(double q) const
+  {
+    const std::size_t n = count();
+    if (n == 0)
+    {
+      return std::chrono::nanoseconds::zero();
+    }
+
+    const auto rank = static_cast<std::size_t>(std::clamp(q, 0.0, 1.0) * static_cast<double>(n - 1)) + 1;
+    std::size_t seen = 0;
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+      seen += buckets_[b].load(std::memory_order_relaxed);
+      if (seen >= rank)
+      {
+        const auto upper = (b == 0) ? std::int64_t{0} : static_cast<std::int64_t>((std::uint64_t{1} << b) - 1);
+        return std::min(std::chrono::nanoseconds{upper}, max());
+      }
+    }
+    return max();
+  }
+
+  /**
+   * @brief Returns percentiles of recorded durations
+   */
+  [[nodiscard]] histogram_summary summary() const
+  {
+    return histogram_summary{count(), percentile(0.50), percentile(0.90), percentile(0.99), max()};
+  }
+
+  /**
+   * @brief Adds all durations recorded by <code>other</code>
+   */
+  void merge(const histogram& other)
+  {
+    for (std::size_t b = 0; b < kBuckets; ++b)
+    {
+      buckets_[b].fetch_add(other.buckets_[b].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+    count_.fetch_add(other.count(), std::memory_order_relaxed);
+
+    const std::int64_t ns = other.max().count();
+    std::int64_t prev = max_ns_.load(std::memory_order_relaxed);
+    while (prev < ns && !max_ns_.compare_exchange_weak(prev, ns, std::memory_order_relaxed))
+    {}
+  }
+
+  /**
+   * @brief Clears all recorded durations
+   */
+  void reset()
+  {
+    for (auto& b : buckets_)
+    {
+      b.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+  }
+
+private:
+  static constexpr std::size_t bucket(std::uint64_t ns)
+  {
+    std::size_t b = 0;
+    while (ns != 0 && b + 1 < kBuckets)
+    {
+      ns >>= 1;
+      ++b;
+    }
+    return b;
+  }
+
+  /// Number of durations in each bucket
+  std::atomic<std::uint64_t> buckets_[kBuckets] = {};
+
+  /// Number of recorded durations
+  std::atomic<std::size_t> count_{0};
+
+  /// Longest recorded duration, in nanoseconds
+  std::atomic<std::int64_t> max_ns_{0};
+};
+
+}  // namespace zen
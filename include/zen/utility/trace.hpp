@@ -0,0 +1,354 @@
+#pragma once
+
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace zen::trace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+/**
+ * @brief Traced event, in Chrome trace-event terms
+ *
+ * Names and categories are not copied; they must outlive the next flush. String literals and names returned by
+ * meta::type_to_string do.
+ */
+struct event
+{
+  /// Name of the event
+  const char* name;
+
+  /// Category of the event
+  const char* category;
+
+  /// Chrome trace-event phase: <code>'X'</code> for a span, <code>'i'</code> for an instant
+  char phase;
+
+  /// Start of the event
+  clock_type::time_point start;
+
+  /// Duration of a span
+  clock_type::duration duration;
+};
+
+/**
+ * @brief Bounded single-producer, single-consumer ring of events
+ *
+ * Filled by the thread which owns it, without locking, and drained when traces are written. Events recorded while the
+ * ring is full are dropped and counted.
+ */
+class ring
+{
+public:
+  /// Number of events a ring holds before it is drained
+  static constexpr std::size_t kCapacity = 1 << 13;
+
+  explicit ring(std::uint32_t tid) : tid_{tid}, events_{std::make_unique<event[]>(kCapacity)} {}
+
+  /**
+   * @brief Adds event; called only by the owning thread
+   */
+  void push(const event& e)
+  {
+    const std::size_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) == kCapacity)
+    {
+      dropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    events_[head & kMask] = e;
+    head_.store(head + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Calls <code>fn(event)</code> for each event, oldest first, and removes them; called by one thread at a time
+   */
+  template <typename FnT> void drain(FnT&& fn)
+  {
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    const std::size_t head = head_.load(std::memory_order_acquire);
+    for (; tail != head; ++tail)
+    {
+      fn(events_[tail & kMask]);
+    }
+    tail_.store(tail, std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns identifier of the owning thread in traces
+   */
+  [[nodiscard]] constexpr std::uint32_t tid() const { return tid_; }
+
+  /**
+   * @brief Returns the number of events dropped because this ring was full
+   */
+  [[nodiscard]] std::size_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+  static constexpr std::size_t kMask = kCapacity - 1;
+
+  /// Identifier of the owning thread in traces
+  std::uint32_t tid_;
+
+  /// Position of the next event pushed
+  std::atomic<std::size_t> head_{0};
+
+  /// Position of the next event drained
+  std::atomic<std::size_t> tail_{0};
+
+  /// Events which were dropped because the ring was full
+  std::atomic<std::size_t> dropped_{0};
+
+  /// Ring storage
+  std::unique_ptr<event[]> events_;
+};
+
+#define DOXYGEN_SHOULD_SKIP_THIS 1
+#ifdef DOXYGEN_SHOULD_SKIP_THIS
+namespace detail
+{
+
+/**
+ * @brief Rings of all threads which have recorded events; rings of exited threads are kept until drained
+ */
+struct registry
+{
+  std::mutex mtx;
+  std::vector<std::shared_ptr<ring>> rings;
+  std::uint32_t next_tid = 1;
+  const clock_type::time_point epoch = clock_type::now();
+  std::atomic<bool> enabled{true};
+};
+
+inline registry& get_registry()
+{
+  static registry r;
+  return r;
+}
+
+inline ring& local_ring()
+{
+  static thread_local const std::shared_ptr<ring> local = [] {
+    auto& r = get_registry();
+    std::lock_guard lock{r.mtx};
+    r.rings.push_back(std::make_shared<ring>(r.next_tid++));
+    return r.rings.back();
+  }();
+  return *local;
+}
+
+inline void write_escaped(std::ostream& os, const char* str)
+{
+  for (; *str != '\0'; ++str)
+  {
+    if (*str == '"' || *str == '\\')
+    {
+      os << '\\';
+    }
+    os << *str;
+  }
+}
+
+}  // namespace detail
+#endif  // DOXYGEN_SHOULD_SKIP_THIS
+
+/**
+ * @brief Returns <code>true</code> if events are being recorded
+ */
+[[nodiscard]] inline bool enabled() { return detail::get_registry().enabled.load(std::memory_order_relaxed); }
+
+/**
+ * @brief Starts, or stops, recording events
+ */
+inline void enable(bool on = true) { detail::get_registry().enabled.store(on, std::memory_order_relaxed); }
+
+/**
+ * @brief Records an event on the calling thread's ring, if recording is enabled
+ */
+inline void record(const event& e)
+{
+  if (enabled())
+  {
+    detail::local_ring().push(e);
+  }
+}
+
+/**
+ * @brief Records a span which started at <code>start</code> and ended at <code>stop</code>
+ */
+inline void complete(const char* name, const char* category, clock_type::time_point start, clock_type::time_point stop)
+{
+  record(event{name, category, 'X', start, stop - start});
+}
+
+/**
+ * @brief Records an instant event
+ */
+inline void instant(const char* name, const char* category)
+{
+  record(event{name, category, 'i', clock_type::now(), clock_type::duration::zero()});
+}
+
+/**
+ * @brief Records a span from its construction until its destruction, if recording was enabled on construction
+ */
+class span
+{
+public:
+  span(const char* name, const char* category) :
+      name_{name}, category_{category}, start_{enabled() ? clock_type::now() : clock_type::time_point{}}
+  {}
+
+  /**
+   * @brief Records span named by <code>name()</code>, which is only called if recording is enabled
+   */
+  template <typename NameFnT, std::enable_if_t<std::is_invocable_r_v<const char*, NameFnT&>, int> = 0>
+  span(NameFnT&& name, const char* category) : category_{category}
+  {
+    if (enabled())
+    {
+      name_ = name();
+      start_ = clock_type::now();
+    }
+  }
+
+  ~span()
+  {
+    if (start_ != clock_type::time_point{})
+    {
+      complete(name_, category_, start_, clock_type::now());
+    }
+  }
+
+  span(const span&) = delete;
+  span& operator=(const span&) = delete;
+
+private:
+  const char* name_ = nullptr;
+  const char* category_;
+  clock_type::time_point start_;
+};
+
+/**
+ * @brief Returns the number of events dropped so far because a ring was full
+ */
+[[nodiscard]] inline std::size_t dropped()
+{
+  auto& r = detail::get_registry();
+  std::lock_guard lock{r.mtx};
+  std::size_t n = 0;
+  for (const auto& ring : r.rings)
+  {
+    n += ring->dropped();
+  }
+  return n;
+}
+
+/**
+ * @brief Drains recorded events of all threads into <code>os</code>, as Chrome trace-event JSON
+ *
+ * The output loads in <code>chrome://tracing</code> and in Perfetto. Timestamps are in microseconds since the first
+ * traced event.
+ *
+ * @return number of events written
+ */
+inline std::size_t write_chrome_trace(std::ostream& os)
+{
+  auto& r = detail::get_registry();
+  std::lock_guard lock{r.mtx};
+
+  // Nanosecond resolution, however long the trace
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+  os << std::fixed << std::setprecision(3);
+
+  std::size_t n = 0;
+  os << "{\"traceEvents\":[";
+  for (const auto& ring : r.rings)
+  {
+    ring->drain([&os, &n, &r, tid = ring->tid()](const event& e) {
+      const std::chrono::duration<double, std::micro> ts = e.start - r.epoch;
+      const std::chrono::duration<double, std::micro> dur = e.duration;
+      os << ((n++ == 0) ? "\n" : ",\n") << "{\"name\":\"";
+      detail::write_escaped(os, e.name);
+      os << "\",\"cat\":\"";
+      detail::write_escaped(os, e.category);
+      os << "\",\"ph\":\"" << e.phase << "\",\"ts\":" << ts.count() << ",\"pid\":1,\"tid\":" << tid;
+      if (e.phase == 'X')
+      {
+        os << ",\"dur\":" << dur.count();
+      }
+      else
+      {
+        os << ",\"s\":\"t\"";
+      }
+      os << '}';
+    });
+  }
+  os << "\n],\"displayTimeUnit\":\"ns\"}\n";
+  os.flags(flags);
+  os.precision(precision);
+
+  // Rings of exited threads are only referenced here, and have been drained
+  std::vector<std::shared_ptr<ring>> live;
+  for (auto& ring : r.rings)
+  {
+    if (ring.use_count() > 1)
+    {
+      live.push_back(std::move(ring));
+    }
+  }
+  r.rings = std::move(live);
+  return n;
+}
+
+/**
+ * @brief Drains recorded events of all threads into the file at <code>path</code>, as Chrome trace-event JSON
+ *
+ * @retval true  if the file was written
+ * @retval false  otherwise
+ */
+inline bool flush(const std::string& path)
+{
+  std::ofstream ofs{path};
+  if (!ofs)
+  {
+    return false;
+  }
+  write_chrome_trace(ofs);
+  return static_cast<bool>(ofs);
+}
+
+}  // namespace zen::trace
+
+#define ZEN_TRACE_CONCAT_IMPL(a, b) a##b
+#define ZEN_TRACE_CONCAT(a, b) ZEN_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief Tracing hooks used throughout zen; compiled out, along with their arguments, unless ZEN_ENABLE_TRACE is
+ *        defined for the whole program
+ *
+ * The name of ZEN_TRACE_SPAN may also be an invocable returning it, which is only called while recording is enabled.
+ */
+#if defined(ZEN_ENABLE_TRACE)
+#define ZEN_TRACE_SPAN(name, category)                                                                                 \
+  const ::zen::trace::span ZEN_TRACE_CONCAT(zen_trace_span_, __LINE__) { name, category }
+#define ZEN_TRACE_INSTANT(name, category) ::zen::trace::instant(name, category)
+#define ZEN_TRACE_COMPLETE(name, category, start, stop) ::zen::trace::complete(name, category, start, stop)
+#else  // ZEN_ENABLE_TRACE
+#define ZEN_TRACE_SPAN(name, category) static_cast<void>(0)
+#define ZEN_TRACE_INSTANT(name, category) static_cast<void>(0)
+#define ZEN_TRACE_COMPLETE(name, category, start, stop) static_cast<void>(0)
+#endif  // ZEN_ENABLE_TRACE
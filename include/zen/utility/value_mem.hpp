@@ -4,6 +4,9 @@
 #include <type_traits>
 #include <utility>
 
+// Zen
+#include <zen/utility/accounting.hpp>
+
 namespace zen
 {
 
@@ -72,7 +75,25 @@ protected:
   /**
    * @brief Forwards <code>ArgTs...</code> and invokes constructor associated with <code>T</code>
    */
-  template <typename... ArgTs> void emplace(ArgTs&&... args) { new (data()) T{std::forward<ArgTs>(args)...}; }
+  template <typename... ArgTs> void emplace(ArgTs&&... args)
+  {
+    new (data()) T{std::forward<ArgTs>(args)...};
+    ZEN_ACCOUNT_CONSTRUCTED(T, ArgTs...);
+  }
+
+  /**
+   * @brief Assigns <code>arg</code> to held value <code>T</code>
+   *
+   * Accounted as destroying the held value, and constructing another from <code>arg</code>, which is what it replaces.
+   *
+   * @warning behavior undefined if <code>emplace</code> has not been called
+   */
+  template <typename ArgT> void assign(ArgT&& arg)
+  {
+    (*data()) = std::forward<ArgT>(arg);
+    ZEN_ACCOUNT_DESTROYED();
+    ZEN_ACCOUNT_CONSTRUCTED(T, ArgT);
+  }
 
   /**
    * @brief Invokes constructor associated with <code>T</code>
@@ -85,6 +106,7 @@ protected:
     {
       data()->~T();
     }
+    ZEN_ACCOUNT_DESTROYED();
   }
 
 private:
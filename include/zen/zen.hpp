@@ -1,5 +1,8 @@
 #pragma once
 
 // Zen
+#include <zen/async.hpp>
 #include <zen/core.hpp>
+#include <zen/graph.hpp>
 #include <zen/parallel.hpp>
+#include <zen/stage.hpp>
@@ -0,0 +1,185 @@
+// C++ Standard Library
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/async.hpp>
+#include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+#include <zen/utility/accounting.hpp>
+#include <zen/zen.hpp>
+
+ZEN_ACCOUNTING_DEFINE_ALLOCATION_HOOKS()
+
+using namespace zen;
+
+namespace
+{
+
+result<std::vector<int>> append(const std::vector<int>& v)
+{
+  std::vector<int> appended{v};
+  appended.push_back(static_cast<int>(v.size()));
+  return appended;
+}
+
+result<int> sum(const std::vector<int>& v)
+{
+  int total = 0;
+  for (const int x : v)
+  {
+    total += x;
+  }
+  return total;
+}
+
+}  // namespace
+
+TEST(Accounting, Enabled) { EXPECT_TRUE(accounting::enabled()); }
+
+TEST(Accounting, DeliberateCopy)
+{
+  const std::vector<int> v{1, 2, 3};
+
+  accounting::scope scope;
+  {
+    result<std::vector<int>> copied{v};
+    result<std::vector<int>> moved{std::move(copied)};
+  }
+
+  const auto c = scope.counts();
+  EXPECT_EQ(c.constructions, 0UL) << c;
+  EXPECT_EQ(c.copies, 1UL) << c;
+  EXPECT_EQ(c.moves, 1UL) << c;
+  EXPECT_EQ(c.destructions, 2UL) << c;
+  EXPECT_EQ(c.allocations, 1UL) << c;
+}
+
+TEST(Accounting, Budget)
+{
+  auto budget = accounting::kUnlimited;
+  budget.copies = 0;
+  EXPECT_TRUE(accounting::within(accounting::counts{}, budget));
+  EXPECT_FALSE(accounting::within(accounting::counts{0, 1}, budget));
+}
+
+TEST(Accounting, StagesDoNotCopy)
+{
+  std::vector<int> v{1, 2, 3};
+
+  accounting::scope scope;
+  {
+    // clang-format off
+    auto r = pass(std::move(v)) | append | append | sum;
+    // clang-format on
+    ASSERT_TRUE(r.valid());
+    EXPECT_EQ(*r, 13);
+  }
+
+  // Only the copies made by append allocate
+  auto budget = accounting::kUnlimited;
+  budget.constructions = 0;
+  budget.copies = 0;
+  budget.moves = 4;
+  budget.allocations = 4;
+  EXPECT_PRED2(accounting::within, scope.counts(), budget);
+  const auto c = scope.counts();
+  EXPECT_EQ(c.constructions + c.copies + c.moves, c.destructions) << c;
+}
+
+TEST(Accounting, SequentialAllDoesNotCopy)
+{
+  std::vector<int> v{1, 2, 3};
+
+  accounting::scope scope;
+  {
+    // clang-format off
+    auto r = pass(std::move(v)) | all(sum, sum);
+    // clang-format on
+    ASSERT_TRUE(r.valid());
+  }
+
+  // Branch values are moved into the aggregate once, which is constructed in place
+  auto budget = accounting::kUnlimited;
+  budget.constructions = 1;
+  budget.copies = 0;
+  budget.moves = 3;
+  budget.allocations = 0;
+  EXPECT_PRED2(accounting::within, scope.counts(), budget);
+  const auto c = scope.counts();
+  EXPECT_EQ(c.constructions + c.copies + c.moves, c.destructions) << c;
+}
+
+TEST(Accounting, ParallelAllDoesNotCopy)
+{
+  exec::thread_pool tp{2};
+  std::vector<int> v{1, 2, 3};
+
+  accounting::scope scope;
+  {
+    // clang-format off
+    auto r = pass(std::move(v)) | all(tp, sum, sum);
+    // clang-format on
+    ASSERT_TRUE(r.valid());
+  }
+
+  auto budget = accounting::kUnlimited;
+  budget.constructions = 1;
+  budget.copies = 0;
+  budget.moves = 7;
+  EXPECT_PRED2(accounting::within, scope.counts(), budget);
+}
+
+TEST(Accounting, Create)
+{
+  accounting::scope scope;
+  {
+    auto r = create(
+      make_deferred_result([] { return result<int>{1}; }), make_deferred_result([] { return result<int>{2}; }));
+    ASSERT_TRUE(r.valid());
+  }
+
+  auto budget = accounting::kUnlimited;
+  budget.constructions = 1;
+  budget.copies = 0;
+  budget.moves = 2;
+  budget.allocations = 0;
+  EXPECT_PRED2(accounting::within, scope.counts(), budget);
+  const auto c = scope.counts();
+  EXPECT_EQ(c.constructions + c.copies + c.moves, c.destructions) << c;
+}
+
+TEST(Accounting, GraphRerunDoesNotAllocate)
+{
+  exec::thread_pool tp{2};
+
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](const int a) -> result<int> { return a + 1; }, a);
+  const auto c = g.add([](const int a) -> result<int> { return a + 2; }, a);
+  const auto d = g.add([](const int b, const int c) -> result<int> { return b + c; }, b, c);
+
+  // First run warms up workers
+  ASSERT_TRUE(g.run(tp).valid());
+
+  accounting::scope scope;
+  ASSERT_TRUE(g.run(tp).valid());
+  EXPECT_EQ(scope.counts().allocations, 0UL) << scope.counts();
+  EXPECT_EQ(*g.get(d), 5);
+}
+
+TEST(Accounting, FutureThenOnlyAllocatesNextState)
+{
+  promise<result<int>> p;
+  auto f = p.get_future();
+
+  accounting::scope scope;
+  auto next = std::move(f).then([](int a) -> result<int> { return a + 1; });
+  p.set(1);
+  auto r = std::move(next).get();
+  ASSERT_TRUE(r.valid());
+  EXPECT_EQ(*r, 2);
+  EXPECT_EQ(scope.counts().allocations, 1UL) << scope.counts();
+}
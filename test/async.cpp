@@ -0,0 +1,158 @@
+// C++ Standard Library
+#include <array>
+#include <atomic>
+#include <thread>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/async.hpp>
+#include <zen/executor/thread_pool.hpp>
+
+using namespace zen;
+
+TEST(Async, Get)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r = async(tp, [] { return pass(1) | [](int a) -> result<int> { return a + 1; }; }).get();
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 2) << r.status();
+}
+
+TEST(Async, ThenRunsOnCompletingWorker)
+{
+  exec::thread_pool tp{1};
+
+  std::atomic<bool> release{false};
+  auto f = async(tp, [&release]() -> result<std::thread::id> {
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+    return std::this_thread::get_id();
+  });
+
+  // clang-format off
+  auto next = std::move(f)
+    .then([](std::thread::id producer) -> result<bool> { return producer == std::this_thread::get_id(); });
+  // clang-format on
+  release = true;
+
+  auto r = std::move(next).get();
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_TRUE(*r);
+}
+
+TEST(Async, ThenShortCircuit)
+{
+  exec::thread_pool tp{2};
+
+  bool reached = false;
+
+  // clang-format off
+  auto r = async(tp, []() -> result<int> { return "failed"_msg; })
+    .then([&reached](int a) -> result<int> { reached = true; return a; })
+    .get();
+  // clang-format on
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+  EXPECT_FALSE(reached);
+}
+
+TEST(Async, PromiseSetBeforeThen)
+{
+  promise<result<int>> p;
+  auto f = p.get_future();
+  p.set(3);
+
+  ASSERT_TRUE(f.ready());
+
+  auto r = std::move(f).then([](int a) -> result<int> { return a * 2; }).get();
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 6) << r.status();
+}
+
+TEST(Async, ThenLargeStage)
+{
+  exec::thread_pool tp{2};
+
+  // Captures more than fits in place, so that the continuation is allocated
+  std::array<int, 32> offsets{};
+  offsets.back() = 1;
+
+  // clang-format off
+  auto r = async(tp, []() -> result<int> { return 1; })
+    .then([offsets](int a) -> result<int> { return a + offsets.back(); })
+    .get();
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 2) << r.status();
+}
+
+TEST(Async, WhenAll)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r = when_all(
+      async(tp, []() -> result<int> { return 1; }),
+      async(tp, []() -> result<float> { return 2.f; }))
+    .then([](int a, float b) -> result<float> { return a + b; })
+    .get();
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 3.f) << r.status();
+}
+
+TEST(Async, WhenAllFailure)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r = when_all(
+      async(tp, []() -> result<int> { return 1; }),
+      async(tp, []() -> result<float> { return "failed"_msg; }))
+    .get();
+  // clang-format on
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+}
+
+TEST(Async, WhenAny)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r = when_any(
+      async(tp, []() -> result<int> { return "failed"_msg; }),
+      async(tp, []() -> result<int> { return 2; }))
+    .get();
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 2) << r.status();
+}
+
+TEST(Async, WhenAnyFailure)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r = when_any(
+      async(tp, []() -> result<int> { return "failed"_msg; }),
+      async(tp, []() -> result<int> { return "failed"_msg; }))
+    .get();
+  // clang-format on
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+}
@@ -0,0 +1,148 @@
+// C++ Standard Library
+#include <thread>
+#include <utility>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/coro.hpp>
+#include <zen/executor/thread_pool.hpp>
+
+using namespace zen;
+
+namespace
+{
+
+result<int> add_one(int value) { return value + 1; }
+
+result<int> fail(int value) { return "failed"_msg; }
+
+task<result<int>> add_two(int value)
+{
+  const int once = co_await add_one(value);
+  co_return co_await add_one(once);
+}
+
+}  // namespace
+
+TEST(Task, AwaitResult)
+{
+  auto r = sync_wait(add_two(1));
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 3) << r.status();
+}
+
+TEST(Task, AwaitResultShortCircuit)
+{
+  bool reached = false;
+  auto coro = [&reached](int value) -> task<result<int>> {
+    const int failed = co_await fail(value);
+    reached = true;
+    co_return failed;
+  };
+
+  auto r = sync_wait(coro(1));
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+  EXPECT_FALSE(reached);
+}
+
+TEST(Task, AwaitTask)
+{
+  auto coro = []() -> task<result<int>> {
+    result<int> r = co_await add_two(0);
+    const int value = co_await std::move(r);
+    co_return co_await add_two(value);
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 4) << r.status();
+}
+
+TEST(Task, Schedule)
+{
+  exec::thread_pool tp{1};
+
+  auto coro = [&tp]() -> task<result<std::thread::id>> {
+    co_await tp.schedule();
+    co_return std::this_thread::get_id();
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_NE(*r, std::this_thread::get_id());
+}
+
+TEST(Task, AwaitAll)
+{
+  // Awaiting coroutine holds no worker, so a single worker is enough to run it and its invocables
+  exec::thread_pool tp{1};
+
+  auto coro = [&tp]() -> task<result<int>> {
+    co_await tp.schedule();
+    const auto [a, b] = co_await all(tp, [] { return add_one(1); }, [] { return add_one(2); });
+    co_return a + b;
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 5) << r.status();
+}
+
+TEST(Task, AwaitAllShortCircuit)
+{
+  exec::thread_pool tp{2};
+
+  auto coro = [&tp]() -> task<result<int>> {
+    const auto [a, b] = co_await all(tp, [] { return add_one(1); }, [] { return fail(2); });
+    co_return a + b;
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+}
+
+TEST(Task, AwaitAny)
+{
+  exec::thread_pool tp{2};
+
+  auto coro = [&tp]() -> task<result<int>> {
+    co_return co_await any(tp, [] { return fail(1); }, [](exec::thread_pool_handle& handle) { return add_one(2); });
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 3) << r.status();
+}
+
+TEST(Task, RepeatedAwaitAll)
+{
+  static constexpr int kAwaits = 1000;
+
+  exec::thread_pool tp{2};
+
+  auto coro = [&tp]() -> task<result<int>> {
+    int sum = 0;
+    for (int i = 0; i < kAwaits; ++i)
+    {
+      const int a = co_await all(tp, [i] { return add_one(i); });
+      sum += a;
+    }
+    co_return sum;
+  };
+
+  auto r = sync_wait(coro());
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, kAwaits * (kAwaits + 1) / 2) << r.status();
+}
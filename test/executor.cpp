@@ -1,8 +1,26 @@
+// C++ Standard Library
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <map>
+#include <memory_resource>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
 // GTest
 #include <gtest/gtest.h>
 
 // Zen
 #include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+#include <zen/utility/hdr_histogram.hpp>
 
 using namespace zen;
 
@@ -11,3 +29,1005 @@ TEST(ThreadPool, DefaultEmpty)
   exec::thread_pool pool{};
   ASSERT_GT(pool.workers(), 0UL);
 }
+
+/**
+ * @brief Conformance tests which every bundled executor must pass
+ */
+template <typename ExecutorT> class ExecutorConformance : public ::testing::Test
+{
+protected:
+  template <typename F, typename A, typename Q>
+  static std::unique_ptr<exec::thread_pool<F, A, Q>> make(exec::thread_pool<F, A, Q>*)
+  {
+    return std::make_unique<exec::thread_pool<F, A, Q>>(4);
+  }
+
+  static std::unique_ptr<exec::inline_executor> make(exec::inline_executor*)
+  {
+    return std::make_unique<exec::inline_executor>();
+  }
+
+  static std::unique_ptr<exec::adaptive_executor<exec::thread_pool<>>>
+  make(exec::adaptive_executor<exec::thread_pool<>>*)
+  {
+    static exec::thread_pool<> inner{4};
+    return std::make_unique<exec::adaptive_executor<exec::thread_pool<>>>(inner);
+  }
+
+  /// Waits until <code>count</code> reaches <code>expected</code>
+  static void wait_for(const std::atomic<std::size_t>& count, std::size_t expected)
+  {
+    while (count.load() < expected)
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  std::unique_ptr<ExecutorT> e_ = make(static_cast<ExecutorT*>(nullptr));
+};
+
+template <std::size_t kCapacity, bool... kRunInlineWhenFull>
+using mpmc_thread_pool = exec::thread_pool<
+  std::function<void()>,
+  std::allocator<std::function<void()>>,
+  exec::mpmc_queue_policy<kCapacity, kRunInlineWhenFull...>>;
+
+template <exec::queue_order kOrder, bool... kMaxWait>
+using ordered_thread_pool = exec::thread_pool<
+  std::function<void()>,
+  std::allocator<std::function<void()>>,
+  exec::locked_queue_policy<kOrder, kMaxWait...>>;
+
+using fair_thread_pool =
+  exec::thread_pool<std::function<void()>, std::allocator<std::function<void()>>, exec::fair_queue_policy>;
+
+using BundledExecutors = ::testing::Types<
+  exec::thread_pool<>,
+  ordered_thread_pool<exec::queue_order::fifo>,
+  ordered_thread_pool<exec::queue_order::lifo_local_fifo_global>,
+  ordered_thread_pool<exec::queue_order::lifo, false>,
+  ordered_thread_pool<exec::queue_order::lifo_local_fifo_global, true>,
+  mpmc_thread_pool<1024>,
+  mpmc_thread_pool<2>,
+  fair_thread_pool,
+  exec::inline_executor,
+  exec::adaptive_executor<exec::thread_pool<>>>;
+
+TYPED_TEST_CASE(ExecutorConformance, BundledExecutors);
+
+TYPED_TEST(ExecutorConformance, Execute)
+{
+  static constexpr std::size_t kWork = 64;
+
+  std::atomic<std::size_t> count{0};
+  for (std::size_t i = 0; i < kWork; ++i)
+  {
+    this->e_->execute([&count] { ++count; });
+  }
+
+  this->wait_for(count, kWork);
+  EXPECT_EQ(count.load(), kWork);
+}
+
+TYPED_TEST(ExecutorConformance, BulkExecute)
+{
+  static constexpr std::size_t kWork = 64;
+
+  std::vector<std::atomic<std::size_t>> invocations(kWork);
+  std::atomic<std::size_t> count{0};
+  auto work = [&](const std::size_t i) {
+    ++invocations[i];
+    ++count;
+  };
+  this->e_->bulk_execute(kWork, work);
+
+  this->wait_for(count, kWork);
+  for (const auto& n : invocations)
+  {
+    EXPECT_EQ(n.load(), 1UL);
+  }
+}
+
+TYPED_TEST(ExecutorConformance, BatchExecute)
+{
+  static constexpr std::size_t kWork = 16;
+
+  std::vector<std::atomic<std::size_t>> invocations(kWork);
+  std::atomic<std::size_t> count{0};
+  auto work = [&](const std::size_t i) {
+    ++invocations[i];
+    ++count;
+  };
+  for (std::size_t n = 0; n < 4; ++n)
+  {
+    exec::task_batch<kWork, decltype(work)> batch{work};
+    this->e_->bulk_execute(batch);
+    this->wait_for(count, kWork * (n + 1));
+  }
+
+  for (const auto& n : invocations)
+  {
+    EXPECT_EQ(n.load(), 4UL);
+  }
+}
+
+TYPED_TEST(ExecutorConformance, AllDispatch)
+{
+  // clang-format off
+  auto r = pass(1)
+         | all(
+             *this->e_,
+             [](int a) -> result<int> { return a + 1; },
+             [](int a) -> result<float> { return a + 2.f; });
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, std::make_tuple(2, 3.f)) << r.status();
+}
+
+TYPED_TEST(ExecutorConformance, AllDispatchFailure)
+{
+  // clang-format off
+  auto r = pass(1)
+         | all(
+             *this->e_,
+             [](int a) -> result<int> { return a + 1; },
+             [](int a) -> result<float> { return "failed"_msg; });
+  // clang-format on
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+}
+
+TYPED_TEST(ExecutorConformance, AnyDispatch)
+{
+  // clang-format off
+  auto r = pass(1)
+         | any(
+             *this->e_,
+             [](int a) -> result<int> { return "failed"_msg; },
+             [](int a) -> result<int> { return a + 2; });
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 3) << r.status();
+}
+
+TYPED_TEST(ExecutorConformance, DispatchHandle)
+{
+  using handle_type = exec::handle_type_t<TypeParam>;
+
+  // clang-format off
+  auto r = pass(1)
+         | all(
+             *this->e_,
+             [](handle_type& handle, int a) -> result<bool> { return handle.is_working(); },
+             [](int a) -> result<int> { return a; });
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, std::make_tuple(true, 1)) << r.status();
+}
+
+TYPED_TEST(ExecutorConformance, NestedDispatch)
+{
+  // clang-format off
+  auto r = pass(1)
+         | all(
+             *this->e_,
+             any(
+               *this->e_,
+               [](int a) -> result<int> { return "failed"_msg; },
+               [](int a) -> result<int> { return a + 1; }),
+             [](int a) -> result<int> { return a + 2; });
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, std::make_tuple(2, 3)) << r.status();
+}
+
+TYPED_TEST(ExecutorConformance, DispatchArena)
+{
+  using handle_type = exec::handle_type_t<TypeParam>;
+
+  arena a;
+  {
+    const arena_scope scope{a};
+
+    // clang-format off
+    auto r = pass(4)
+           | all(
+               *this->e_,
+               [&a](handle_type& handle, int n) -> result<bool>
+               {
+                 std::pmr::vector<int> v{handle.resource()};
+                 v.resize(n);
+                 return handle.arena() == &a && current_arena() == &a;
+               },
+               [&a](int n) -> result<bool> { return current_arena() == &a; });
+    // clang-format on
+
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, std::make_tuple(true, true)) << r.status();
+  }
+  EXPECT_EQ(current_arena(), nullptr);
+  EXPECT_GT(a.allocations(), 2UL);
+
+  a.reset();
+  EXPECT_EQ(a.allocations(), 0UL);
+  EXPECT_EQ(a.used(), 0UL);
+}
+
+TYPED_TEST(ExecutorConformance, WorkerLocal)
+{
+  using handle_type = exec::handle_type_t<TypeParam>;
+
+  std::mutex mtx;
+  std::map<std::thread::id, std::vector<int>*> buffers;
+
+  const auto stage = [&](const handle_type& handle, int n) -> result<bool> {
+    auto& buffer = handle.template local<std::vector<int>>();
+    buffer.resize(n);
+
+    std::lock_guard lock{mtx};
+    const auto [itr, inserted] = buffers.emplace(std::this_thread::get_id(), &buffer);
+    return inserted || itr->second == &buffer;
+  };
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    // clang-format off
+    auto r = pass(8)
+           | all(*this->e_, stage, stage, stage, stage);
+    // clang-format on
+
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, std::make_tuple(true, true, true, true)) << r.status();
+  }
+}
+
+TEST(ThreadPool, WorkerLocalNotShared)
+{
+  exec::thread_pool<> tp{4};
+
+  std::mutex mtx;
+  std::map<std::size_t*, std::thread::id> owners;
+
+  const auto stage = [&](const exec::thread_pool_handle& handle, int n) -> result<bool> {
+    auto& count = handle.local<std::size_t>();
+    count += n;
+
+    std::lock_guard lock{mtx};
+    const auto [itr, inserted] = owners.emplace(&count, std::this_thread::get_id());
+    return itr->second == std::this_thread::get_id();
+  };
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    // clang-format off
+    auto r = pass(1)
+           | all(tp, stage, stage, stage, stage);
+    // clang-format on
+
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, std::make_tuple(true, true, true, true)) << r.status();
+  }
+  EXPECT_LE(owners.size(), tp.workers());
+}
+
+TEST(ThreadPool, MpmcQueueFullRunsInlineWhenAsked)
+{
+  mpmc_thread_pool<2, true> tp{1};
+
+  // Occupy the only worker
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  tp.execute([&] {
+    started = true;
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+
+  // Fill the queue, then overflow it
+  std::atomic<std::size_t> count{0};
+  std::thread::id overflow_thread;
+  tp.execute([&] { ++count; });
+  tp.execute([&] { ++count; });
+  tp.execute([&] {
+    overflow_thread = std::this_thread::get_id();
+    ++count;
+  });
+  EXPECT_EQ(overflow_thread, std::this_thread::get_id());
+
+  release = true;
+  while (count.load() < 3)
+  {
+    std::this_thread::yield();
+  }
+}
+
+/**
+ * @brief Submits <code>n</code> tasks to a pool with one worker, while the worker is busy, and returns the order in
+ *        which they ran
+ *
+ * @param delay  time to wait after submitting the first task
+ */
+template <typename ThreadPoolT>
+std::vector<int> run_order(ThreadPoolT& tp, int n, std::chrono::milliseconds delay = std::chrono::milliseconds{0})
+{
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  tp.execute([&] {
+    started = true;
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+
+  std::mutex mtx;
+  std::vector<int> order;
+  std::atomic<int> count{0};
+  for (int i = 0; i < n; ++i)
+  {
+    tp.execute([&, i] {
+      {
+        std::lock_guard lock{mtx};
+        order.push_back(i);
+      }
+      ++count;
+    });
+    if (i == 0)
+    {
+      std::this_thread::sleep_for(delay);
+    }
+  }
+
+  release = true;
+  while (count.load() < n)
+  {
+    std::this_thread::yield();
+  }
+  return order;
+}
+
+TEST(ThreadPool, MpmcQueueFullSpillsInOrder)
+{
+  mpmc_thread_pool<2> tp{1};
+  EXPECT_EQ(run_order(tp, 8), (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7}));
+  EXPECT_EQ(tp.metrics().submitted, 9UL);
+}
+
+TEST(ThreadPool, LifoOrder)
+{
+  ordered_thread_pool<exec::queue_order::lifo> tp{1};
+  EXPECT_EQ(run_order(tp, 4), (std::vector<int>{3, 2, 1, 0}));
+}
+
+TEST(ThreadPool, FifoOrder)
+{
+  ordered_thread_pool<exec::queue_order::fifo> tp{1};
+  EXPECT_EQ(run_order(tp, 4), (std::vector<int>{0, 1, 2, 3}));
+}
+
+TEST(ThreadPool, LifoUnbounded)
+{
+  ordered_thread_pool<exec::queue_order::lifo, false> tp{1};
+
+  // Without a max-wait bound, the first task keeps waiting behind newer tasks however long it has waited
+  EXPECT_EQ(run_order(tp, 4, std::chrono::milliseconds{50}), (std::vector<int>{3, 2, 1, 0}));
+}
+
+TEST(ThreadPool, LifoMaxQueueWait)
+{
+  ordered_thread_pool<exec::queue_order::lifo> tp{1};
+  tp.set_max_queue_wait(std::chrono::milliseconds{20});
+
+  // First task has waited longer than the bound, so it runs before newer tasks, which are then served newest first
+  EXPECT_EQ(run_order(tp, 4, std::chrono::milliseconds{50}), (std::vector<int>{0, 3, 2, 1}));
+}
+
+/**
+ * @brief Submits a task node, a closure and another task node to a pool with one worker, while the worker is busy,
+ *        and returns the order in which they ran
+ */
+template <typename ThreadPoolT> std::vector<int> run_mixed_order(ThreadPoolT& tp)
+{
+  struct recording_node : exec::task_node
+  {
+    std::vector<int>* order;
+    std::atomic<int>* count;
+    int id;
+  };
+
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  tp.execute([&] {
+    started = true;
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+
+  // Only the worker touches order, one piece of work at a time
+  std::vector<int> order;
+  std::atomic<int> count{0};
+  recording_node nodes[2];
+  for (int i = 0; i < 2; ++i)
+  {
+    nodes[i].order = &order;
+    nodes[i].count = &count;
+    nodes[i].id = 2 * i;
+    nodes[i].run = [](exec::task_node& n) {
+      auto& r = static_cast<recording_node&>(n);
+      r.order->push_back(r.id);
+      ++*r.count;
+    };
+  }
+
+  // Distinct enqueue times, well within the default max-wait bound
+  tp.execute_intrusive(nodes[0], nodes[0]);
+  std::this_thread::sleep_for(std::chrono::microseconds{100});
+  tp.execute([&] {
+    order.push_back(1);
+    ++count;
+  });
+  std::this_thread::sleep_for(std::chrono::microseconds{100});
+  tp.execute_intrusive(nodes[1], nodes[1]);
+
+  release = true;
+  while (count.load() < 3)
+  {
+    std::this_thread::yield();
+  }
+  return order;
+}
+
+TEST(ThreadPool, LifoOrdersTaskNodesWithClosures)
+{
+  ordered_thread_pool<exec::queue_order::lifo> tp{1};
+
+  // Closure is newer than the next task node, so it is not held back behind dispatch work
+  EXPECT_EQ(run_mixed_order(tp), (std::vector<int>{1, 0, 2}));
+}
+
+TEST(ThreadPool, FifoOrdersTaskNodesWithClosures)
+{
+  ordered_thread_pool<exec::queue_order::fifo> tp{1};
+  EXPECT_EQ(run_mixed_order(tp), (std::vector<int>{0, 1, 2}));
+}
+
+TEST(ThreadPool, LifoLocalFifoGlobalOrder)
+{
+  ordered_thread_pool<exec::queue_order::lifo_local_fifo_global> tp{1};
+
+  std::mutex mtx;
+  std::vector<int> order;
+  std::atomic<int> count{0};
+  const auto record = [&](int i) {
+    return [&, i] {
+      {
+        std::lock_guard lock{mtx};
+        order.push_back(i);
+      }
+      ++count;
+    };
+  };
+
+  // Worker submits local tasks 1, 2 and 3 while global tasks 10 and 11 are submitted from outside
+  std::atomic<int> global_submitted{0};
+  tp.execute([&] {
+    tp.execute(record(1));
+    tp.execute(record(2));
+    tp.execute(record(3));
+    while (global_submitted < 2)
+    {
+      std::this_thread::yield();
+    }
+  });
+  tp.execute(record(10));
+  ++global_submitted;
+  tp.execute(record(11));
+  ++global_submitted;
+
+  while (count.load() < 5)
+  {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(order, (std::vector<int>{3, 2, 1, 10, 11}));
+}
+
+TEST(ThreadPool, QueueAge)
+{
+  exec::thread_pool<> tp{2};
+  const auto order = run_order(tp, 16);
+  ASSERT_EQ(order.size(), 16UL);
+
+  const auto& age = tp.queue_age();
+  EXPECT_EQ(age.count(), 17UL);
+  EXPECT_LE(age.percentile(0.5), age.percentile(0.99));
+  EXPECT_LE(age.percentile(0.99), age.max());
+  EXPECT_GT(age.max(), std::chrono::nanoseconds::zero());
+}
+
+template <typename PoolT> class PoolMetrics : public ::testing::Test
+{};
+
+using MeteredPools = ::testing::Types<
+  exec::thread_pool<>,
+  ordered_thread_pool<exec::queue_order::lifo_local_fifo_global>,
+  mpmc_thread_pool<1024>,
+  fair_thread_pool>;
+
+TYPED_TEST_CASE(PoolMetrics, MeteredPools);
+
+TYPED_TEST(PoolMetrics, Snapshot)
+{
+  TypeParam tp{2};
+  std::atomic<int> count{0};
+  for (int i = 0; i < 32; ++i)
+  {
+    tp.execute([&count] {
+      std::this_thread::sleep_for(std::chrono::microseconds{100});
+      ++count;
+    });
+  }
+
+  // Workers account for work just after it has run
+  exec::pool_metrics m = tp.metrics();
+  while (m.completed < 32)
+  {
+    std::this_thread::yield();
+    m = tp.metrics();
+  }
+
+  EXPECT_EQ(count.load(), 32);
+  EXPECT_EQ(m.depth, 0UL);
+  EXPECT_EQ(m.submitted, 32UL);
+  EXPECT_EQ(m.completed, 32UL);
+  EXPECT_EQ(m.wait.count, 32UL);
+  EXPECT_EQ(m.run.count, 32UL);
+  EXPECT_GE(m.run.p50, std::chrono::microseconds{64});
+  EXPECT_LE(m.run.p50, m.run.p99);
+  EXPECT_LE(m.run.p99, m.run.max);
+
+  ASSERT_EQ(m.workers.size(), 2UL);
+  std::uint64_t completed = 0;
+  for (const auto& w : m.workers)
+  {
+    completed += w.completed;
+    EXPECT_GE(w.utilization(), 0.0);
+    EXPECT_LE(w.utilization(), 1.0);
+  }
+  EXPECT_EQ(completed, 32UL);
+
+  std::ostringstream oss;
+  oss << m;
+  EXPECT_NE(oss.str().find("completed=32"), std::string::npos);
+}
+
+TEST(ThreadPool, MetricsSteals)
+{
+  ordered_thread_pool<exec::queue_order::lifo_local_fifo_global> tp{2};
+
+  // Worker blocks until the work it submitted to its own stack has run, which only the other worker can do
+  std::atomic<bool> stolen{false};
+  tp.execute([&] {
+    tp.execute([&stolen] { stolen = true; });
+    while (!stolen)
+    {
+      std::this_thread::yield();
+    }
+  });
+
+  exec::pool_metrics m = tp.metrics();
+  while (m.completed < 2)
+  {
+    std::this_thread::yield();
+    m = tp.metrics();
+  }
+  EXPECT_EQ(m.steals, 1UL);
+}
+
+TEST(ThreadPool, MetricsCallback)
+{
+  exec::thread_pool<> tp{1};
+  tp.execute([] {});
+
+  std::mutex mtx;
+  std::vector<exec::pool_metrics> reports;
+  tp.on_metrics(std::chrono::milliseconds{1}, [&](const exec::pool_metrics& m) {
+    std::lock_guard lock{mtx};
+    reports.push_back(m);
+  });
+
+  while (true)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    std::lock_guard lock{mtx};
+    if (reports.size() >= 3)
+    {
+      break;
+    }
+  }
+
+  // Stops reporting
+  tp.on_metrics(std::chrono::hours{1}, [](const exec::pool_metrics&) { FAIL(); });
+
+  std::lock_guard lock{mtx};
+  for (const auto& m : reports)
+  {
+    EXPECT_EQ(m.submitted, 1UL);
+    EXPECT_EQ(m.workers.size(), 1UL);
+  }
+}
+
+TEST(ThreadPool, FairShareByWeight)
+{
+  fair_thread_pool tp{1};
+  tp.configure_tenant(1, exec::tenant_config{3});
+  tp.configure_tenant(2, exec::tenant_config{1});
+
+  std::atomic<bool> release{false};
+  std::atomic<bool> started{false};
+  tp.execute([&] {
+    started = true;
+    while (!release)
+    {
+      std::this_thread::yield();
+    }
+  });
+  while (!started)
+  {
+    std::this_thread::yield();
+  }
+
+  // Tenant 1 submits all of its work before tenant 2, and each task runs for longer than a turn
+  std::mutex mtx;
+  std::vector<std::size_t> order;
+  std::atomic<int> count{0};
+  for (std::size_t tenant : {1, 2})
+  {
+    const exec::tenant_scope scope{tenant};
+    for (int i = 0; i < 8; ++i)
+    {
+      tp.execute([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        {
+          std::lock_guard lock{mtx};
+          order.push_back(exec::current_tenant());
+        }
+        ++count;
+      });
+    }
+  }
+
+  release = true;
+  while (count.load() < 16)
+  {
+    std::this_thread::yield();
+  }
+
+  // Tenants take turns, with tenant 1 receiving about three times as much worker time
+  const auto first_half = std::count(order.begin(), order.begin() + 8, std::size_t{1});
+  EXPECT_GE(first_half, 5);
+  EXPECT_LT(first_half, 8);
+  EXPECT_EQ(tp.tenant(1).completed.load(), 8UL);
+  EXPECT_EQ(tp.tenant(2).completed.load(), 8UL);
+}
+
+TEST(ThreadPool, TenantConcurrencyCap)
+{
+  fair_thread_pool tp{4};
+  exec::tenant_config config;
+  config.max_concurrency = 1;
+  tp.configure_tenant(1, config);
+
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+  std::atomic<int> count{0};
+  {
+    const exec::tenant_scope scope{1};
+    for (int i = 0; i < 8; ++i)
+    {
+      tp.execute([&] {
+        const int now = ++running;
+        int prev = max_running.load();
+        while (prev < now && !max_running.compare_exchange_weak(prev, now))
+        {}
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        --running;
+        ++count;
+      });
+    }
+  }
+  while (count.load() < 8)
+  {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(max_running.load(), 1);
+
+  const auto& stats = tp.tenant(1);
+  EXPECT_EQ(stats.submitted.load(), 8UL);
+  EXPECT_EQ(stats.depth.load(), 0UL);
+  EXPECT_EQ(stats.wait.count(), 8UL);
+  EXPECT_EQ(stats.run.count(), 8UL);
+  EXPECT_GE(stats.run.max(), std::chrono::milliseconds{1});
+}
+
+TEST(ThreadPool, TenantConcurrencyCapWithNestedDispatch)
+{
+  fair_thread_pool tp{4};
+  tp.configure_tenant(1, exec::tenant_config{1, 1});
+
+  std::atomic<int> running{0};
+  std::atomic<int> max_running{0};
+
+  // Each outer branch counts towards the cap, and blocks on branches of its own nested dispatch, which must still run
+  const auto outer = [&](int x) -> result<int> {
+    const int now = ++running;
+    int prev = max_running.load();
+    while (prev < now && !max_running.compare_exchange_weak(prev, now))
+    {}
+    // clang-format off
+    auto r = pass(x)
+           | all(tp, [](int y) -> result<int> { return y + 1; }, [](int y) -> result<int> { return y + 2; })
+           | [](int a, int b) -> result<int> { return a + b; };
+    // clang-format on
+    --running;
+    return r;
+  };
+
+  for (int i = 0; i < 16; ++i)
+  {
+    const exec::tenant_scope scope{1};
+    // clang-format off
+    auto r = pass(i) | all(tp, outer, outer, outer);
+    // clang-format on
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(std::get<0>(*r), 2 * i + 3);
+  }
+  EXPECT_EQ(max_running.load(), 1);
+}
+
+TEST(ThreadPool, SparseTenantIds)
+{
+  fair_thread_pool tp{2};
+
+  std::atomic<int> count{0};
+  for (std::size_t tenant : {std::size_t{1'000'000}, std::size_t{7}, ~std::size_t{0}})
+  {
+    const exec::tenant_scope scope{tenant};
+    tp.execute([&count] { ++count; });
+  }
+  while (count.load() < 3)
+  {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(tp.tenant(1'000'000).submitted.load(), 1UL);
+  EXPECT_EQ(tp.tenant(~std::size_t{0}).submitted.load(), 1UL);
+}
+
+TEST(ThreadPool, TenantOfNestedWork)
+{
+  fair_thread_pool tp{2};
+
+  std::atomic<std::size_t> outer{exec::kDefaultTenant};
+  std::atomic<std::size_t> inner{exec::kDefaultTenant};
+  std::atomic<bool> done{false};
+  {
+    const exec::tenant_scope scope{5};
+    EXPECT_EQ(exec::current_tenant(), 5UL);
+    tp.execute([&] {
+      outer = exec::current_tenant();
+      tp.execute([&] {
+        inner = exec::current_tenant();
+        done = true;
+      });
+    });
+  }
+  EXPECT_EQ(exec::current_tenant(), exec::kDefaultTenant);
+
+  while (!done)
+  {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(outer.load(), 5UL);
+  EXPECT_EQ(inner.load(), 5UL);
+  EXPECT_EQ(tp.tenant(5).submitted.load(), 2UL);
+}
+
+TEST(Histogram, Percentiles)
+{
+  histogram h;
+  EXPECT_EQ(h.percentile(0.5), std::chrono::nanoseconds::zero());
+
+  for (int i = 0; i < 99; ++i)
+  {
+    h.record(std::chrono::nanoseconds{100});
+  }
+  h.record(std::chrono::microseconds{100});
+
+  EXPECT_EQ(h.count(), 100UL);
+  EXPECT_GE(h.percentile(0.5), std::chrono::nanoseconds{100});
+  EXPECT_LT(h.percentile(0.5), std::chrono::nanoseconds{200});
+  EXPECT_EQ(h.percentile(1.0), std::chrono::microseconds{100});
+  EXPECT_EQ(h.max(), std::chrono::microseconds{100});
+
+  h.reset();
+  EXPECT_EQ(h.count(), 0UL);
+}
+
+TEST(Histogram, SummaryAndMerge)
+{
+  histogram a;
+  histogram b;
+  for (int i = 0; i < 90; ++i)
+  {
+    a.record(std::chrono::nanoseconds{100});
+  }
+  for (int i = 0; i < 10; ++i)
+  {
+    b.record(std::chrono::microseconds{100});
+  }
+
+  a.merge(b);
+  const histogram_summary s = a.summary();
+  EXPECT_EQ(s.count, 100UL);
+  EXPECT_LT(s.p50, std::chrono::nanoseconds{200});
+  EXPECT_LT(s.p90, std::chrono::nanoseconds{200});
+  EXPECT_EQ(s.p99, std::chrono::microseconds{100});
+  EXPECT_EQ(s.max, std::chrono::microseconds{100});
+}
+
+TEST(HdrHistogram, Percentiles)
+{
+  hdr_histogram h;
+  EXPECT_EQ(h.percentile(0.999), std::chrono::nanoseconds::zero());
+
+  for (int i = 1; i <= 100000; ++i)
+  {
+    h.record(std::chrono::nanoseconds{i});
+  }
+
+  // Within about 3%
+  EXPECT_EQ(h.count(), 100000UL);
+  EXPECT_NEAR(h.percentile(0.5).count(), 50000, 1600);
+  EXPECT_NEAR(h.percentile(0.99).count(), 99000, 3200);
+  EXPECT_NEAR(h.percentile(0.999).count(), 99900, 3200);
+  EXPECT_EQ(h.percentile(1.0), std::chrono::nanoseconds{100000});
+
+  hdr_histogram merged;
+  merged.record(std::chrono::nanoseconds{7});
+  merged.merge(h);
+  EXPECT_EQ(merged.count(), 100001UL);
+  EXPECT_EQ(merged.percentile(0.0), std::chrono::nanoseconds{1});
+}
+
+TEST(Arena, AllocateAndReset)
+{
+  arena a{256};
+
+  void* const p = a.allocate(24, 8);
+  void* const q = a.allocate(16, 16);
+  EXPECT_NE(p, q);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(q) % 16, 0UL);
+  EXPECT_GE(a.used(), 40UL);
+  EXPECT_EQ(a.allocations(), 2UL);
+
+  a.reset();
+  EXPECT_EQ(a.used(), 0UL);
+  EXPECT_EQ(a.allocate(24, 8), p);
+}
+
+TEST(Arena, Overflow)
+{
+  arena a{64};
+  {
+    std::pmr::vector<int> v{&a};
+    v.resize(1024);
+    EXPECT_EQ(v.back(), 0);
+    EXPECT_LE(a.used(), a.capacity());
+  }
+  a.reset();
+  EXPECT_EQ(a.used(), 0UL);
+}
+
+TEST(AdaptiveExecutor, InlineForTinyWork)
+{
+  exec::thread_pool<> tp{4};
+  exec::adaptive_executor site{tp, "tiny"};
+
+  for (std::size_t i = 0; i < 256; ++i)
+  {
+    // clang-format off
+    auto r = pass(1)
+           | all(
+               site,
+               [](int a) -> result<int> { return a + 1; },
+               [](int a) -> result<int> { return a + 2; });
+    // clang-format on
+    ASSERT_TRUE(r.valid()) << r.status();
+  }
+
+  const auto report = site.report();
+  EXPECT_EQ(report.inline_count + report.partial_count + report.parallel_count, 256UL);
+  EXPECT_GT(report.inline_count, report.partial_count + report.parallel_count);
+}
+
+TEST(AdaptiveExecutor, ParallelForHeavyWork)
+{
+  exec::thread_pool<> tp{4};
+  exec::adaptive_executor site{tp, "heavy"};
+
+  const auto heavy = [](int a) -> result<int> {
+    std::this_thread::sleep_for(std::chrono::milliseconds{2});
+    return a;
+  };
+
+  for (std::size_t i = 0; i < 16; ++i)
+  {
+    // clang-format off
+    auto r = pass(1)
+           | all(site, heavy, heavy, heavy, heavy);
+    // clang-format on
+    ASSERT_TRUE(r.valid()) << r.status();
+  }
+
+  const auto report = site.report();
+  EXPECT_EQ(report.inline_count, 0UL);
+  EXPECT_EQ(report.partial_count + report.parallel_count, 16UL);
+  EXPECT_GE(report.work, std::chrono::milliseconds{2});
+}
+
+TEST(AdaptiveExecutor, BulkExecuteReturnsOnceEveryIndexHasRun)
+{
+  exec::thread_pool<> tp{4};
+  exec::adaptive_executor site{tp, "bulk"};
+
+  static constexpr std::size_t kInvocations = 64;
+  std::atomic<std::size_t> counts[kInvocations] = {};
+  auto fn = [&counts](std::size_t i) { counts[i].fetch_add(1, std::memory_order_relaxed); };
+  for (std::size_t n = 1; n <= 128; ++n)
+  {
+    site.bulk_execute(kInvocations, fn);
+    for (const auto& count : counts)
+    {
+      ASSERT_EQ(count.load(std::memory_order_relaxed), n);
+    }
+  }
+}
+
+TEST(AdaptiveExecutor, Report)
+{
+  exec::inline_executor inner;
+  exec::adaptive_executor site{inner, "site"};
+
+  // clang-format off
+  auto r = pass(1)
+         | any(
+             site,
+             [](int a) -> result<int> { return "failed"_msg; },
+             [](int a) -> result<int> { return a; });
+  // clang-format on
+  ASSERT_TRUE(r.valid()) << r.status();
+
+  std::ostringstream oss;
+  oss << site.report();
+  EXPECT_EQ(oss.str().rfind("site: inline=0 partial=0 parallel=1", 0), 0UL) << oss.str();
+}
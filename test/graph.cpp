@@ -0,0 +1,228 @@
+// C++ Standard Library
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/executor.hpp>
+#include <zen/graph.hpp>
+
+using namespace zen;
+
+TEST(Graph, Diamond)
+{
+  exec::thread_pool tp{4};
+
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](const int a) -> result<int> { return a + 1; }, a);
+  const auto c = g.add([](const int a) { return a * 3; }, a);
+  const auto d = g.add([](const int b, const int c) -> result<int> { return b + c; }, b, c);
+
+  const auto status = g.run(tp);
+
+  ASSERT_TRUE(status.valid()) << status;
+  ASSERT_TRUE(g.get(d).valid()) << g.get(d).status();
+  EXPECT_EQ(*g.get(d), 5);
+
+  const auto path = g.critical_path();
+  ASSERT_EQ(path.size(), 3UL);
+  EXPECT_EQ(path.front(), a.id());
+  EXPECT_EQ(path.back(), d.id());
+}
+
+TEST(Graph, FailurePrunesDownstream)
+{
+  exec::thread_pool tp{4};
+
+  std::atomic<bool> pruned_invoked{false};
+
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](const int a) -> result<int> { return "b failed"_msg; }, a);
+  const auto c = g.add([](const int a) -> result<int> { return a; }, a);
+  const auto d = g.add(
+    [&pruned_invoked](const int b, const int c) -> result<int> {
+      pruned_invoked = true;
+      return b + c;
+    },
+    b,
+    c);
+
+  const auto status = g.run(tp);
+
+  ASSERT_FALSE(status.valid());
+  EXPECT_EQ(status, "b failed"_msg);
+  EXPECT_TRUE(g.get(c).valid());
+  EXPECT_FALSE(g.get(d).valid());
+  EXPECT_EQ(g.get(d).status(), "b failed"_msg);
+  EXPECT_FALSE(pruned_invoked);
+}
+
+TEST(Graph, Rerun)
+{
+  exec::thread_pool tp{4};
+
+  int source = 1;
+
+  graph g;
+  const auto a = g.add([&source]() -> result<int> { return source; });
+  const auto b = g.add([](const int a) -> result<std::vector<int>> { return std::vector<int>(a, a); }, a);
+
+  for (; source < 4; ++source)
+  {
+    ASSERT_TRUE(g.run(tp).valid());
+    EXPECT_EQ(*g.get(b), std::vector<int>(source, source));
+  }
+}
+
+TEST(Graph, RunThenDestroy)
+{
+  exec::thread_pool tp{4};
+
+  // Graphs are destroyed as soon as run() returns, while workers may still be finishing up the last node
+  for (int i = 0; i < 1000; ++i)
+  {
+    auto g = std::make_unique<graph>();
+    const auto a = g->add([]() -> result<int> { return 1; });
+    const auto b = g->add([](const int a) -> result<int> { return a + 1; }, a);
+    const auto c = g->add([](const int a) -> result<int> { return a + 2; }, a);
+    g->add([](const int b, const int c) -> result<int> { return b + c; }, b, c);
+    ASSERT_TRUE(g->run(tp).valid());
+  }
+}
+
+TEST(Graph, FanInWaitsForAllInputs)
+{
+  exec::thread_pool tp{4};
+
+  std::atomic<int> sequence{0};
+  std::atomic<int> inputs_done{0};
+
+  graph g;
+  const auto root = g.add([&sequence]() -> result<int> { return sequence++; });
+
+  std::vector<std::decay_t<decltype(root)>> inputs;
+  for (int i = 0; i < 8; ++i)
+  {
+    inputs.push_back(g.add(
+      [&sequence, &inputs_done](const int root) -> result<int> {
+        ++inputs_done;
+        return sequence++ - root;
+      },
+      root));
+  }
+
+  const auto sink = g.add(
+    [&inputs_done](int a, int b, int c, int d, int e, int f, int g, int h) -> result<int> {
+      EXPECT_EQ(inputs_done.load(), 8);
+      return a + b + c + d + e + f + g + h;
+    },
+    inputs[0],
+    inputs[1],
+    inputs[2],
+    inputs[3],
+    inputs[4],
+    inputs[5],
+    inputs[6],
+    inputs[7]);
+
+  ASSERT_TRUE(g.run(tp).valid());
+
+  // Root runs first, and each input sees its own place in the sequence after it
+  EXPECT_EQ(*g.get(root), 0);
+  EXPECT_EQ(*g.get(sink), 1 + 2 + 3 + 4 + 5 + 6 + 7 + 8);
+
+  const auto path = g.critical_path();
+  ASSERT_EQ(path.size(), 3UL);
+  EXPECT_EQ(path.front(), root.id());
+  EXPECT_EQ(path.back(), sink.id());
+}
+
+TEST(Graph, FailurePropagatesTransitively)
+{
+  exec::thread_pool tp{4};
+
+  std::atomic<int> invoked{0};
+
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](const int a) -> result<int> { return "b failed"_msg; }, a);
+  const auto c = g.add(
+    [&invoked](const int b) -> result<int> {
+      ++invoked;
+      return b;
+    },
+    b);
+  const auto d = g.add(
+    [&invoked](const int c) -> result<int> {
+      ++invoked;
+      return c;
+    },
+    c);
+  const auto e = g.add([](const int a) -> result<int> { return a + 1; }, a);
+
+  const auto status = g.run(tp);
+
+  ASSERT_FALSE(status.valid());
+  EXPECT_EQ(status, "b failed"_msg);
+  EXPECT_EQ(invoked.load(), 0);
+  EXPECT_EQ(g.get(c).status(), "b failed"_msg);
+  EXPECT_EQ(g.get(d).status(), "b failed"_msg);
+  ASSERT_TRUE(g.get(e).valid());
+  EXPECT_EQ(*g.get(e), 2);
+}
+
+TEST(Graph, RerunAfterFailure)
+{
+  exec::thread_pool tp{4};
+
+  bool fail = true;
+
+  graph g;
+  const auto a = g.add([&fail]() -> result<int> {
+    if (fail)
+    {
+      return "a failed"_msg;
+    }
+    return 1;
+  });
+  const auto b = g.add([](const int a) -> result<int> { return a + 1; }, a);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    const auto status = g.run(tp);
+    if (fail)
+    {
+      EXPECT_EQ(status, "a failed"_msg);
+      EXPECT_EQ(g.get(b).status(), "a failed"_msg);
+    }
+    else
+    {
+      ASSERT_TRUE(status.valid());
+      EXPECT_EQ(*g.get(b), 2);
+    }
+    fail = !fail;
+  }
+}
+
+TEST(Graph, InlineExecutor)
+{
+  exec::inline_executor ie;
+
+  graph g;
+  const auto a = g.add([]() -> result<int> { return 1; });
+  const auto b = g.add([](const int a) -> result<int> { return a + 1; }, a);
+  const auto c = g.add([](const int a) -> result<int> { return a + 2; }, a);
+  const auto d = g.add([](const int b, const int c) -> result<int> { return b + c; }, b, c);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    ASSERT_TRUE(g.run(ie).valid());
+    EXPECT_EQ(*g.get(d), 5);
+  }
+}
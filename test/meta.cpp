@@ -44,6 +44,33 @@ TEST(ResultOfApply, WithAlternatives)
   EXPECT_TRUE((std::is_same_v<result_type, double>));
 }
 
+namespace
+{
+
+double scale(const float, const int&) { return 1; }
+
+}  // namespace
+
+TEST(ArgumentsOf, Invocables)
+{
+  auto l = [](const int, const float&) { return double{1}; };
+  auto m = [](int) mutable noexcept {};
+
+  EXPECT_TRUE((std::is_same_v<arguments_of_t<decltype(l)>, std::tuple<int, const float&>>));
+  EXPECT_TRUE((std::is_same_v<arguments_of_t<decltype(m)>, std::tuple<int>>));
+  EXPECT_TRUE((std::is_same_v<arguments_of_t<decltype(&scale)>, std::tuple<float, const int&>>));
+  EXPECT_TRUE((std::is_same_v<arguments_of_t<decltype(scale)>, std::tuple<float, const int&>>));
+}
+
+TEST(ArgumentsOf, GenericInvocables)
+{
+  auto l = [](const auto) {};
+
+  EXPECT_FALSE(has_arguments_v<decltype(l)>);
+  EXPECT_FALSE(has_arguments_v<int>);
+  EXPECT_TRUE(has_arguments_v<decltype(&scale)>);
+}
+
 TEST(Append, Single)
 {
   using lhs_type = std::tuple<const int, const float>;
@@ -1,4 +1,8 @@
 // C++ Standard Library
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 // GTest
@@ -34,6 +38,171 @@ TEST(Result, MoveResultValue)
   EXPECT_EQ(value, (std::vector<int>{1, 2, 3, 4}));
 }
 
+TEST(Result, CopyAssignResultValue)
+{
+  result<std::vector<int>> r = std::vector<int>{1, 2, 3, 4};
+  result<std::vector<int>> copied;
+  copied = r;
+
+  ASSERT_TRUE(copied.valid());
+  EXPECT_EQ(*copied, *r);
+
+  result<std::vector<int>> moved{std::move(copied)};
+
+  ASSERT_TRUE(moved.valid());
+  EXPECT_EQ(*moved, (std::vector<int>{1, 2, 3, 4}));
+}
+
+namespace
+{
+
+/**
+ * @brief Payload which counts how it was copied and moved, and can be made to throw when copied
+ */
+struct tracked
+{
+  static inline int constructed = 0;
+  static inline int assigned = 0;
+  static inline int destroyed = 0;
+  static inline bool throw_on_copy = false;
+
+  explicit tracked(int v) : value{v} { ++constructed; }
+
+  tracked(const tracked& other) : value{other.value}
+  {
+    if (throw_on_copy)
+    {
+      throw std::runtime_error{"copy"};
+    }
+    ++constructed;
+  }
+
+  tracked(tracked&& other) noexcept : value{other.value} { ++constructed; }
+
+  tracked& operator=(const tracked& other)
+  {
+    if (throw_on_copy)
+    {
+      throw std::runtime_error{"copy"};
+    }
+    value = other.value;
+    ++assigned;
+    return *this;
+  }
+
+  tracked& operator=(tracked&& other) noexcept
+  {
+    value = other.value;
+    ++assigned;
+    return *this;
+  }
+
+  ~tracked() { ++destroyed; }
+
+  static void reset()
+  {
+    constructed = assigned = destroyed = 0;
+    throw_on_copy = false;
+  }
+
+  int value;
+};
+
+}  // namespace
+
+TEST(Result, AssignValidToValid)
+{
+  tracked::reset();
+  {
+    result<tracked> r{tracked{1}};
+    const result<tracked> other{tracked{2}};
+    tracked::reset();
+
+    r = other;
+    ASSERT_TRUE(r.valid());
+    EXPECT_EQ(r->value, 2);
+
+    r = result<tracked>{tracked{3}};
+    ASSERT_TRUE(r.valid());
+    EXPECT_EQ(r->value, 3);
+  }
+
+  // Payloads are assigned, rather than destroyed and constructed again
+  EXPECT_EQ(tracked::assigned, 2);
+}
+
+TEST(Result, AssignValidToInvalid)
+{
+  tracked::reset();
+  result<tracked> r;
+  const result<tracked> other{tracked{2}};
+  tracked::reset();
+
+  r = other;
+  ASSERT_TRUE(r.valid());
+  EXPECT_EQ(r->value, 2);
+  EXPECT_EQ(tracked::constructed, 1);
+  EXPECT_EQ(tracked::assigned, 0);
+}
+
+TEST(Result, AssignInvalidToValid)
+{
+  tracked::reset();
+  result<tracked> r{tracked{1}};
+  tracked::reset();
+
+  r = result<tracked>{"failed"_msg};
+  EXPECT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "failed"_msg);
+  EXPECT_EQ(tracked::destroyed, 1);
+}
+
+TEST(Result, AssignThrowingCopy)
+{
+  tracked::reset();
+  result<tracked> invalid;
+  result<tracked> valid{tracked{1}};
+  const result<tracked> other{tracked{2}};
+  tracked::throw_on_copy = true;
+
+  // Failed construction leaves an invalid result invalid
+  EXPECT_THROW(invalid = other, std::runtime_error);
+  EXPECT_FALSE(invalid.valid());
+
+  // Failed assignment leaves a valid result valid, holding its payload
+  EXPECT_THROW(valid = other, std::runtime_error);
+  ASSERT_TRUE(valid.valid());
+  EXPECT_EQ(valid->value, 1);
+
+  tracked::throw_on_copy = false;
+}
+
+TEST(Result, AssignNonAssignable)
+{
+  auto add = [n = 1](int i) { return i + n; };
+  using add_type = decltype(add);
+  static_assert(!std::is_copy_assignable_v<add_type>);
+
+  result<add_type> r{add};
+  r = result<add_type>{add};
+  ASSERT_TRUE(r.valid());
+  EXPECT_EQ((*r)(1), 2);
+
+  r = result<add_type>{"failed"_msg};
+  EXPECT_FALSE(r.valid());
+}
+
+TEST(Result, AssignNoexcept)
+{
+  static_assert(std::is_nothrow_copy_assignable_v<result<int>>);
+  static_assert(std::is_nothrow_move_assignable_v<result<int>>);
+  static_assert(std::is_nothrow_move_constructible_v<result<std::vector<int>>>);
+  static_assert(std::is_nothrow_move_assignable_v<result<std::vector<int>>>);
+  static_assert(!std::is_nothrow_copy_assignable_v<result<std::vector<int>>>);
+  static_assert(!std::is_nothrow_copy_assignable_v<result<tracked>>);
+  static_assert(std::is_nothrow_move_assignable_v<result<tracked>>);
+  static_assert(!std::is_nothrow_copy_constructible_v<result<std::string>>);
+}
 
 TEST(Result, CreateValidFromDeferredNoArg)
 {
@@ -96,3 +265,61 @@ TEST(Result, CreateMergedResult)
   ASSERT_TRUE(r.valid()) << r.status();
   EXPECT_EQ(r.value(), std::make_tuple(1, 2, 3));
 }
+
+TEST(Result, CreateMovesPayloads)
+{
+  auto r = create(
+    make_deferred_result([] { return result<std::unique_ptr<int>>{std::make_unique<int>(1)}; }),
+    make_deferred_result([] { return make_result(std::make_unique<int>(2), std::vector<int>{3, 4}); }));
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*std::get<0>(*r), 1);
+  EXPECT_EQ(*std::get<1>(*r), 2);
+  EXPECT_EQ(std::get<2>(*r), (std::vector<int>{3, 4}));
+}
+
+TEST(MessageRegistry, InternsMessages)
+{
+  const message_id id = "registry intern"_msg.id();
+  EXPECT_NE(id, kNoMessageId);
+  EXPECT_EQ("registry intern"_msg.id(), id);
+  EXPECT_NE("registry intern other"_msg.id(), id);
+  EXPECT_EQ(message_registry::instance().intern("registry intern"_msg.sv()), id);
+}
+
+TEST(MessageRegistry, CountsCreated)
+{
+  const auto& m = "registry created"_msg;
+  for (int i = 0; i < 3; ++i)
+  {
+    result<int> r{"registry created"_msg};
+    ASSERT_FALSE(r.valid());
+  }
+
+  const message_counts c = message_registry::instance().counts(m.sv());
+  EXPECT_EQ(c.id, m.id());
+  EXPECT_EQ(c.message, m.sv());
+  EXPECT_EQ(c.created, 3UL);
+  EXPECT_EQ(c.propagated, 0UL);
+}
+
+TEST(MessageRegistry, ForEach)
+{
+  result<int> r{"registry for each"_msg};
+
+  std::vector<message_counts> exported;
+  message_registry::instance().for_each([&exported](const message_counts& c) { exported.push_back(c); });
+  ASSERT_EQ(exported.size(), message_registry::instance().size());
+
+  bool found = false;
+  for (std::size_t i = 0; i < exported.size(); ++i)
+  {
+    EXPECT_EQ(exported[i].id, i);
+    if (exported[i].message == "registry for each"_msg.sv())
+    {
+      found = true;
+      EXPECT_EQ(exported[i].created, 1UL);
+    }
+  }
+  EXPECT_TRUE(found);
+}
@@ -0,0 +1,256 @@
+// C++ Standard Library
+#include <atomic>
+#include <chrono>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/parallel.hpp>
+#include <zen/stage.hpp>
+
+using namespace zen;
+
+TEST(Coalesce, Sequence)
+{
+  const auto stage = coalesce([](const int a) -> result<int> { return a + a; }, [](const int a) { return a; });
+
+  // clang-format off
+  auto r = pass(1)
+         | stage
+         | stage;
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 4) << r.status();
+  EXPECT_EQ(stage.executions(), 2UL);
+  EXPECT_EQ(stage.coalesced(), 0UL);
+}
+
+TEST(Coalesce, ConcurrentCallersShareExecution)
+{
+  static constexpr std::size_t kCallers = 4;
+
+  std::atomic<bool> release{false};
+  const auto stage = coalesce(
+    [&release](const int a) -> result<int> {
+      while (!release)
+      {
+        std::this_thread::yield();
+      }
+      return "shared failure"_msg;
+    },
+    [](const int a) { return a; });
+
+  std::vector<result<int>> results(kCallers);
+  std::vector<std::thread> callers;
+  for (std::size_t i = 0; i < kCallers; ++i)
+  {
+    callers.emplace_back([&stage, &results, i] { results[i] = pass(7) | stage; });
+  }
+
+  while (stage.coalesced() < kCallers - 1)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+  }
+  release = true;
+
+  for (auto& t : callers)
+  {
+    t.join();
+  }
+
+  EXPECT_EQ(stage.executions(), 1UL);
+  for (const auto& r : results)
+  {
+    ASSERT_FALSE(r.valid());
+    EXPECT_EQ(r.status(), "shared failure"_msg);
+  }
+}
+
+TEST(Coalesce, ThreadPoolAll)
+{
+  exec::thread_pool tp{4};
+
+  const auto stage = coalesce([](const int a) -> result<int> { return a + a; }, [](const int a) { return a; });
+
+  // clang-format off
+  auto r = pass(1)
+         | all(tp, stage, stage);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, std::make_tuple(2, 2)) << r.status();
+}
+
+TEST(Coalesce, GenericInvocable)
+{
+  // Argument types of generic invocables are named, which fixes the key and result types of the stage
+  const auto stage = coalesce<int>([](const auto a) -> result<int> { return a + a; }, [](const auto a) { return a; });
+
+  // clang-format off
+  auto r = pass(1)
+         | stage
+         | stage;
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 4) << r.status();
+  EXPECT_EQ(stage.executions(), 2UL);
+}
+
+TEST(Memoize, HitsAndMisses)
+{
+  std::size_t invocations = 0;
+  const auto stage = memoize(
+    [&invocations](const int a) -> result<int> {
+      ++invocations;
+      return a + a;
+    },
+    8);
+
+  for (int i = 0; i < 4; ++i)
+  {
+    auto r = pass(i % 2) | stage;
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, 2 * (i % 2)) << r.status();
+  }
+
+  EXPECT_EQ(invocations, 2UL);
+  EXPECT_EQ(stage.hits(), 2UL);
+  EXPECT_EQ(stage.misses(), 2UL);
+}
+
+TEST(Memoize, LRUEviction)
+{
+  const auto stage = memoize([](const int a, const int b) -> result<int> { return a + b; }, 1);
+
+  [[maybe_unused]] auto r1 = pass(1, 2) | stage;
+  [[maybe_unused]] auto r2 = pass(2, 1) | stage;
+  [[maybe_unused]] auto r3 = pass(1, 2) | stage;
+
+  EXPECT_EQ(stage.hits(), 0UL);
+  EXPECT_EQ(stage.evictions(), 2UL);
+}
+
+TEST(Memoize, ClockEviction)
+{
+  const auto stage = memoize([](const int a) -> result<int> { return a; }, 1, memoize_policy{memoize_eviction::clock});
+
+  [[maybe_unused]] auto r1 = pass(1) | stage;
+  [[maybe_unused]] auto r2 = pass(1) | stage;
+  [[maybe_unused]] auto r3 = pass(2) | stage;
+  [[maybe_unused]] auto r4 = pass(2) | stage;
+
+  EXPECT_EQ(stage.hits(), 2UL);
+  EXPECT_EQ(stage.evictions(), 1UL);
+}
+
+TEST(Memoize, TimeToLive)
+{
+  const auto stage = memoize(
+    [](const int a) -> result<int> { return a; },
+    8,
+    memoize_policy{memoize_eviction::lru, std::chrono::milliseconds{1}});
+
+  [[maybe_unused]] auto r1 = pass(1) | stage;
+  std::this_thread::sleep_for(std::chrono::milliseconds{5});
+  [[maybe_unused]] auto r2 = pass(1) | stage;
+
+  EXPECT_EQ(stage.hits(), 0UL);
+  EXPECT_EQ(stage.misses(), 2UL);
+}
+
+TEST(Memoize, NegativeCaching)
+{
+  const auto no_negative = memoize([](const int a) -> result<int> { return "no"_msg; }, 8);
+  const auto negative = memoize(
+    [](const int a) -> result<int> { return "no"_msg; },
+    8,
+    memoize_policy{memoize_eviction::lru, std::chrono::nanoseconds::zero(), true});
+
+  for (int i = 0; i < 2; ++i)
+  {
+    auto r1 = pass(1) | no_negative;
+    auto r2 = pass(1) | negative;
+    ASSERT_FALSE(r1.valid());
+    ASSERT_FALSE(r2.valid());
+    EXPECT_EQ(r2.status(), "no"_msg);
+  }
+
+  EXPECT_EQ(no_negative.hits(), 0UL);
+  EXPECT_EQ(negative.hits(), 1UL);
+}
+
+TEST(Memoize, GenericInvocable)
+{
+  // Argument types of generic invocables are named, which fixes the key and result types of the stage
+  const auto stage = memoize<int, int>([](const auto a, const auto b) -> result<int> { return a + b; }, 8);
+
+  for (int i = 0; i < 2; ++i)
+  {
+    auto r = pass(1, 2) | stage;
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, 3);
+  }
+
+  EXPECT_EQ(stage.hits(), 1UL);
+  EXPECT_EQ(stage.misses(), 1UL);
+}
+
+TEST(Timed, Sequence)
+{
+  const auto stage = timed("checked"_msg, [](const int a) -> result<int> {
+    if (a < 0)
+    {
+      return "negative"_msg;
+    }
+    return a + a;
+  });
+
+  for (int a : {1, 2, -1, 3})
+  {
+    [[maybe_unused]] auto r = pass(a) | stage | stage;
+  }
+
+  const stage_latency l = stage.latency();
+  EXPECT_EQ(l.name, "checked");
+  EXPECT_EQ(l.valid.count(), 6UL);
+  EXPECT_EQ(l.invalid.count(), 1UL);
+  EXPECT_LE(l.valid.percentile(0.5), l.valid.percentile(0.999));
+  EXPECT_LE(l.valid.percentile(0.999), l.valid.max());
+
+  std::ostringstream oss;
+  oss << l;
+  EXPECT_EQ(oss.str().rfind("checked valid: count=6", 0), 0UL);
+}
+
+TEST(Timed, ThreadPoolBranches)
+{
+  exec::thread_pool tp{4};
+
+  const auto with_handle = timed("with handle"_msg, [](const auto& handle, const int a) -> result<int> {
+    std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    return a;
+  });
+  const auto without_handle = timed("without handle"_msg, [](const int a) -> result<int> { return a + 1; });
+
+  for (int i = 0; i < 8; ++i)
+  {
+    // clang-format off
+    auto r = pass(i)
+           | all(tp, with_handle, without_handle);
+    // clang-format on
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, std::make_tuple(i, i + 1));
+  }
+
+  // Recorded by several workers, and merged on read
+  EXPECT_EQ(with_handle.latency().valid.count(), 8UL);
+  EXPECT_GE(with_handle.latency().valid.percentile(0.5), std::chrono::milliseconds{1});
+  EXPECT_EQ(without_handle.latency().valid.count(), 8UL);
+  EXPECT_EQ(without_handle.latency().invalid.count(), 0UL);
+}
@@ -0,0 +1,323 @@
+// C++ Standard Library
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// POSIX
+#include <fcntl.h>
+#include <unistd.h>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/core.hpp>
+#include <zen/executor.hpp>
+#include <zen/stream.hpp>
+
+using namespace zen;
+
+namespace
+{
+
+/**
+ * @brief Temporary file, removed when destroyed
+ */
+class temp_file
+{
+public:
+  explicit temp_file(std::string_view contents = {})
+  {
+    const int fd = ::mkstemp(path_);
+    EXPECT_GE(fd, 0);
+    EXPECT_EQ(::write(fd, contents.data(), contents.size()), static_cast<::ssize_t>(contents.size()));
+    ::close(fd);
+  }
+
+  ~temp_file() { ::unlink(path_); }
+
+  const char* path() const { return path_; }
+
+  std::string contents() const
+  {
+    const int fd = ::open(path_, O_RDONLY);
+    std::string s;
+    char buffer[256];
+    for (::ssize_t n = 0; (n = ::read(fd, buffer, sizeof(buffer))) > 0;)
+    {
+      s.append(buffer, static_cast<std::size_t>(n));
+    }
+    ::close(fd);
+    return s;
+  }
+
+private:
+  char path_[32] = "/tmp/zen_stream_XXXXXX";
+};
+
+auto counter(int n)
+{
+  return from_generator([i = 0, n]() mutable -> std::optional<int> {
+    if (i == n)
+    {
+      return std::nullopt;
+    }
+    return i++;
+  });
+}
+
+}  // namespace
+
+TEST(Stream, PumpGenerator)
+{
+  std::vector<int> values;
+  std::vector<std::string> failures;
+
+  // clang-format off
+  const auto counts = pump(
+    counter(10),
+    [](int i)
+    {
+      return pass(i)
+           | [](int i) -> result<int>
+             {
+               if (i % 3 == 0)
+               {
+                 return "multiple of 3"_msg;
+               }
+               return 2 * i;
+             };
+    },
+    collect(values),
+    [&failures](const result_status& s) { failures.emplace_back(s.message()); });
+  // clang-format on
+
+  EXPECT_EQ(counts.items, 10UL);
+  EXPECT_EQ(counts.valid, 6UL);
+  EXPECT_EQ(counts.invalid, 4UL);
+  EXPECT_EQ(values, (std::vector<int>{2, 4, 8, 10, 14, 16}));
+  ASSERT_EQ(failures.size(), 4UL);
+  EXPECT_EQ(failures.front(), "multiple of 3");
+}
+
+TEST(Stream, RangeSource)
+{
+  const std::vector<std::string> words{"a", "bb", "ccc"};
+
+  std::vector<std::string> copied;
+  pump(from_range(words), [](std::string&& s) { return s; }, collect(copied));
+  EXPECT_EQ(copied, words);
+
+  std::vector<std::unique_ptr<int>> owned;
+  owned.emplace_back(std::make_unique<int>(1));
+  owned.emplace_back(std::make_unique<int>(2));
+
+  std::vector<std::unique_ptr<int>> moved;
+  const auto counts = pump(
+    from_range(std::move(owned)), [](std::unique_ptr<int>&& p) { return std::move(p); }, collect(moved));
+  EXPECT_EQ(counts.valid, 2UL);
+  ASSERT_EQ(moved.size(), 2UL);
+  EXPECT_EQ(*moved.back(), 2);
+}
+
+TEST(Stream, MappedRecords)
+{
+  const temp_file file{"a\nbb\n\nccc"};
+
+  auto mapped = mapped_file::open(file.path());
+  ASSERT_TRUE(mapped.valid()) << mapped.status();
+  EXPECT_EQ(mapped->size(), 9UL);
+
+  std::vector<std::string_view> rs;
+  pump(records(*mapped), [](std::string_view r) { return r; }, collect(rs));
+  EXPECT_EQ(rs, (std::vector<std::string_view>{"a", "bb", "", "ccc"}));
+}
+
+TEST(Stream, MappedRecordsEmptyAndMissing)
+{
+  const temp_file empty;
+
+  auto mapped = mapped_file::open(empty.path());
+  ASSERT_TRUE(mapped.valid()) << mapped.status();
+  EXPECT_FALSE(records(*mapped).next().has_value());
+
+  EXPECT_FALSE(mapped_file::open("/tmp/zen_stream_does_not_exist").valid());
+}
+
+TEST(Stream, LineSource)
+{
+  int fds[2];
+  ASSERT_EQ(::pipe(fds), 0);
+
+  const std::string long_line(100, 'x');
+  const std::string contents = "one\n" + long_line + "\n\nlast";
+  ASSERT_EQ(::write(fds[1], contents.data(), contents.size()), static_cast<::ssize_t>(contents.size()));
+  ::close(fds[1]);
+
+  // Buffer smaller than a line, so that it has to grow
+  auto source = lines(fds[0], 8);
+
+  std::vector<std::string> ls;
+  pump(source, [](std::string&& l) { return std::move(l); }, collect(ls));
+  EXPECT_FALSE(source.failed());
+  EXPECT_EQ(ls, (std::vector<std::string>{"one", long_line, "", "last"}));
+  ::close(fds[0]);
+}
+
+TEST(Stream, ReadAhead)
+{
+  exec::thread_pool tp{2};
+
+  std::vector<int> values;
+  const auto counts = pump(read_ahead(tp, counter(1000), 16), [](int i) { return i; }, collect(values));
+
+  EXPECT_EQ(counts.items, 1000UL);
+  ASSERT_EQ(values.size(), 1000UL);
+  for (int i = 0; i < 1000; ++i)
+  {
+    ASSERT_EQ(values[i], i);
+  }
+}
+
+TEST(Stream, ReadAheadInline)
+{
+  exec::inline_executor ie;
+
+  std::vector<int> values;
+  pump(read_ahead(ie, counter(100), 4), [](int i) { return i; }, collect(values));
+  EXPECT_EQ(values.size(), 100UL);
+}
+
+TEST(Stream, ReadAheadStoppedEarly)
+{
+  exec::thread_pool tp{2};
+
+  int pulled = 0;
+  {
+    auto source = read_ahead(
+      tp,
+      from_generator([&pulled]() -> std::optional<int> { return pulled++; }),
+      8);
+    ASSERT_EQ(source.next(), 0);
+    ASSERT_EQ(source.next(), 1);
+  }
+
+  // Reading ahead is bounded, and the source is no longer touched once its reader is destroyed
+  const int after = pulled;
+  EXPECT_LE(after, 10);
+  std::this_thread::sleep_for(std::chrono::milliseconds{10});
+  EXPECT_EQ(pulled, after);
+}
+
+TEST(Stream, ReadAheadSourceThrows)
+{
+  exec::thread_pool tp{2};
+
+  const auto throwing = [] {
+    return from_generator([i = 0]() mutable -> std::optional<int> {
+      if (i == 3)
+      {
+        throw std::runtime_error{"read failed"};
+      }
+      return i++;
+    });
+  };
+
+  // Items read before the exception are handed over, then the exception is rethrown, once
+  {
+    auto source = read_ahead(tp, throwing(), 8);
+    EXPECT_EQ(source.next(), 0);
+    EXPECT_EQ(source.next(), 1);
+    EXPECT_EQ(source.next(), 2);
+    EXPECT_THROW([[maybe_unused]] auto item = source.next(), std::runtime_error);
+    EXPECT_FALSE(source.next().has_value());
+  }
+
+  // Destroying the reader does not wait for read work which stopped on the exception
+  {
+    auto source = read_ahead(tp, throwing(), 8);
+    EXPECT_EQ(source.next(), 0);
+  }
+
+  exec::inline_executor ie;
+  std::vector<int> values;
+  EXPECT_THROW(pump(read_ahead(ie, throwing(), 2), [](int i) { return i; }, collect(values)), std::runtime_error);
+  EXPECT_EQ(values, (std::vector<int>{0, 1, 2}));
+}
+
+TEST(Stream, BufferedWriter)
+{
+  const temp_file file;
+  const int fd = ::open(file.path(), O_WRONLY | O_TRUNC);
+  ASSERT_GE(fd, 0);
+  {
+    buffered_writer writer{fd, 16};
+    for (int i = 0; i < 8; ++i)
+    {
+      ASSERT_TRUE(writer.write_line("abc"));
+    }
+    ASSERT_TRUE(writer.write(std::string(40, 'z')));
+    ASSERT_TRUE(writer.flush());
+
+    // 32 bytes of lines, in writes of 16, then 40 bytes written directly
+    EXPECT_EQ(writer.system_calls(), 3UL);
+  }
+  ::close(fd);
+
+  std::string expected;
+  for (int i = 0; i < 8; ++i)
+  {
+    expected += "abc\n";
+  }
+  expected += std::string(40, 'z');
+  EXPECT_EQ(file.contents(), expected);
+}
+
+TEST(Stream, RecordsToFile)
+{
+  const temp_file input{"1\n2\nx\n4\n"};
+  const temp_file output;
+
+  auto mapped = mapped_file::open(input.path());
+  ASSERT_TRUE(mapped.valid()) << mapped.status();
+
+  exec::thread_pool tp{2};
+
+  const int fd = ::open(output.path(), O_WRONLY | O_TRUNC);
+  ASSERT_GE(fd, 0);
+
+  pump_counts counts;
+  {
+    buffered_writer writer{fd};
+
+    // clang-format off
+    counts = pump(
+      read_ahead(tp, records(*mapped), 2),
+      [](std::string_view r)
+      {
+        return pass(r)
+             | [](std::string_view r) -> result<int>
+               {
+                 if (r.empty() || r[0] < '0' || r[0] > '9')
+                 {
+                   return "not a number"_msg;
+                 }
+                 return r[0] - '0';
+               }
+             | [](int v) -> result<std::string> { return std::to_string(v * v); };
+      },
+      write_lines(writer));
+    // clang-format on
+  }
+  ::close(fd);
+
+  EXPECT_EQ(counts.items, 4UL);
+  EXPECT_EQ(counts.invalid, 1UL);
+  EXPECT_EQ(output.contents(), "1\n4\n16\n");
+}
@@ -0,0 +1,167 @@
+// C++ Standard Library
+#include <sstream>
+#include <string>
+#include <thread>
+
+// GTest
+#include <gtest/gtest.h>
+
+// Zen
+#include <zen/executor.hpp>
+#include <zen/parallel.hpp>
+#include <zen/utility/trace.hpp>
+
+using namespace zen;
+
+namespace
+{
+
+std::size_t occurrences(const std::string& str, const std::string& sub)
+{
+  std::size_t n = 0;
+  for (auto pos = str.find(sub); pos != std::string::npos; pos = str.find(sub, pos + sub.size()))
+  {
+    ++n;
+  }
+  return n;
+}
+
+struct parse_stage
+{
+  result<int> operator()(int a) const { return a + 1; }
+};
+
+}  // namespace
+
+TEST(Trace, StagesAndDispatch)
+{
+  trace::enable();
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+
+  {
+    // Workers finish recording spans of their tasks after work completes, and before they are joined
+    exec::thread_pool tp{2};
+
+    // clang-format off
+    auto r = pass(1)
+           | parse_stage{}
+           | all(tp,
+                 [](int a) -> result<int> { return a; },
+                 [](int a) -> result<int> { return a; })
+           | any(tp,
+                 [](int a, int b) -> result<int> { return "failed"_msg; },
+                 [](int a, int b) -> result<int> { return a + b; });
+    // clang-format on
+    ASSERT_TRUE(r.valid()) << r.status();
+    EXPECT_EQ(*r, 4);
+  }
+
+  std::ostringstream oss;
+  const std::size_t n = trace::write_chrome_trace(oss);
+  const std::string json = oss.str();
+
+  EXPECT_EQ(occurrences(json, "\"ph\":"), n);
+  EXPECT_EQ(json.rfind("{\"traceEvents\":[", 0), 0UL);
+  EXPECT_EQ(occurrences(json, "\"cat\":\"stage\""), 3UL);
+  EXPECT_EQ(occurrences(json, "parse_stage"), 1UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"all\",\"cat\":\"dispatch\""), 1UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"any\",\"cat\":\"dispatch\""), 1UL);
+  EXPECT_EQ(occurrences(json, "\"cat\":\"branch\""), 4UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"enqueue\""), 2UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"queue_wait\""), 4UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"task\""), 4UL);
+  EXPECT_EQ(occurrences(json, "\"name\":\"cancel\""), 1UL);  // by failed branch of any()
+
+  // Events were drained
+  std::ostringstream empty;
+  EXPECT_EQ(trace::write_chrome_trace(empty), 0UL);
+}
+
+TEST(Trace, Cancel)
+{
+  trace::enable();
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+
+  {
+    exec::thread_pool tp{2};
+
+    // clang-format off
+    auto r = pass(1)
+           | all(tp,
+                 [](int a) -> result<int> { return "failed"_msg; },
+                 [](int a) -> result<int> { return a; });
+    // clang-format on
+    ASSERT_FALSE(r.valid());
+  }
+
+  std::ostringstream oss;
+  trace::write_chrome_trace(oss);
+  EXPECT_GE(occurrences(oss.str(), "\"name\":\"cancel\",\"cat\":\"dispatch\",\"ph\":\"i\""), 1UL);
+}
+
+TEST(Trace, Disabled)
+{
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+
+  trace::enable(false);
+  {
+    auto r = pass(1) | parse_stage{};
+    ASSERT_TRUE(r.valid());
+  }
+  trace::enable();
+
+  std::ostringstream oss;
+  EXPECT_EQ(trace::write_chrome_trace(oss), 0UL);
+}
+
+TEST(Trace, SpanNameLookedUpOnlyWhenEnabled)
+{
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+
+  std::size_t lookups = 0;
+  const auto name = [&lookups] {
+    ++lookups;
+    return "named";
+  };
+
+  trace::enable(false);
+  {
+    const trace::span s{name, "test"};
+  }
+  trace::enable();
+  EXPECT_EQ(lookups, 0UL);
+
+  {
+    const trace::span s{name, "test"};
+  }
+  EXPECT_EQ(lookups, 1UL);
+
+  std::ostringstream oss;
+  EXPECT_EQ(trace::write_chrome_trace(oss), 1UL);
+  EXPECT_EQ(occurrences(oss.str(), "\"name\":\"named\",\"cat\":\"test\""), 1UL);
+}
+
+TEST(Trace, RingDropsWhenFull)
+{
+  std::ostringstream discard;
+  trace::write_chrome_trace(discard);
+
+  // Record from a thread of its own, so that its ring starts empty
+  const std::size_t dropped = trace::dropped();
+  std::thread t{[] {
+    for (std::size_t i = 0; i < trace::ring::kCapacity + 10; ++i)
+    {
+      trace::instant("tick", "test");
+    }
+  }};
+  t.join();
+
+  EXPECT_EQ(trace::dropped(), dropped + 10);
+
+  std::ostringstream oss;
+  EXPECT_EQ(trace::write_chrome_trace(oss), trace::ring::kCapacity);
+}
@@ -1,4 +1,8 @@
 // C++ Standard Library
+#include <array>
+#include <chrono>
+#include <string_view>
+#include <thread>
 #include <vector>
 
 // GTest
@@ -205,4 +209,251 @@ TEST(Parallel, ThreadPoolAllFailure)
   // clang-format on
 
   ASSERT_FALSE(r.valid()) << r.status();
-}
\ No newline at end of file
+}
+
+TEST(Parallel, ThreadPoolAllSharesValues)
+{
+  exec::thread_pool tp{4};
+  std::vector<int> values{1, 2, 3};
+  const int* const data = values.data();
+
+  const auto view = [](const std::vector<int>& v) -> result<const int*> { return v.data(); };
+
+  // clang-format off
+  auto r = pass(std::move(values))
+         | all(tp, view, view, view);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(std::get<0>(*r), data);
+  EXPECT_EQ(std::get<1>(*r), data);
+  EXPECT_EQ(std::get<2>(*r), data);
+}
+
+TEST(Parallel, ThreadPoolAllMoveInto)
+{
+  exec::thread_pool tp{4};
+  std::vector<int> values{1, 2, 3};
+  const int* const data = values.data();
+
+  const auto size = [](const std::vector<int>& v) -> result<std::size_t> { return v.size(); };
+
+  // clang-format off
+  auto r = pass(std::move(values))
+         | all(
+             tp,
+             move_into<1>,
+             size,
+             [](std::vector<int>&& v) -> result<std::vector<int>> { return std::move(v); },
+             size);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+
+  // Owner runs after the others, which see the values intact
+  EXPECT_EQ(std::get<0>(*r), 3UL);
+  EXPECT_EQ(std::get<1>(*r).data(), data);
+  EXPECT_EQ(std::get<2>(*r), 3UL);
+}
+
+TEST(Parallel, ThreadPoolAllMoveIntoSkippedOnFailure)
+{
+  exec::thread_pool tp{4};
+
+  bool owner_invoked = false;
+  const auto owner = [&owner_invoked](std::vector<int>&& v) -> result<std::vector<int>> {
+    owner_invoked = true;
+    return std::move(v);
+  };
+
+  // clang-format off
+  auto r = pass(std::vector<int>{1, 2, 3})
+         | all(
+             tp,
+             move_into<0>,
+             owner,
+             [](const std::vector<int>& v) -> result<std::size_t> { return v.size(); },
+             [](const std::vector<int>& v) -> result<std::size_t> { return "too short"_msg; });
+  // clang-format on
+
+  // Owner comes first, but reports the failure which stopped it from running
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), "too short"_msg);
+  EXPECT_FALSE(owner_invoked);
+}
+
+TEST(Parallel, ThreadPoolAllMoveIntoSkippedOnCancel)
+{
+  exec::thread_pool tp{4};
+
+  bool owner_invoked = false;
+  const auto owner = [&owner_invoked](std::vector<int>&& v) -> result<std::vector<int>> {
+    owner_invoked = true;
+    return std::move(v);
+  };
+
+  // clang-format off
+  auto r = pass(std::vector<int>{1, 2, 3})
+         | all(
+             tp,
+             move_into<1>,
+             [](auto& handle, const std::vector<int>& v) -> result<std::size_t>
+             {
+               handle.cancel();
+               return v.size();
+             },
+             owner);
+  // clang-format on
+
+  ASSERT_FALSE(r.valid());
+  EXPECT_EQ(r.status(), Cancelled);
+  EXPECT_FALSE(owner_invoked);
+}
+
+TEST(Core, FailureCounts)
+{
+  const auto propagated = [](std::string_view message) {
+    return message_registry::instance().counts(message).propagated;
+  };
+
+  // clang-format off
+  auto r = pass(1)
+         | [](int a) -> result<int> { return "counted stage"_msg; }
+         | test_valid_fn1
+         | test_valid_fn1;
+  auto r_all = pass(1)
+             | all(test_valid_fn1, [](int a) -> result<int> { return "counted all"_msg; });
+  auto r_any = pass(1)
+             | any([](int a) -> result<int> { return "counted any"_msg; });
+  // clang-format on
+  ASSERT_FALSE(r.valid());
+  ASSERT_FALSE(r_all.valid());
+  ASSERT_FALSE(r_any.valid());
+
+  EXPECT_EQ(message_registry::instance().counts("counted stage"_msg.sv()).created, 1UL);
+  EXPECT_EQ(propagated("counted stage"_msg.sv()), 2UL);
+  EXPECT_EQ(propagated("counted all"_msg.sv()), 1UL);
+  EXPECT_EQ(propagated("counted any"_msg.sv()), 1UL);
+}
+
+TEST(Parallel, FailureCounts)
+{
+  exec::thread_pool tp{2};
+
+  // clang-format off
+  auto r_all = pass(1)
+             | all(tp, test_valid_fn1, [](int a) -> result<int> { return "counted parallel all"_msg; });
+  auto r_any = pass(1)
+             | any(tp, [](int a) -> result<int> { return "counted parallel any"_msg; });
+  // clang-format on
+  ASSERT_FALSE(r_all.valid());
+  ASSERT_FALSE(r_any.valid());
+
+  EXPECT_EQ(message_registry::instance().counts("counted parallel all"_msg.sv()).propagated, 1UL);
+  EXPECT_EQ(message_registry::instance().counts("counted parallel any"_msg.sv()).propagated, 1UL);
+}
+
+TEST(Parallel, HedgePrimarySuccess)
+{
+  exec::thread_pool tp{4};
+  hedge_policy policy{std::chrono::seconds{10}};
+
+  // clang-format off
+  auto r = pass(1)
+         | hedge(tp, policy, test_valid_fn1, test_invalid_fn1);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 2) << r.status();
+  EXPECT_EQ(policy.requests(), 1UL);
+  EXPECT_EQ(policy.hedges(), 0UL);
+}
+
+TEST(Parallel, HedgeBackupSuccess)
+{
+  exec::thread_pool tp{4};
+  hedge_policy policy{std::chrono::milliseconds{1}};
+
+  // clang-format off
+  auto r = pass(1)
+         | hedge(
+             tp,
+             policy,
+             [](const auto& h, const int) -> result<int>
+             {
+               while (!h.is_cancelled())
+               {
+                 std::this_thread::sleep_for(std::chrono::milliseconds{1});
+               }
+               return "cancelled"_msg;
+             },
+             test_valid_fn1);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, 2) << r.status();
+  EXPECT_EQ(policy.hedges(), 1UL);
+  EXPECT_EQ(policy.wins(), 1UL);
+}
+
+TEST(Parallel, HedgeFailure)
+{
+  exec::thread_pool tp{4};
+
+  // clang-format off
+  auto r = pass(1)
+         | hedge(tp, std::chrono::seconds{10}, test_invalid_fn1, test_invalid_fn1, test_invalid_fn1);
+  // clang-format on
+
+  ASSERT_FALSE(r.valid()) << r.status();
+}
+
+TEST(Parallel, QuorumSuccess)
+{
+  exec::thread_pool tp{4};
+
+  // clang-format off
+  auto r = pass(1)
+         | quorum<2>(tp, test_valid_fn1, test_invalid_fn1, test_valid_fn1);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, (std::array<int, 2>{2, 2})) << r.status();
+}
+
+TEST(Parallel, QuorumFailure)
+{
+  exec::thread_pool tp{4};
+
+  // clang-format off
+  auto r = pass(1)
+         | quorum<2>(tp, test_invalid_fn1, test_invalid_fn1, test_valid_fn1);
+  // clang-format on
+
+  ASSERT_FALSE(r.valid()) << r.status();
+}
+
+TEST(Parallel, QuorumRuntimeSuccess)
+{
+  exec::thread_pool tp{4};
+
+  // clang-format off
+  auto r = pass(1)
+         | quorum(tp, 1, test_invalid_fn1, test_valid_fn1, test_invalid_fn1);
+  // clang-format on
+
+  ASSERT_TRUE(r.valid()) << r.status();
+  EXPECT_EQ(*r, (std::vector<int>{2})) << r.status();
+}
+
+TEST(Parallel, QuorumRuntimeUnreachable)
+{
+  exec::thread_pool tp{4};
+
+  // clang-format off
+  auto r = pass(1)
+         | quorum(tp, 3, test_valid_fn1, test_valid_fn1);
+  // clang-format on
+
+  ASSERT_FALSE(r.valid()) << r.status();
+}